@@ -36,6 +36,7 @@
 #include "fdb5/database/Key.h"
 #include "fdb5/database/WipeCoordinator.h"
 #include "fdb5/database/WipeState.h"
+#include "fdb5/io/CoalescingReadHandle.h"
 #include "fdb5/io/FieldHandle.h"
 #include "fdb5/io/HandleGatherer.h"
 #include "fdb5/message/MessageDecoder.h"
@@ -56,13 +57,17 @@
 #include "eckit/message/Message.h"
 #include "eckit/message/Reader.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -70,6 +75,86 @@ namespace fdb5 {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Calls @p visit with each field of @p it that is to be returned by a retrieve, in order
+void forEachRetrieved(ListIterator& it, const std::function<void(const ListElement&)>& visit) {
+    ListElement el;
+
+    static bool dedup = eckit::Resource<bool>("fdbDeduplicate;$FDB_DEDUPLICATE_FIELDS", false);
+    if (dedup) {
+        if (it.next(el)) {
+            // build the request representing the tensor-product of all retrieved fields
+            metkit::mars::MarsRequest cubeRequest = el.combinedKey().request();
+            std::vector<ListElement> elements{el};
+
+            while (it.next(el)) {
+                cubeRequest.merge(el.combinedKey().request());
+                elements.push_back(el);
+            }
+
+            // checking all retrieved fields against the hypercube, to remove duplicates
+            ListElementDeduplicator deduplicator;
+            metkit::hypercube::HyperCubePayloaded<ListElement> cube(cubeRequest, deduplicator);
+            for (const auto& elem : elements) {
+                cube.add(elem.combinedKey().request(), el);
+            }
+
+            if (cube.countVacant() > 0) {
+                std::ostringstream ss;
+                ss << "No matching data for requests:" << std::endl;
+                for (auto req : cube.vacantRequests()) {
+                    ss << "    " << req << std::endl;
+                }
+                eckit::Log::warning() << ss.str() << std::endl;
+            }
+
+            for (std::size_t i = 0; i < cube.size(); i++) {
+                ListElement element;
+                if (cube.find(i, element)) {
+                    visit(element);
+                }
+            }
+        }
+    }
+    else {
+        while (it.next(el)) {
+            visit(el);
+        }
+    }
+}
+
+/// Puts @p elements in the order a sorted HandleGatherer returns them: the fields of each local file together, in the
+/// order the files are first seen, and by offset within a file. Other fields keep their place.
+void sortAsStored(std::vector<ListElement>& elements) {
+
+    std::map<std::string, size_t> files;
+    std::vector<std::tuple<size_t, long long, size_t>> order;
+    order.reserve(elements.size());
+
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const FieldLocation& location = elements[i].location();
+        size_t group = i;
+        if (location.uri().scheme() == "file" && location.remapKey().empty()) {
+            group = files.emplace(location.uri().path(), i).first->second;
+        }
+        order.emplace_back(group, static_cast<long long>(location.offset()), i);
+    }
+
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<ListElement> sorted;
+    sorted.reserve(elements.size());
+    for (const auto& entry : order) {
+        sorted.push_back(std::move(elements[std::get<2>(entry)]));
+    }
+    elements.swap(sorted);
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 FDB::FDB(const Config& config) :
     internal_(FDBFactory::instance().build(config)), dirty_(false), reportStats_(config.getBool("statistics", false)) {
     LibFdb5::instance().constructorCallback()(*internal_);
@@ -152,9 +237,7 @@ void FDB::archive(const metkit::mars::MarsRequest& request, eckit::DataHandle& h
     }
 }
 
-void FDB::archive(const Key& key, const void* data, size_t length) {
-    eckit::Timer timer;
-    timer.start();
+Key FDB::internalKey(const Key& key) const {
 
     // This is the API entrypoint. Keys supplied by the user may not have type registry info attached (so
     // serialisation won't work properly...)
@@ -172,7 +255,14 @@ void FDB::archive(const Key& key, const void* data, size_t length) {
         keyInternal.unset("stepunits");
     }
 
-    internal_->archive(keyInternal, data, length);
+    return keyInternal;
+}
+
+void FDB::archive(const Key& key, const void* data, size_t length) {
+    eckit::Timer timer;
+    timer.start();
+
+    internal_->archive(internalKey(key), data, length);
 
     timer.stop();
 
@@ -181,6 +271,32 @@ void FDB::archive(const Key& key, const void* data, size_t length) {
     stats_.addArchive(length, timer);
 }
 
+void FDB::archive(const std::vector<ArchiveItem>& items) {
+
+    if (items.empty()) {
+        return;
+    }
+
+    eckit::Timer timer;
+    timer.start();
+
+    std::vector<ArchiveItem> itemsInternal;
+    itemsInternal.reserve(items.size());
+    size_t length = 0;
+    for (const auto& item : items) {
+        itemsInternal.push_back({internalKey(item.key), item.data, item.length});
+        length += item.length;
+    }
+
+    internal_->archive(itemsInternal);
+
+    timer.stop();
+
+    std::lock_guard lock(mutex_);
+    dirty_ = true;
+    stats_.addArchive(length, timer, items.size());
+}
+
 void FDB::reindex(const Key& key, const FieldLocation& location) {
     internal_->reindex(key, location);
     std::lock_guard lock(mutex_);
@@ -223,58 +339,54 @@ eckit::DataHandle* FDB::read(ListIterator& it, bool sorted) {
     eckit::Timer timer;
     timer.start();
 
+    // Optionally, read the fields in batches rather than one handle at a time
+    static bool coalesce = eckit::Resource<bool>("fdbCoalescedRead;$FDB_COALESCED_READ", false);
+    if (coalesce) {
+        auto coalesced = std::make_unique<CoalescingReadHandle>(sorted);
+        forEachRetrieved(it, [&](const ListElement& el) { coalesced->add(el.location()); });
+        return coalesced.release();
+    }
+
     HandleGatherer result(sorted);
-    ListElement el;
+    forEachRetrieved(it, [&](const ListElement& el) { result.add(el.location().dataHandle()); });
+    return result.dataHandle();
+}
 
-    static bool dedup = eckit::Resource<bool>("fdbDeduplicate;$FDB_DEDUPLICATE_FIELDS", false);
-    if (dedup) {
-        if (it.next(el)) {
-            // build the request representing the tensor-product of all retrieved fields
-            metkit::mars::MarsRequest cubeRequest = el.combinedKey().request();
-            std::vector<ListElement> elements{el};
+eckit::DataHandle* FDB::retrieve(const metkit::mars::MarsRequest& request) {
+    static bool seekable = eckit::Resource<bool>("fdbSeekableDataHandle;$FDB_SEEKABLE_DATA_HANDLE", false);
 
-            while (it.next(el)) {
-                cubeRequest.merge(el.combinedKey().request());
-                elements.push_back(el);
-            }
+    ListIterator it = inspect(request);
+    return seekable ? new FieldHandle(it) : read(it, sorted(request));
+}
 
-            // checking all retrieved fields against the hypercube, to remove duplicates
-            ListElementDeduplicator deduplicator;
-            metkit::hypercube::HyperCubePayloaded<ListElement> cube(cubeRequest, deduplicator);
-            for (const auto& elem : elements) {
-                cube.add(elem.combinedKey().request(), el);
-            }
+size_t FDB::retrieveInto(const metkit::mars::MarsRequest& request, const RetrieveAllocator& allocate) {
 
-            if (cube.countVacant() > 0) {
-                std::ostringstream ss;
-                ss << "No matching data for requests:" << std::endl;
-                for (auto req : cube.vacantRequests()) {
-                    ss << "    " << req << std::endl;
-                }
-                eckit::Log::warning() << ss.str() << std::endl;
-            }
+    ListIterator it = inspect(request);
 
-            for (std::size_t i = 0; i < cube.size(); i++) {
-                ListElement element;
-                if (cube.find(i, element)) {
-                    result.add(element.location().dataHandle());
-                }
-            }
-        }
+    std::vector<ListElement> elements;
+    forEachRetrieved(it, [&](const ListElement& el) { elements.push_back(el); });
+
+    // The fields are returned in the same order as by retrieve()
+    if (sorted(request)) {
+        sortAsStored(elements);
     }
-    else {
-        while (it.next(el)) {
-            result.add(el.location().dataHandle());
-        }
+
+    // All the memory is requested before reading anything, so the allocator may reject a field without data being read
+    CoalescingReadHandle reader;
+    std::vector<char*> destinations;
+    destinations.reserve(elements.size());
+    for (const ListElement& el : elements) {
+        const size_t length = el.location().length();
+        char* dest = static_cast<char*>(allocate(el, length));
+        ASSERT(dest || length == 0);
+        destinations.push_back(dest);
+        reader.add(el.location());
     }
-    return result.dataHandle();
-}
 
-eckit::DataHandle* FDB::retrieve(const metkit::mars::MarsRequest& request) {
-    static bool seekable = eckit::Resource<bool>("fdbSeekableDataHandle;$FDB_SEEKABLE_DATA_HANDLE", false);
+    reader.readInto(destinations.data());
+    reader.close();
 
-    ListIterator it = inspect(request);
-    return seekable ? new FieldHandle(it) : read(it, sorted(request));
+    return destinations.size();
 }
 
 ListIterator FDB::inspect(const metkit::mars::MarsRequest& request) {
@@ -30,11 +30,14 @@
 #include "fdb5/api/helpers/StatusIterator.h"
 #include "fdb5/api/helpers/WipeIterator.h"
 #include "fdb5/config/Config.h"
+#include "fdb5/database/ArchiveItem.h"
 
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 namespace eckit {
 namespace message {
@@ -122,6 +125,16 @@ public:  // methods
     /// @param length Size in bytes of the binary blob to archive
     void archive(const Key& key, const void* data, size_t length);
 
+    /// Archive a batch of binary blobs into FDB.
+    ///
+    /// Equivalent to calling archive(key, data, length) on each item in turn, but the fields are matched against the
+    /// schema before any data is written, and the fields sharing a database and index are written and indexed
+    /// together. Any callback set with registerArchiveCallback will be invoked on each item.
+    /// @note No constistency checks are applied. The caller needs to ensure the provided keys match metadata present
+    /// in data.
+    /// @param items Keys and data of the fields to archive. The data must remain valid until the call returns.
+    void archive(const std::vector<ArchiveItem>& items);
+
     /// Generate an new index entry for an existing field location.
     ///
     /// Can be used to reindex existing data into a new catalogue (see fdb-reindex tool).
@@ -159,6 +172,18 @@ public:  // methods
     /// @return DataHandle for reading the requested data from
     eckit::DataHandle* retrieve(const metkit::mars::MarsRequest& request);
 
+    /// Provides the memory a field is retrieved into, given the field and its length in bytes
+    using RetrieveAllocator = std::function<void*(const ListElement& element, size_t length)>;
+
+    /// Retrieve data which is specified by a MARS request directly into memory provided by the caller.
+    /// The allocator is called once per field, in the order the fields would be returned by retrieve() (which honours
+    /// optimise=on in the request), before any data is read. Fields stored in local files are then read straight into
+    /// that memory, without intermediate copies.
+    /// @param request MarsRequest which describes the data which should be retrieved
+    /// @param allocate provides the memory for each field. It may throw to abandon the retrieve.
+    /// @return number of fields retrieved
+    size_t retrieveInto(const metkit::mars::MarsRequest& request, const RetrieveAllocator& allocate);
+
     // TODO(kkratz): Provide doc!
     ListIterator inspect(const metkit::mars::MarsRequest& request);
 
@@ -289,6 +314,9 @@ private:  // methods
 
     bool sorted(const metkit::mars::MarsRequest& request);
 
+    /// Keys supplied by the user may not have type registry info attached, nor the step units folded into the step
+    Key internalKey(const Key& key) const;
+
 private:
 
     friend struct remote::WipeHelper;
@@ -48,6 +48,12 @@ FDBBase::FDBBase(const Config& config, const std::string& name) : name_(name), c
     LOG_DEBUG_LIB(LibFdb5) << "FDBBase: " << config << std::endl;
 }
 
+void FDBBase::archive(const std::vector<ArchiveItem>& items) {
+    for (const auto& item : items) {
+        archive(item.key, item.data, item.length);
+    }
+}
+
 const std::string& FDBBase::name() const {
     return name_;
 }
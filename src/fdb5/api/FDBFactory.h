@@ -31,6 +31,7 @@
 #include "fdb5/api/helpers/StatsIterator.h"
 #include "fdb5/api/helpers/StatusIterator.h"
 #include "fdb5/config/Config.h"
+#include "fdb5/database/ArchiveItem.h"
 #include "fdb5/database/WipeState.h"
 
 namespace eckit::message {
@@ -74,6 +75,9 @@ public:  // methods
 
     virtual void archive(const Key& key, const void* data, size_t length) = 0;
 
+    /// Archives the items one by one, unless overridden
+    virtual void archive(const std::vector<ArchiveItem>& items);
+
     virtual void reindex(const Key& key, const FieldLocation& location) { NOTIMP; }
 
     virtual void flush() = 0;
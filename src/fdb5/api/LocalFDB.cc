@@ -41,18 +41,24 @@
 #include "fdb5/database/FieldLocation.h"
 #include "fdb5/database/Inspector.h"
 #include "fdb5/database/Key.h"
+#include "fdb5/database/PipelinedArchiver.h"
 #include "fdb5/database/Reindexer.h"
 #include "fdb5/database/WipeState.h"
 #include "fdb5/rules/Schema.h"
 
+#include "eckit/config/Resource.h"
 #include "eckit/container/Queue.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/URI.h"
 #include "eckit/log/Log.h"
 
 #include <cstddef>
+#include <exception>
+#include <future>
 #include <memory>
 #include <mutex>
 #include <ostream>
+#include <vector>
 
 
 using namespace fdb5::api::local;
@@ -62,16 +68,30 @@ using namespace eckit;
 namespace fdb5 {
 
 void LocalFDB::archive(const Key& key, const void* data, size_t length) {
+    archiver().archive(key, data, length);
+}
+
+void LocalFDB::archive(const std::vector<ArchiveItem>& items) {
+    archiver().archive(items);
+}
+
+Archiver& LocalFDB::archiver() {
     Archiver* archiver = nullptr;
     {
         std::lock_guard lock(mutex_);
         if (!archiver_) {
             LOG_DEBUG_LIB(LibFdb5) << *this << ": Constructing new archiver" << std::endl;
-            archiver_ = std::make_unique<Archiver>(config_, archiveCallback_);
+            if (config_.getBool("pipelinedArchive", false)) {
+                archiver_ = std::make_unique<PipelinedArchiver>(config_, archiveCallback_,
+                                                                config_.getUnsigned("pipelinedArchiveQueueSize", 64));
+            }
+            else {
+                archiver_ = std::make_unique<Archiver>(config_, archiveCallback_);
+            }
         }
         archiver = archiver_.get();
     }
-    archiver->archive(key, data, length);
+    return *archiver;
 }
 
 void LocalFDB::reindex(const Key& key, const FieldLocation& location) {
@@ -100,6 +120,92 @@ ListIterator LocalFDB::inspect(const metkit::mars::MarsRequest& request) {
     return inspector->inspect(request);
 }
 
+namespace {
+
+/// Bounds the results buffered for each database that is visited ahead of the one being output
+constexpr size_t orderedQueueSize = 100;
+
+/// Visitors that act on the databases they visit (rather than only reporting on them) always visit one database at
+/// a time
+template <typename VisitorType>
+constexpr bool parallelVisit = true;
+template <>
+constexpr bool parallelVisit<MoveVisitor> = false;
+template <>
+constexpr bool parallelVisit<ControlVisitor> = false;
+
+/// Visits the databases on several threads, each with its own visitor. In ordered mode, each database reports into
+/// its own queue, and the queues are drained into the output in database order, so the output is the same as for a
+/// serial visit.
+template <typename VisitorType, typename... Ts>
+void visitParallel(EntryVisitMechanism& mechanism, const FDBToolRequest& request, size_t threads, bool ordered,
+                   Queue<typename VisitorType::ValueType>& queue, Ts... args) {
+
+    using ValueType = typename VisitorType::ValueType;
+
+    std::vector<URI> uris = mechanism.locations(request);
+
+    if (!ordered) {
+        mechanism.visit(
+            uris, threads,
+            [&](size_t) -> std::unique_ptr<EntryVisitor> {
+                return std::make_unique<VisitorType>(queue, request.request(), args...);
+            },
+            [](size_t) {});
+        return;
+    }
+
+    std::vector<std::unique_ptr<Queue<ValueType>>> queues;
+    queues.reserve(uris.size());
+    for (size_t i = 0; i < uris.size(); ++i) {
+        queues.emplace_back(std::make_unique<Queue<ValueType>>(orderedQueueSize));
+    }
+
+    auto interruptAll = [&queues](std::exception_ptr e) {
+        for (auto& q : queues) {
+            q->interrupt(e);
+        }
+    };
+
+    std::future<void> visiting = std::async(std::launch::async, [&] {
+        try {
+            mechanism.visit(
+                uris, threads,
+                [&](size_t i) -> std::unique_ptr<EntryVisitor> {
+                    return std::make_unique<VisitorType>(*queues[i], request.request(), args...);
+                },
+                [&](size_t i) { queues[i]->close(); });
+        }
+        catch (...) {
+            interruptAll(std::current_exception());
+            throw;
+        }
+        // Errors that are only logged still leave some queues open
+        for (auto& q : queues) {
+            q->close();
+        }
+    });
+
+    try {
+        ValueType elem;
+        for (auto& q : queues) {
+            while (q->pop(elem) != -1) {
+                queue.emplace(std::move(elem));
+            }
+        }
+    }
+    catch (...) {
+        // Unblock the workers (e.g. if the iteration has been cancelled), and report the original error
+        interruptAll(std::current_exception());
+        visiting.wait();
+        throw;
+    }
+
+    visiting.get();
+}
+
+}  // namespace
+
 template <typename VisitorType, typename... Ts>
 APIIterator<typename VisitorType::ValueType> LocalFDB::queryInternal(const FDBToolRequest& request, Ts... args) {
 
@@ -107,8 +213,18 @@ APIIterator<typename VisitorType::ValueType> LocalFDB::queryInternal(const FDBTo
     using QueryIterator = APIIterator<ValueType>;
     using AsyncIterator = APIAsyncIterator<ValueType>;
 
-    auto async_worker = [this, request, args...](Queue<ValueType>& queue) {
+    static const long defaultThreads = eckit::Resource<long>("fdbVisitThreads;$FDB_VISIT_THREADS", 1);
+    static const bool defaultOrdered = eckit::Resource<bool>("fdbVisitOrdered;$FDB_VISIT_ORDERED", true);
+
+    const size_t threads = parallelVisit<VisitorType> ? config_.getUnsigned("visitThreads", defaultThreads) : 1;
+    const bool ordered = config_.getBool("visitOrdered", defaultOrdered);
+
+    auto async_worker = [this, request, threads, ordered, args...](Queue<ValueType>& queue) {
         EntryVisitMechanism mechanism(config_);
+        if (threads > 1) {
+            visitParallel<VisitorType>(mechanism, request, threads, ordered, queue, args...);
+            return;
+        }
         VisitorType visitor(queue, request.request(), args...);
         mechanism.visit(request, visitor);
     };
@@ -41,6 +41,8 @@ public:  // methods
 
     void archive(const Key& key, const void* data, size_t length) override;
 
+    void archive(const std::vector<ArchiveItem>& items) override;
+
     void reindex(const Key& key, const FieldLocation& location) override;
 
     ListIterator inspect(const metkit::mars::MarsRequest& request) override;
@@ -75,6 +77,9 @@ private:  // methods
 
     void print(std::ostream& s) const override;
 
+    /// Returns the archiver, constructing it on first use
+    Archiver& archiver();
+
 protected:  // members
 
     std::string home_;
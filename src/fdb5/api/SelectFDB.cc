@@ -97,6 +97,31 @@ void SelectFDB::archive(const Key& key, const void* data, size_t length) {
     throw eckit::UserError(ss.str(), Here());
 }
 
+void SelectFDB::archive(const std::vector<ArchiveItem>& items) {
+
+    // Forward each lane its share of the batch, keeping the order of the items
+    std::vector<std::vector<ArchiveItem>> batches(subFdbs_.size());
+
+    for (const auto& item : items) {
+        size_t lane = 0;
+        while (lane < subFdbs_.size() && !subFdbs_[lane].matches(item.key, Matcher::DontMatchOnMissing)) {
+            ++lane;
+        }
+        if (lane == subFdbs_.size()) {
+            std::ostringstream ss;
+            ss << "No matching fdb for key: " << item.key;
+            throw eckit::UserError(ss.str(), Here());
+        }
+        batches[lane].push_back(item);
+    }
+
+    for (size_t lane = 0; lane < subFdbs_.size(); ++lane) {
+        if (!batches[lane].empty()) {
+            subFdbs_[lane].get().archive(batches[lane]);
+        }
+    }
+}
+
 ListIterator SelectFDB::inspect(const MarsRequest& request) {
 
     std::queue<APIIterator<ListElement>> lists;
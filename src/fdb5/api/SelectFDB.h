@@ -62,6 +62,8 @@ public:  // methods
 
     void archive(const Key& key, const void* data, size_t length) override;
 
+    void archive(const std::vector<ArchiveItem>& items) override;
+
     ListIterator inspect(const metkit::mars::MarsRequest& request) override;
 
     ListIterator list(const FDBToolRequest& request, int level) override;
@@ -8,6 +8,8 @@
  * does it submit to any jurisdiction.
  */
 
+#include <sstream>
+
 #include "eckit/config/YAMLConfiguration.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/MemoryHandle.h"
@@ -415,6 +417,23 @@ int fdb_archive(fdb_handle_t* fdb, fdb_key_t* key, const char* data, size_t leng
         fdb->archive(*key, data, length);
     });
 }
+int fdb_archive_batch(fdb_handle_t* fdb, fdb_key_t* const* keys, const char* const* data, const size_t* lengths,
+                      size_t count) {
+    return wrapApiFunction([fdb, keys, data, lengths, count] {
+        ASSERT(fdb);
+        ASSERT(count == 0 || (keys && data && lengths));
+
+        std::vector<ArchiveItem> items;
+        items.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT(keys[i]);
+            ASSERT(data[i]);
+            items.push_back({*keys[i], data[i], lengths[i]});
+        }
+
+        fdb->archive(items);
+    });
+}
 int fdb_archive_multiple(fdb_handle_t* fdb, fdb_request_t* req, const char* data, size_t length) {
     return wrapApiFunction([fdb, req, data, length] {
         ASSERT(fdb);
@@ -456,6 +475,33 @@ int fdb_retrieve(fdb_handle_t* fdb, fdb_request_t* req, fdb_datareader_t* dr) {
     });
 }
 
+int fdb_retrieve_into(fdb_handle_t* fdb, fdb_request_t* req, void* const* buffers, const size_t* capacities,
+                      size_t count, size_t* lengths, size_t* nfields) {
+    return wrapApiFunction([fdb, req, buffers, capacities, count, lengths, nfields] {
+        ASSERT(fdb);
+        ASSERT(req);
+        ASSERT(nfields);
+        ASSERT(count == 0 || (buffers && capacities && lengths));
+
+        size_t n = 0;
+        *nfields = fdb->retrieveInto(req->request(), [&](const ListElement&, size_t length) {
+            if (n >= count) {
+                std::ostringstream ss;
+                ss << "fdb_retrieve_into: more than " << count << " fields match the request";
+                throw eckit::UserError(ss.str(), Here());
+            }
+            if (length > capacities[n]) {
+                std::ostringstream ss;
+                ss << "fdb_retrieve_into: field " << n << " of " << length << " bytes does not fit in buffer of "
+                   << capacities[n] << " bytes";
+                throw eckit::UserError(ss.str(), Here());
+            }
+            lengths[n] = length;
+            return buffers[n++];
+        });
+    });
+}
+
 int fdb_flush(fdb_handle_t* fdb) {
     return wrapApiFunction([fdb] {
         ASSERT(fdb);
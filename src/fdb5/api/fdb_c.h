@@ -335,6 +335,20 @@ int fdb_new_handle_from_yaml(fdb_handle_t** fdb, const char* system_config, cons
  */
 int fdb_archive(fdb_handle_t* fdb, fdb_key_t* key, const char* data, size_t length);
 
+/** Archives a batch of binary data to a FDB instance.
+ * Equivalent to calling #fdb_archive on each field in turn, but the fields sharing a database and index are written
+ * and indexed together.
+ * \warning this is a low-level API. The provided keys and the corresponding data are not checked for consistency
+ * \param fdb FDB instance.
+ * \param keys Array of #count keys used for indexing and archiving the data
+ * \param data Array of #count pointers to the binary data of each field
+ * \param lengths Array of #count sizes of the data of each field
+ * \param count Number of fields to archive
+ * \returns Return code (#FdbErrorValues)
+ */
+int fdb_archive_batch(fdb_handle_t* fdb, fdb_key_t* const* keys, const char* const* data, const size_t* lengths,
+                      size_t count);
+
 /** Archives multiple messages to a FDB instance.
  * \param fdb FDB instance.
  * \param req If Request #req is not nullptr, the number of messages and their metadata are checked against the provided
@@ -363,6 +377,22 @@ int fdb_list(fdb_handle_t* fdb, const fdb_request_t* req, fdb_listiterator_t** i
  */
 int fdb_retrieve(fdb_handle_t* fdb, fdb_request_t* req, fdb_datareader_t* dr);
 
+/** Return all available data whose metadata matches a given user request, directly into buffers provided by the caller.
+ * The i-th field is written at the start of buffers[i]. The sizes of the fields can be obtained beforehand with
+ * #fdb_list. If more than #count fields match the request, or a field does not fit in its buffer, an error is returned
+ * and no data is read.
+ * \param fdb FDB instance.
+ * \param req User Request. Metadata of retrieved data must match with the user Request
+ * \param buffers Array of #count memory buffers, one per field
+ * \param capacities Array of #count sizes of the memory buffers
+ * \param count Number of memory buffers
+ * \param lengths Array of #count entries, set to the size of each field retrieved
+ * \param nfields Number of fields retrieved
+ * \returns Return code (#FdbErrorValues)
+ */
+int fdb_retrieve_into(fdb_handle_t* fdb, fdb_request_t* req, void* const* buffers, const size_t* capacities,
+                      size_t count, size_t* lengths, size_t* nfields);
+
 /** Force flushing of all write operations
  * \param key FDB instance
  * \returns Return code (#FdbErrorValues)
@@ -0,0 +1,446 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include "fdb5/api/helpers/MoveIterator.h"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/utils/Hash.h"
+
+#include "fdb5/LibFdb5.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+const char* journalName = ".fdb-move.journal";
+
+constexpr size_t alignment = 4096;
+
+bool verifyCopies() {
+    static bool verify = eckit::Resource<bool>("fdbMoveVerify;$FDB_MOVE_VERIFY", true);
+    return verify;
+}
+
+size_t bufferSize() {
+    static size_t size = eckit::Resource<size_t>("fdbMoveBufferSize;$FDB_MOVE_BUFFER_SIZE", 16 * 1024 * 1024);
+    return std::max(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+std::unique_ptr<eckit::Hash> checksum() {
+    auto& factory = eckit::HashFactory::instance();
+    return std::unique_ptr<eckit::Hash>(factory.build(factory.has("xxh64") ? "xxh64" : "MD5"));
+}
+
+/// Closes the file descriptor on scope exit
+class Descriptor {
+public:
+
+    Descriptor(const eckit::PathName& path, int flags) : path_(path) {
+        SYSCALL2(fd_ = ::open(path.localPath(), flags, mode_t(0666)), path);
+    }
+
+    Descriptor(const Descriptor&) = delete;
+    Descriptor& operator=(const Descriptor&) = delete;
+
+    ~Descriptor() { ::close(fd_); }
+
+    int fd() const { return fd_; }
+
+    const eckit::PathName& path() const { return path_; }
+
+    /// Reads up to @p size bytes, only returning less at the end of the file
+    size_t read(char* buffer, size_t size) const {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t len;
+            SYSCALL2(len = ::read(fd_, buffer + done, size - done), path_);
+            if (len == 0) {
+                break;
+            }
+            done += len;
+        }
+        return done;
+    }
+
+    void write(const char* buffer, size_t size) const {
+        size_t done = 0;
+        while (done < size) {
+            ssize_t len;
+            SYSCALL2(len = ::write(fd_, buffer + done, size - done), path_);
+            done += len;
+        }
+    }
+
+    /// Hints that the file is read or written once, from start to end
+    void sequential() const {
+#if defined(__linux__)
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    /// Drops the cached pages of the file, once written out
+    void dropCache() const {
+#if defined(__linux__)
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    }
+
+private:
+
+    eckit::PathName path_;
+    int fd_;
+};
+
+/// Lets the kernel copy the file, which avoids moving the data through user space and may share the extents (reflink)
+/// on file systems that support it. Returns the number of bytes copied, which is less than @p size if the kernel
+/// cannot copy between these files, in which case the copy continues from the current offsets.
+size_t copyInKernel([[maybe_unused]] const Descriptor& in, [[maybe_unused]] const Descriptor& out,
+                    [[maybe_unused]] size_t size) {
+    size_t done = 0;
+#if defined(__linux__)
+    while (done < size) {
+        ssize_t len = ::copy_file_range(in.fd(), nullptr, out.fd(), nullptr, size - done, 0);
+        if (len < 0) {
+            if (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL) {
+                break;
+            }
+            throw eckit::FailedSystemCall("copy_file_range", Here(), errno);
+        }
+        if (len == 0) {
+            break;
+        }
+        done += len;
+    }
+#endif
+    return done;
+}
+
+/// Copies the rest of the file through @p buffer, and adds what is read to @p hash, if any
+size_t copyBuffered(const Descriptor& in, const Descriptor& out, char* buffer, size_t size, eckit::Hash* hash) {
+    size_t done = 0;
+    while (size_t len = in.read(buffer, size)) {
+        if (hash) {
+            hash->update(buffer, len);
+        }
+        out.write(buffer, len);
+        done += len;
+    }
+    return done;
+}
+
+std::string digest(const Descriptor& in, char* buffer, size_t size) {
+    auto hash = checksum();
+    while (size_t len = in.read(buffer, size)) {
+        hash->update(buffer, len);
+    }
+    return hash->digest();
+}
+
+/// Whether @p dest holds the copy recorded in its journal by an earlier attempt of the move, with @p size bytes
+bool copiedBefore(const eckit::PathName& dest, size_t size, bool verify, char* buffer, size_t length);
+
+/// The files copied by earlier attempts, by journal. Only the entries from before the move started matter, so a
+/// journal is read once per attempt.
+class Journals {
+public:
+
+    static Journals& instance() {
+        static Journals journals;
+        return journals;
+    }
+
+    bool copied(const eckit::PathName& journal, const std::string& file, size_t size, std::string& checksum) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = journals_.find(journal);
+        if (it == journals_.end()) {
+            it = journals_.emplace(journal, load(journal)).first;
+        }
+        auto entry = it->second.find(file);
+        if (entry == it->second.end() || entry->second.first != size) {
+            return false;
+        }
+        checksum = entry->second.second;
+        return true;
+    }
+
+    /// Drops the entries read by an earlier attempt of this process, so that the journal is read again
+    void forget(const eckit::PathName& journal) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        journals_.erase(journal);
+    }
+
+private:
+
+    static std::map<std::string, std::pair<size_t, std::string>> load(const eckit::PathName& journal) {
+        std::map<std::string, std::pair<size_t, std::string>> entries;
+        std::ifstream in(journal.localPath());
+        std::string line;
+        while (std::getline(in, line)) {
+            // n.b. the last line may be partial, if a copy was interrupted while recording it
+            std::istringstream fields(line);
+            std::string file;
+            size_t size;
+            std::string sum;
+            if (std::getline(fields, file, '\t') && fields >> size >> sum) {
+                entries[file] = {size, sum};
+            }
+        }
+        return entries;
+    }
+
+    std::mutex mutex_;
+    std::map<eckit::PathName, std::map<std::string, std::pair<size_t, std::string>>> journals_;
+};
+
+bool copiedBefore(const eckit::PathName& dest, size_t size, bool verify, char* buffer, size_t length) {
+
+    std::string sum;
+    if (!MoveJournal::copied(dest, size, sum) || !dest.exists() || size_t(dest.size()) != size) {
+        return false;
+    }
+
+    // Without verification, the size alone is trusted
+    if (!verify) {
+        return true;
+    }
+
+    // A copy that was not verified when it was made, or that has changed since, is copied again
+    if (sum == "-") {
+        return false;
+    }
+    Descriptor check(dest, O_RDONLY);
+    check.sequential();
+    return digest(check, buffer, length) == sum;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void FileCopy::execute() {
+
+    // The source directory itself, which is only cleaned up
+    if (src_.isDir()) {
+        return;
+    }
+
+    const size_t size = src_.size();
+    const bool verify = verifyCopies();
+
+    const size_t length = bufferSize();
+    std::unique_ptr<char, decltype(&std::free)> buffer(static_cast<char*>(std::aligned_alloc(alignment, length)),
+                                                       &std::free);
+    ASSERT(buffer);
+
+    if (copiedBefore(dest_, size, verify, buffer.get(), length)) {
+        LOG_DEBUG_LIB(LibFdb5) << "FileCopy " << dest_ << " was copied by an earlier attempt" << std::endl;
+    }
+    else {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::string sum = "-";
+        size_t copied = 0;
+
+        {
+            Descriptor in(src_, O_RDONLY);
+            Descriptor out(dest_, O_WRONLY | O_CREAT | O_TRUNC);
+            in.sequential();
+
+            copied = copyInKernel(in, out, size);
+
+            // What the kernel could not copy goes through the buffer, where it is hashed if the kernel copied nothing
+            std::unique_ptr<eckit::Hash> hash;
+            if (verify && copied == 0) {
+                hash = checksum();
+            }
+            copied += copyBuffered(in, out, buffer.get(), length, hash.get());
+            if (hash) {
+                sum = hash->digest();
+            }
+
+            SYSCALL2(::fsync(out.fd()), dest_);
+
+            // So that the copy is read back from storage
+            out.dropCache();
+        }
+
+        if (verify) {
+            // The data copied by the kernel has not been seen, so the source is hashed separately
+            if (sum == "-") {
+                Descriptor source(src_, O_RDONLY);
+                source.sequential();
+                sum = digest(source, buffer.get(), length);
+            }
+
+            Descriptor check(dest_, O_RDONLY);
+            check.sequential();
+            if (digest(check, buffer.get(), length) != sum) {
+                std::ostringstream msg;
+                msg << "Checksum of " << dest_ << " does not match that of " << src_;
+                throw eckit::SeriousBug(msg.str(), Here());
+            }
+        }
+
+        MoveJournal::record(dest_, copied, sum);
+
+        LOG_DEBUG_LIB(LibFdb5) << "FileCopy " << src_ << " to " << dest_ << ": " << eckit::Bytes(copied) << " in "
+                               << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << "s"
+                               << std::endl;
+    }
+
+    if (sync_) {
+        MoveJournal::remove(dest_.dirName());
+    }
+}
+
+void FileCopy::cleanup() {
+    if (src_.isDir()) {
+        MoveLocks::release(src_);
+        src_.rmdir(false);
+    }
+    else {
+        src_.unlink(false);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+eckit::PathName MoveJournal::path(const eckit::PathName& directory) {
+    return directory / journalName;
+}
+
+void MoveJournal::begin(const eckit::PathName& directory) {
+    directory.mkdir();
+
+    Journals::instance().forget(path(directory));
+
+    Descriptor journal(path(directory), O_RDWR | O_CREAT | O_APPEND);
+
+    // Terminate the entry that an interrupted copy may have left partial, so that it is not merged with the next one
+    off_t end;
+    SYSCALL2(end = ::lseek(journal.fd(), 0, SEEK_END), journal.path());
+    if (end > 0) {
+        char last;
+        SYSCALL2(::pread(journal.fd(), &last, 1, end - 1), journal.path());
+        if (last != '\n') {
+            journal.write("\n", 1);
+        }
+    }
+}
+
+bool MoveJournal::exists(const eckit::PathName& directory) {
+    return path(directory).exists();
+}
+
+bool MoveJournal::copied(const eckit::PathName& file, size_t size, std::string& checksum) {
+    return Journals::instance().copied(path(file.dirName()), file.baseName().asString(), size, checksum);
+}
+
+void MoveJournal::record(const eckit::PathName& file, size_t size, const std::string& checksum) {
+
+    std::ostringstream line;
+    line << file.baseName().asString() << '\t' << size << '\t' << checksum << '\n';
+    const std::string entry = line.str();
+
+    // A single write, appended atomically with respect to the other copies
+    Descriptor journal(path(file.dirName()), O_WRONLY | O_CREAT | O_APPEND);
+    journal.write(entry.c_str(), entry.size());
+}
+
+void MoveJournal::remove(const eckit::PathName& directory) {
+    path(directory).unlink(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// The locked files, by directory
+class Locks {
+public:
+
+    static Locks& instance() {
+        static Locks locks;
+        return locks;
+    }
+
+    std::mutex mutex;
+    std::map<std::string, std::map<std::string, int>> files;
+};
+
+std::string lockKey(const eckit::PathName& directory) {
+    return directory.realName().asString();
+}
+
+}  // namespace
+
+bool MoveLocks::lock(const eckit::PathName& directory, const std::string& file) {
+
+    Locks& locks = Locks::instance();
+    std::lock_guard<std::mutex> lock(locks.mutex);
+
+    auto& held = locks.files[lockKey(directory)];
+    if (held.find(file) != held.end()) {
+        return true;
+    }
+
+    const eckit::PathName path = directory / file;
+    int fd = ::open(path.localPath(), O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    if (::flock(fd, LOCK_EX) != 0) {
+        ::close(fd);
+        return false;
+    }
+    held.emplace(file, fd);
+    return true;
+}
+
+void MoveLocks::release(const eckit::PathName& directory) {
+
+    Locks& locks = Locks::instance();
+    std::lock_guard<std::mutex> lock(locks.mutex);
+
+    auto it = locks.files.find(lockKey(directory));
+    if (it == locks.files.end()) {
+        return;
+    }
+    for (const auto& [file, fd] : it->second) {
+        ::close(fd);
+    }
+    locks.files.erase(it);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <ostream>
+#include <string>
+
 #include "eckit/filesystem/PathName.h"
 #include "eckit/io/FileHandle.h"
 #include "eckit/thread/ThreadPool.h"
@@ -53,20 +57,14 @@ public:
 
     bool sync() { return sync_; }
 
-    void execute() {
-        eckit::FileHandle src(src_);
-        eckit::FileHandle dest(dest_);
-        src.copyTo(dest);
-    }
+    /// Copies the file, unless the journal of the destination shows that it was already copied by a move that was
+    /// interrupted. The copy is synced, and verified against a checksum of the source unless $FDB_MOVE_VERIFY is off.
+    /// A file found in the journal is checked against the checksum recorded for it, unless verification is off, in
+    /// which case its size alone is trusted.
+    void execute();
 
-    void cleanup() {
-        if (src_.isDir()) {
-            src_.rmdir(false);
-        }
-        else {
-            src_.unlink(false);
-        }
-    }
+    /// Removes the source. Removing the source directory, last, releases the locks taken on its files for the move.
+    void cleanup();
 
 private:  // methods
 
@@ -91,6 +89,48 @@ private:
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Records, in each destination directory, the files that have been copied and verified, so that an interrupted move
+/// can be resumed without copying them again. The journal is removed once the toc, which is copied last, is in place.
+class MoveJournal {
+
+public:  // methods
+
+    /// Starts or resumes a move into @p directory
+    static void begin(const eckit::PathName& directory);
+
+    /// Whether a move into @p directory was interrupted
+    static bool exists(const eckit::PathName& directory);
+
+    /// Whether @p file has been copied, with @p size bytes, by an earlier attempt of the move. If so, @p checksum is
+    /// set to the checksum recorded for it ("-" if the copy was not verified).
+    static bool copied(const eckit::PathName& file, size_t size, std::string& checksum);
+
+    static void record(const eckit::PathName& file, size_t size, const std::string& checksum);
+
+    static void remove(const eckit::PathName& directory);
+
+private:  // methods
+
+    static eckit::PathName path(const eckit::PathName& directory);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Exclusive locks on the files of the databases being moved by this process, which keep writers out of them from the
+/// start of the move until its source is cleaned up. A move resumed by the same process keeps the locks it holds.
+class MoveLocks {
+
+public:  // methods
+
+    /// Locks @p file of @p directory, waiting for any writer to release it. Returns false if it cannot be locked.
+    static bool lock(const eckit::PathName& directory, const std::string& file);
+
+    /// Releases the locks on the files of @p directory
+    static void release(const eckit::PathName& directory);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 using MoveElement = FileCopy;
 
 using MoveIterator = APIIterator<MoveElement>;
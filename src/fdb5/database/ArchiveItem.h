@@ -8,15 +8,26 @@
  * does it submit to any jurisdiction.
  */
 
-#include "fdb5/database/WriteVisitor.h"
+/// @file   ArchiveItem.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <cstddef>
+
+#include "fdb5/database/Key.h"
 
 namespace fdb5 {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-WriteVisitor::WriteVisitor(std::vector<Key>& prev) : prev_(prev) {
-    prev.resize(3);
-}
+/// A field to be archived as part of a batch (see FDB::archive(const std::vector<ArchiveItem>&)).
+/// The data is not owned, and must remain valid for the duration of the archive call.
+struct ArchiveItem {
+    Key key;
+    const void* data{nullptr};
+    size_t length{0};
+};
 
 //----------------------------------------------------------------------------------------------------------------------
 
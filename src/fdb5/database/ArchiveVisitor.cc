@@ -29,14 +29,13 @@ void ArchiveVisitor::callbacks(std::shared_ptr<CatalogueWriter> catalogue, const
                                std::shared_ptr<std::promise<std::shared_ptr<const FieldLocation>>> p,
                                std::shared_ptr<const FieldLocation> fieldLocation) {
     p->set_value(fieldLocation);
-    ASSERT(catalogue);
-    catalogue->archive(idxKey, datumKey, std::move(fieldLocation));
+    archiveLocation(catalogue, idxKey, datumKey, std::move(fieldLocation));
 }
 
 bool ArchiveVisitor::selectDatum(const Key& datumKey, const Key& fullKey) {
 
     checkMissingKeys(fullKey);
-    const Key idxKey = catalogue()->currentIndexKey();
+    const Key idxKey = currentIndexKey();
 
     auto p = std::make_shared<std::promise<std::shared_ptr<const FieldLocation>>>();
 
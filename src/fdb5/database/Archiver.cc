@@ -15,6 +15,7 @@
 #include "fdb5/api/helpers/Callback.h"
 #include "fdb5/database/ArchiveVisitor.h"
 #include "fdb5/database/BaseArchiveVisitor.h"
+#include "fdb5/database/BatchArchiveVisitor.h"
 #include "fdb5/database/Store.h"
 #include "fdb5/rules/Rule.h"
 #include "fdb5/rules/Schema.h"
@@ -22,32 +23,88 @@
 #include "eckit/config/Resource.h"
 
 #include <ctime>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
 
 namespace fdb5 {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+Database::Database(std::shared_ptr<CatalogueWriter> catalogue, std::unique_ptr<Store> store) :
+    time_(::time(nullptr)), catalogue_(std::move(catalogue)), store_(std::move(store)) {}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 Archiver::Archiver(const Config& dbConfig, const ArchiveCallback& callback) :
-    dbConfig_(dbConfig), db_(nullptr), callback_(callback) {}
+    dbConfig_(dbConfig), concurrent_(dbConfig.getBool("concurrentArchive", false)), callback_(callback) {}
 
 Archiver::~Archiver() {
     flush();  // certify that all sessions are flushed before closing them
 }
 
 void Archiver::archive(const Key& key, const void* data, size_t len) {
-    // Take the lock as visitor takes a reference to prev_ during construction
-    std::lock_guard lock(flushMutex_);
     auto visitor = ArchiveVisitor::create(*this, key, data, len, callback_);
     archive(key, *visitor);
 }
 
+void Archiver::archive(const std::vector<ArchiveItem>& items) {
+
+    if (items.empty()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> serial(archiveMutex_, std::defer_lock);
+    if (!concurrent_) {
+        serial.lock();
+    }
+
+    auto visitor = BatchArchiveVisitor::create(*this, items, callback_);
+
+    try {
+        for (size_t i = 0; i < items.size(); ++i) {
+            visitor->field(i);
+            dbConfig_.schema().expand(items[i].key, *visitor);
+
+            const Rule* rule = visitor->rule();
+            if (rule == nullptr) {
+                std::ostringstream oss;
+                oss << "FDB: Could not find a rule to archive " << items[i].key;
+                throw eckit::SeriousBug(oss.str());
+            }
+            rule->check(items[i].key);
+        }
+    }
+    catch (...) {
+        visitor->deselectDatabase();
+        throw;
+    }
+    visitor->deselectDatabase();
+
+    visitor->archive();
+}
+
 void Archiver::archive(const Key& key, BaseArchiveVisitor& visitor) {
 
-    std::lock_guard<std::recursive_mutex> lock(flushMutex_);
+    std::unique_lock<std::mutex> serial(archiveMutex_, std::defer_lock);
+    if (!concurrent_) {
+        serial.lock();
+    }
+
     visitor.rule(nullptr);
 
-    dbConfig_.schema().expand(key, visitor);
+    // The visitor holds the selected database locked until the expansion is complete
+    try {
+        dbConfig_.schema().expand(key, visitor);
+    }
+    catch (...) {
+        visitor.deselectDatabase();
+        throw;
+    }
+    visitor.deselectDatabase();
 
     const Rule* rule = visitor.rule();
     if (rule == nullptr) {  // Make sure we did find a rule that matched
@@ -64,47 +121,74 @@ void Archiver::flushDatabase(Database& db) {
     db.catalogue_->flush(db.store_->flush());
 }
 
+void Archiver::archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey,
+                               const Key& datumKey, std::shared_ptr<const FieldLocation> location) {
+    ASSERT(catalogue);
+    catalogue->archive(idxKey, datumKey, std::move(location));
+}
+
 void Archiver::flush() {
-    std::lock_guard<std::recursive_mutex> lock(flushMutex_);
-    for (auto i = databases_.begin(); i != databases_.end(); ++i) {
-        flushDatabase(i->second);
+
+    // Only hold the cache lock while taking the snapshot, so that archiving into databases that are not being
+    // flushed at this moment can proceed.
+    std::vector<std::shared_ptr<Database>> dbs;
+    {
+        std::shared_lock<std::shared_mutex> cacheLock(cacheMutex_);
+        dbs.reserve(databases_.size());
+        for (const auto& [key, db] : databases_) {
+            dbs.push_back(db);
+        }
+    }
+
+    for (const auto& db : dbs) {
+        std::lock_guard<std::mutex> lock(db->mutex_);
+        if (!db->evicted_) {
+            flushDatabase(*db);
+        }
     }
 }
 
-void Archiver::selectDatabase(const Key& dbKey) {
+std::shared_ptr<Database> Archiver::selectDatabase(const Key& dbKey, std::unique_lock<std::mutex>& lock) {
 
-    auto i = databases_.find(dbKey);
+    // A database may be evicted between the lookup and taking its lock. In that case look it up again.
+    while (true) {
+        std::shared_ptr<Database> db = cachedDatabase(dbKey);
 
-    if (i != databases_.end()) {
-        db_ = &(i->second);
-        i->second.time_ = ::time(0);
-        return;
+        std::unique_lock<std::mutex> dbLock(db->mutex_);
+        if (!db->evicted_) {
+            db->time_ = ::time(nullptr);
+            lock = std::move(dbLock);
+            return db;
+        }
     }
+}
 
-    static size_t fdbMaxNbDBsOpen = eckit::Resource<size_t>("fdbMaxNbDBsOpen", 64);
+std::shared_ptr<Database> Archiver::cachedDatabase(const Key& dbKey) {
 
     {
-        std::lock_guard<std::mutex> cacheLock(cacheMutex_);
-        if (databases_.size() >= fdbMaxNbDBsOpen) {
-            bool found = false;
-            time_t oldest = ::time(0) + 24 * 60 * 60;
-            Key oldK;
-            for (auto i = databases_.begin(); i != databases_.end(); ++i) {
-                if (i->second.time_ <= oldest) {
-                    found = true;
-                    oldK = i->first;
-                    oldest = i->second.time_;
-                }
-            }
-            if (found) {
-                // flushing before evicting from cache
-                std::lock_guard<std::recursive_mutex> lock(flushMutex_);
+        std::shared_lock<std::shared_mutex> cacheLock(cacheMutex_);
+        if (auto i = databases_.find(dbKey); i != databases_.end()) {
+            return i->second;
+        }
+    }
 
-                flushDatabase(databases_[oldK]);
+    // The database evicted to make room for this one is flushed once the cache is released, so that lookups of the
+    // other databases do not wait for the flush
+    std::shared_ptr<Database> evicted;
+    std::shared_ptr<Database> db;
 
-                eckit::Log::info() << "Closing database " << *databases_[oldK].catalogue_ << std::endl;
-                databases_.erase(oldK);
-            }
+    try {
+        std::unique_lock<std::shared_mutex> cacheLock(cacheMutex_);
+
+        // Another thread may have opened the database whilst we were waiting for the lock
+        if (auto i = databases_.find(dbKey); i != databases_.end()) {
+            return i->second;
+        }
+
+        static size_t fdbMaxNbDBsOpen = eckit::Resource<size_t>("fdbMaxNbDBsOpen", 64);
+
+        if (databases_.size() >= fdbMaxNbDBsOpen) {
+            evicted = evictDatabase();
         }
 
         std::shared_ptr<CatalogueWriter> cat = CatalogueWriterFactory::instance().build(dbKey, dbConfig_);
@@ -117,8 +201,49 @@ void Archiver::selectDatabase(const Key& dbKey) {
             throw eckit::UserError(ss.str(), Here());
         }
 
-        db_ = &(databases_[dbKey] = Database{::time(0), cat, cat->buildStore()});
+        db = std::make_shared<Database>(cat, cat->buildStore());
+        databases_.emplace(dbKey, db);
+    }
+    catch (...) {
+        if (evicted) {
+            closeDatabase(*evicted);
+        }
+        throw;
+    }
+
+    if (evicted) {
+        closeDatabase(*evicted);
+    }
+    return db;
+}
+
+std::shared_ptr<Database> Archiver::evictDatabase() {
+
+    auto oldest = databases_.end();
+    for (auto i = databases_.begin(); i != databases_.end(); ++i) {
+        if (oldest == databases_.end() || i->second->time_ <= oldest->second->time_) {
+            oldest = i;
+        }
     }
+
+    if (oldest == databases_.end()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<Database> db = oldest->second;
+    databases_.erase(oldest);
+    return db;
+}
+
+void Archiver::closeDatabase(Database& db) {
+
+    // Any thread still archiving into it completes before we take the lock. Threads looking it up from now on open
+    // the database anew, as writers of separate processes would.
+    std::lock_guard<std::mutex> lock(db.mutex_);
+    flushDatabase(db);
+    db.evicted_ = true;
+
+    eckit::Log::info() << "Closing database " << *db.catalogue_ << std::endl;
 }
 
 void Archiver::print(std::ostream& out) const {
@@ -16,16 +16,19 @@
 #ifndef fdb5_Archiver_H
 #define fdb5_Archiver_H
 
+#include <atomic>
 #include <cstddef>
 #include <ctime>
 #include <iosfwd>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <vector>
 
 #include "fdb5/api/helpers/Callback.h"
 #include "fdb5/config/Config.h"
+#include "fdb5/database/ArchiveItem.h"
 #include "fdb5/database/Catalogue.h"
 
 namespace eckit {
@@ -43,10 +46,26 @@ class Schema;
 //----------------------------------------------------------------------------------------------------------------------
 
 struct Database {
-    time_t time_;
+
+    Database(std::shared_ptr<CatalogueWriter> catalogue, std::unique_ptr<Store> store);
+
+    std::atomic<time_t> time_;
     std::shared_ptr<CatalogueWriter> catalogue_;
     std::unique_ptr<Store> store_;
+
+    /// Serialises archive and flush on this database. Archiving into other databases is not blocked.
+    std::mutex mutex_;
+    /// Set (under mutex_) once the database has been flushed and dropped from the Archiver cache
+    bool evicted_{false};
 };
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Archives fields into the databases selected by the schema, keeping a cache of open databases.
+///
+/// By default archive calls are serialised. With the configuration option "concurrentArchive: true", archive calls
+/// from multiple threads only serialise when they write into the same database (the catalogue and store of a
+/// database are not thread-safe), and the archive callback may be invoked concurrently.
 class Archiver {
 
 public:  // methods
@@ -61,11 +80,15 @@ public:  // methods
     virtual ~Archiver();
 
     void archive(const Key& key, BaseArchiveVisitor& visitor);
-    void archive(const Key& key, const void* data, size_t len);
+    virtual void archive(const Key& key, const void* data, size_t len);
+
+    /// Archives a batch of fields. All the fields are matched against the schema before any data is written, and
+    /// the fields sharing a database and index are written and indexed together.
+    virtual void archive(const std::vector<ArchiveItem>& items);
 
     /// Flushes all buffers and closes all data handles into a consistent DB state
     /// @note always safe to call
-    void flush();
+    virtual void flush();
 
     friend std::ostream& operator<<(std::ostream& s, const Archiver& x) {
         x.print(s);
@@ -74,17 +97,34 @@ public:  // methods
 
 protected:  // methods
 
+    /// @pre db.mutex_ is held by the caller
     virtual void flushDatabase(Database& db);
 
+    /// Inserts the location of a field written to the store into the catalogue.
+    /// @note called from the store callback, which may run on another thread than archive()
+    virtual void archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey,
+                                 const Key& datumKey, std::shared_ptr<const FieldLocation> location);
+
 private:  // methods
 
     void print(std::ostream& out) const;
 
-    void selectDatabase(const Key& key);
+    /// Returns the database for dbKey (opening it if needed), locked by the returned lock
+    std::shared_ptr<Database> selectDatabase(const Key& dbKey, std::unique_lock<std::mutex>& lock);
+
+    std::shared_ptr<Database> cachedDatabase(const Key& dbKey);
+
+    /// Removes the least recently used database from the cache, and returns it to be closed by closeDatabase
+    /// @pre cacheMutex_ is held exclusively by the caller
+    std::shared_ptr<Database> evictDatabase();
+
+    /// Flushes a database removed from the cache, holding only its own lock
+    /// @pre cacheMutex_ is not held by the caller
+    void closeDatabase(Database& db);
 
 protected:  // members
 
-    std::map<Key, Database> databases_;
+    std::map<Key, std::shared_ptr<Database>> databases_;
 
 private:  // members
 
@@ -92,12 +132,10 @@ private:  // members
 
     Config dbConfig_;
 
-    std::vector<Key> prev_;
-
-    Database* db_;
+    bool concurrent_;
 
-    std::recursive_mutex flushMutex_;
-    std::mutex cacheMutex_;
+    std::mutex archiveMutex_;       ///< serialises archive() unless concurrent_
+    std::shared_mutex cacheMutex_;  ///< guards databases_ (lookups are shared, open/evict are exclusive)
     const ArchiveCallback& callback_;
 };
 
@@ -19,26 +19,43 @@
 namespace fdb5 {
 
 BaseArchiveVisitor::BaseArchiveVisitor(Archiver& owner, const Key& initialFieldKey) :
-    WriteVisitor(owner.prev_), owner_(owner), initialFieldKey_(initialFieldKey) {
+    owner_(owner), initialFieldKey_(initialFieldKey) {
     checkMissingKeysOnWrite_ = eckit::Resource<bool>("checkMissingKeysOnWrite", true);
 }
 
 bool BaseArchiveVisitor::selectDatabase(const Key& dbKey, const Key&) {
     LOG_DEBUG_LIB(LibFdb5) << "BaseArchiveVisitor::selectDatabase " << dbKey << std::endl;
-    owner_.selectDatabase(dbKey);
+    // never hold the lock of one database whilst waiting for another
+    deselectDatabase();
+    db_ = owner_.selectDatabase(dbKey, dbLock_);
     catalogue()->deselectIndex();
+    currentIndexKey_ = Key();
 
     return true;
 }
 
+void BaseArchiveVisitor::deselectDatabase() {
+    if (dbLock_.owns_lock()) {
+        dbLock_.unlock();
+    }
+    db_.reset();
+}
+
 bool BaseArchiveVisitor::selectIndex(const Key& idxKey) {
+    currentIndexKey_ = idxKey;
     return catalogue()->selectIndex(idxKey);
 }
 
 bool BaseArchiveVisitor::createIndex(const Key& idxKey, size_t datumKeySize) {
+    currentIndexKey_ = idxKey;
     return catalogue()->createIndex(idxKey, datumKeySize);
 }
 
+void BaseArchiveVisitor::archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey,
+                                         const Key& datumKey, std::shared_ptr<const FieldLocation> location) {
+    owner_.archiveLocation(catalogue, idxKey, datumKey, std::move(location));
+}
+
 void BaseArchiveVisitor::checkMissingKeys(const Key& fullKey) const {
     if (checkMissingKeysOnWrite_) {
         fullKey.validateKeys(initialFieldKey_);
@@ -50,15 +67,15 @@ const Schema& BaseArchiveVisitor::databaseSchema() const {
 }
 
 std::shared_ptr<CatalogueWriter> BaseArchiveVisitor::catalogue() const {
-    ASSERT(owner_.db_);
-    ASSERT(owner_.db_->catalogue_);
-    return owner_.db_->catalogue_;
+    ASSERT(db_);
+    ASSERT(db_->catalogue_);
+    return db_->catalogue_;
 }
 
 Store* BaseArchiveVisitor::store() const {
-    ASSERT(owner_.db_);
-    ASSERT(owner_.db_->store_);
-    return owner_.db_->store_.get();
+    ASSERT(db_);
+    ASSERT(db_->store_);
+    return db_->store_.get();
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include "fdb5/database/WriteVisitor.h"
 
 namespace metkit::mars {
@@ -25,6 +28,8 @@ namespace fdb5 {
 
 class Archiver;
 class CatalogueWriter;
+struct Database;
+class FieldLocation;
 class Store;
 class Schema;
 
@@ -36,6 +41,9 @@ public:  // methods
 
     BaseArchiveVisitor(Archiver& owner, const Key& initialFieldKey);
 
+    /// Releases the database selected (and locked) during the schema expansion
+    void deselectDatabase();
+
 protected:  // methods
 
     bool selectDatabase(const Key& dbKey, const Key&) override;
@@ -51,12 +59,25 @@ protected:  // methods
     Store* store() const;
 
     const Key& initialFieldKey() const { return initialFieldKey_; }
+    void initialFieldKey(const Key& key) { initialFieldKey_ = key; }
+
+    /// The index key selected during this expansion. Unlike CatalogueWriter::currentIndexKey, it is not affected by
+    /// locations being archived asynchronously into the same catalogue.
+    const Key& currentIndexKey() const { return currentIndexKey_; }
+
+    /// Hands the location of a field written to the store to the owning Archiver
+    void archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey, const Key& datumKey,
+                         std::shared_ptr<const FieldLocation> location);
 
 private:  // members
 
     Archiver& owner_;
 
+    std::shared_ptr<Database> db_;
+    std::unique_lock<std::mutex> dbLock_;
+
     Key initialFieldKey_;
+    Key currentIndexKey_;
 
     bool checkMissingKeysOnWrite_;
 };
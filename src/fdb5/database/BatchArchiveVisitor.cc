@@ -0,0 +1,191 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "fdb5/database/BatchArchiveVisitor.h"
+
+#include "eckit/exception/Exceptions.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Store.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <map>
+#include <numeric>
+#include <utility>
+
+namespace fdb5 {
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The locations of one group of fields, inserted into the index once the store has returned all of them
+struct IndexBatch {
+
+    IndexBatch(std::shared_ptr<CatalogueWriter> catalogue, const Key& idxKey, size_t size) :
+        catalogue_(std::move(catalogue)),
+        idxKey_(idxKey),
+        datumKeys_(size),
+        locations_(size),
+        promises_(size),
+        remaining_(size) {}
+
+    std::shared_ptr<CatalogueWriter> catalogue_;
+    Key idxKey_;
+    std::vector<Key> datumKeys_;
+    std::vector<std::shared_ptr<const FieldLocation>> locations_;
+    std::vector<std::promise<std::shared_ptr<const FieldLocation>>> promises_;
+    std::atomic<size_t> remaining_;
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+BatchArchiveVisitor::BatchArchiveVisitor(Archiver& owner, const std::vector<ArchiveItem>& items,
+                                         const ArchiveCallback& callback) :
+    BaseArchiveVisitor(owner, Key()), items_(items), callback_(callback) {
+    resolved_.reserve(items_.size());
+}
+
+std::shared_ptr<BatchArchiveVisitor> BatchArchiveVisitor::create(Archiver& owner, const std::vector<ArchiveItem>& items,
+                                                                 const ArchiveCallback& callback) {
+    return std::shared_ptr<BatchArchiveVisitor>(new BatchArchiveVisitor(owner, items, callback));
+}
+
+void BatchArchiveVisitor::field(size_t i) {
+    ASSERT(i < items_.size());
+    ASSERT(resolved_.size() == i);
+    current_ = i;
+    initialFieldKey(items_[i].key);
+    rule(nullptr);
+}
+
+bool BatchArchiveVisitor::selectDatabase(const Key& dbKey, const Key& fullKey) {
+    // Consecutive fields usually share their database. It stays selected (and locked) until another one is needed.
+    if (dbSelected_ && dbKey == dbKey_) {
+        return true;
+    }
+    dbKey_ = dbKey;
+    dbSelected_ = BaseArchiveVisitor::selectDatabase(dbKey, fullKey);
+    return dbSelected_;
+}
+
+bool BatchArchiveVisitor::selectIndex(const Key& idxKey) {
+    // Only resolve the index key here. The index is selected (or created) once per group by archiveGroup()
+    idxKey_ = idxKey;
+    return true;
+}
+
+bool BatchArchiveVisitor::createIndex(const Key& idxKey, size_t /*datumKeySize*/) {
+    idxKey_ = idxKey;
+    return true;
+}
+
+bool BatchArchiveVisitor::selectDatum(const Key& datumKey, const Key& fullKey) {
+
+    checkMissingKeys(fullKey);
+
+    ASSERT(resolved_.size() == current_);
+    resolved_.push_back({dbKey_, idxKey_, datumKey});
+
+    return true;
+}
+
+void BatchArchiveVisitor::archive() {
+
+    ASSERT(resolved_.size() == items_.size());
+    dbSelected_ = false;
+
+    // Group the fields by database and index, keeping the order of the fields within each group
+    std::map<std::pair<Key, Key>, std::vector<size_t>> groups;
+    for (size_t i = 0; i < resolved_.size(); ++i) {
+        groups[{resolved_[i].dbKey_, resolved_[i].idxKey_}].push_back(i);
+    }
+
+    LOG_DEBUG_LIB(LibFdb5) << "BatchArchiveVisitor: archiving " << items_.size() << " fields in " << groups.size()
+                           << " groups" << std::endl;
+
+    try {
+        for (const auto& [keys, fields] : groups) {
+            archiveGroup(keys.first, keys.second, fields);
+        }
+    }
+    catch (...) {
+        deselectDatabase();
+        throw;
+    }
+    deselectDatabase();
+}
+
+void BatchArchiveVisitor::archiveGroup(const Key& dbKey, const Key& idxKey, const std::vector<size_t>& fields) {
+
+    ASSERT(!fields.empty());
+
+    BaseArchiveVisitor::selectDatabase(dbKey, dbKey);
+    if (!BaseArchiveVisitor::selectIndex(idxKey)) {
+        BaseArchiveVisitor::createIndex(idxKey, resolved_[fields.front()].datumKey_.size());
+    }
+
+    auto batch = std::make_shared<IndexBatch>(catalogue(), idxKey, fields.size());
+
+    std::vector<const ArchiveItem*> data;
+    data.reserve(fields.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        data.push_back(&items_[fields[i]]);
+        batch->datumKeys_[i] = resolved_[fields[i]].datumKey_;
+    }
+
+    std::vector<std::future<std::shared_ptr<const FieldLocation>>> futures;
+    futures.reserve(fields.size());
+    for (auto& p : batch->promises_) {
+        futures.push_back(p.get_future());
+    }
+
+    // With a remote store, the locations may be returned asynchronously. The last one inserts the whole group.
+    std::shared_ptr<BatchArchiveVisitor> self = shared_from_this();
+    store()->archiveBatch(idxKey, data, [self, batch](size_t i, std::unique_ptr<const FieldLocation> loc) {
+        batch->locations_[i] = std::move(loc);
+        batch->promises_[i].set_value(batch->locations_[i]);
+
+        if (--batch->remaining_ > 0) {
+            return;
+        }
+
+        // Sorted insertion keeps the index updates local. The sort is stable, so that when the batch contains the
+        // same key more than once the last field still masks the earlier ones.
+        std::vector<size_t> order(batch->datumKeys_.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&batch](size_t a, size_t b) { return batch->datumKeys_[a] < batch->datumKeys_[b]; });
+
+        for (size_t j : order) {
+            self->archiveLocation(batch->catalogue_, batch->idxKey_, batch->datumKeys_[j],
+                                  std::move(batch->locations_[j]));
+        }
+    });
+
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const ArchiveItem& item = items_[fields[i]];
+        callback_(item.key, item.data, item.length, std::move(futures[i]));
+    }
+}
+
+void BatchArchiveVisitor::print(std::ostream& out) const {
+    out << "BatchArchiveVisitor["
+        << "size=" << items_.size() << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
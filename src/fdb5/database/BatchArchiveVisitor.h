@@ -0,0 +1,87 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   BatchArchiveVisitor.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "fdb5/api/helpers/Callback.h"
+#include "fdb5/database/ArchiveItem.h"
+#include "fdb5/database/BaseArchiveVisitor.h"
+
+namespace fdb5 {
+
+class Archiver;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Archives a batch of fields in two passes.
+///
+/// The schema expansion of each field only resolves its database, index and datum keys, without touching the
+/// indexes or the store. The fields are then archived group by group: each (database, index) pair is selected once,
+/// the data of the group is handed to the store in one call, and the index entries are inserted sorted by datum key.
+class BatchArchiveVisitor : public BaseArchiveVisitor, public std::enable_shared_from_this<BatchArchiveVisitor> {
+
+public:  // methods
+
+    static std::shared_ptr<BatchArchiveVisitor> create(Archiver& owner, const std::vector<ArchiveItem>& items,
+                                                       const ArchiveCallback& callback = CALLBACK_ARCHIVE_NOOP);
+
+    /// Selects the field resolved by the next schema expansion
+    void field(size_t i);
+
+    /// Archives all the resolved fields
+    /// @pre every field has been expanded, and the database deselected
+    void archive();
+
+protected:  // methods
+
+    BatchArchiveVisitor(Archiver& owner, const std::vector<ArchiveItem>& items, const ArchiveCallback& callback);
+
+    bool selectDatabase(const Key& dbKey, const Key& fullKey) override;
+    bool selectIndex(const Key& idxKey) override;
+    bool createIndex(const Key& idxKey, size_t datumKeySize) override;
+    bool selectDatum(const Key& datumKey, const Key& fullKey) override;
+
+    void print(std::ostream& out) const override;
+
+private:  // types
+
+    struct Resolved {
+        Key dbKey_;
+        Key idxKey_;
+        Key datumKey_;
+    };
+
+private:  // methods
+
+    void archiveGroup(const Key& dbKey, const Key& idxKey, const std::vector<size_t>& fields);
+
+private:  // members
+
+    const std::vector<ArchiveItem>& items_;
+    std::vector<Resolved> resolved_;
+
+    size_t current_{0};
+    Key dbKey_;
+    Key idxKey_;
+    bool dbSelected_{false};
+
+    const ArchiveCallback& callback_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -0,0 +1,171 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#include <string>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/serialisation/Stream.h"
+
+#include "fdb5/database/BloomFilter.h"
+#include "fdb5/database/Key.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+const uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t fnvPrime = 1099511628211ULL;
+
+uint64_t fnv1a(uint64_t h, const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        h ^= p[i];
+        h *= fnvPrime;
+    }
+    return h;
+}
+
+/// Finaliser of splitmix64, to derive the second hash of the double hashing scheme
+uint64_t mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+const unsigned int maxHashes = 16;
+
+// n.b. the words of a filter, and the lengths hashed with the keys, are little-endian whatever the byte order of the
+// host, as the filters are stored in the TOC
+
+void putLittleEndian(unsigned char* p, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        p[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+uint64_t getLittleEndian(const unsigned char* p) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+        value |= uint64_t(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+BloomFilter::BloomFilter() : nhashes_(0) {}
+
+BloomFilter::BloomFilter(const std::vector<uint64_t>& hashes, size_t bitsPerKey) : nhashes_(0) {
+
+    if (hashes.empty() || bitsPerKey == 0) {
+        return;
+    }
+
+    // k = ln(2) * m / n minimises the false positive rate
+    nhashes_ = std::clamp(static_cast<unsigned int>(std::lround(bitsPerKey * 0.693)), 1U, maxHashes);
+
+    size_t nbits = std::max<size_t>(hashes.size() * bitsPerKey, 64);
+    words_.assign((nbits + 63) / 64, 0);
+    nbits = bits();
+
+    for (uint64_t h1 : hashes) {
+        uint64_t h2 = mix(h1) | 1;
+        for (unsigned int i = 0; i < nhashes_; ++i) {
+            uint64_t bit = (h1 + i * h2) % nbits;
+            words_[bit / 64] |= (uint64_t(1) << (bit % 64));
+        }
+    }
+}
+
+BloomFilter::BloomFilter(eckit::Stream& s) {
+
+    std::string data;
+    s >> nhashes_;
+    s >> data;
+
+    if (nhashes_ == 0 || nhashes_ > maxHashes || data.empty() || data.size() % sizeof(uint64_t) != 0) {
+        throw eckit::SeriousBug("Invalid Bloom filter in stream", Here());
+    }
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    words_.resize(data.size() / sizeof(uint64_t));
+    for (uint64_t& word : words_) {
+        word = getLittleEndian(p);
+        p += sizeof(uint64_t);
+    }
+}
+
+uint64_t BloomFilter::hash(const Key& key) {
+    uint64_t h = fnvOffsetBasis;
+    for (const auto& [keyword, value] : key) {
+        // The lengths separate the strings, so that the keys {a: bc} and {ab: c} differ
+        unsigned char lengths[2 * sizeof(uint32_t)];
+        putLittleEndian(lengths, static_cast<uint32_t>(keyword.size()), sizeof(uint32_t));
+        putLittleEndian(lengths + sizeof(uint32_t), static_cast<uint32_t>(value.size()), sizeof(uint32_t));
+        h = fnv1a(h, lengths, sizeof(lengths));
+        h = fnv1a(h, keyword.data(), keyword.size());
+        h = fnv1a(h, value.data(), value.size());
+    }
+    return h;
+}
+
+bool BloomFilter::mayContain(uint64_t h1) const {
+
+    if (empty()) {
+        return true;
+    }
+
+    const uint64_t nbits = bits();
+    const uint64_t h2 = mix(h1) | 1;
+    for (unsigned int i = 0; i < nhashes_; ++i) {
+        uint64_t bit = (h1 + i * h2) % nbits;
+        if (!(words_[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BloomFilter::encode(eckit::Stream& s) const {
+    ASSERT(!empty());
+    std::string data(words_.size() * sizeof(uint64_t), '\0');
+    unsigned char* p = reinterpret_cast<unsigned char*>(data.data());
+    for (uint64_t word : words_) {
+        putLittleEndian(p, word, sizeof(uint64_t));
+        p += sizeof(uint64_t);
+    }
+    s << nhashes_;
+    s << data;
+}
+
+size_t BloomFilter::encodedSize() const {
+    // the words, plus the tags and lengths of the stream
+    return words_.size() * sizeof(uint64_t) + 64;
+}
+
+void BloomFilter::print(std::ostream& out) const {
+    out << "BloomFilter[bits=" << bits() << ",hashes=" << nhashes_ << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -0,0 +1,81 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   BloomFilter.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace eckit {
+class Stream;
+}
+
+namespace fdb5 {
+
+class Key;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Bloom filter over the datum keys of an index.
+///
+/// The filter answers whether an index may contain a key, with no false negatives and a false positive rate set by
+/// the number of bits per key. It is built once, from the hashes of all the keys, and is immutable after that. An
+/// empty filter (the default) may contain any key.
+class BloomFilter {
+
+public:  // methods
+
+    BloomFilter();
+
+    /// Builds a filter holding the keys of the given hashes, with @p bitsPerKey bits for each
+    BloomFilter(const std::vector<uint64_t>& hashes, size_t bitsPerKey);
+
+    explicit BloomFilter(eckit::Stream& s);
+
+    /// Hash of a datum key, as used by the filter. This depends on the keywords and values only, and is stable
+    /// across platforms and versions, as filters are stored with the indexes.
+    static uint64_t hash(const Key& key);
+
+    bool empty() const { return words_.empty(); }
+
+    bool mayContain(uint64_t hash) const;
+    bool mayContain(const Key& key) const { return empty() || mayContain(hash(key)); }
+
+    void encode(eckit::Stream& s) const;
+
+    /// Upper bound of the number of bytes written by encode()
+    size_t encodedSize() const;
+
+    size_t bits() const { return words_.size() * 64; }
+    size_t hashes() const { return nhashes_; }
+
+private:  // methods
+
+    void print(std::ostream& out) const;
+
+    friend std::ostream& operator<<(std::ostream& s, const BloomFilter& f) {
+        f.print(s);
+        return s;
+    }
+
+private:  // members
+
+    unsigned int nhashes_;
+    std::vector<uint64_t> words_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -68,6 +68,15 @@ bool CatalogueImpl::enabled(const ControlIdentifier& controlIdentifier) const {
     return controlIdentifiers_.enabled(controlIdentifier);
 }
 
+std::vector<bool> CatalogueReader::retrieveBatch(const std::vector<Key>& keys, std::vector<Field>& fields) const {
+    fields.resize(keys.size());
+    std::vector<bool> found(keys.size(), false);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        found[i] = retrieve(keys[i], fields[i]);
+    }
+    return found;
+}
+
 void CatalogueReader::invalidateAxis() {
     axisCache_.clear();
 }
@@ -181,6 +181,17 @@ public:
     std::optional<std::reference_wrapper<const Axis>> axis(const std::string& keyword) const;
     virtual bool retrieve(const Key& key, Field& field) const = 0;
 
+    /// Whether retrieveBatch() looks up the keys of the selected index faster than retrieve() does one by one.
+    virtual bool batchRetrieval() const { return false; }
+
+    /// Looks up several datum keys in the selected index. @p fields is resized to match @p keys.
+    /// @returns whether each key was found. By default, calls retrieve() for each key in turn.
+    virtual std::vector<bool> retrieveBatch(const std::vector<Key>& keys, std::vector<Field>& fields) const;
+
+    /// Picks up the indexes added to the database since it was opened, if FDB_REFRESH_OPEN_DATABASES is set.
+    /// @returns whether the indexes have changed. By default, the catalogue is not refreshed.
+    virtual bool refresh() { return false; }
+
 protected:  // methods
 
     void invalidateAxis();
@@ -211,6 +222,9 @@ public:
     virtual void index(const Key& key, const eckit::URI& uri, eckit::Offset offset, eckit::Length length) = 0;
     virtual void reconsolidate() = 0;
     virtual size_t archivedLocations() const { NOTIMP; }
+    /// Whether archive() may be called from another thread, independently of the index selected by the archiving
+    /// thread (i.e. it only relies on idxKey to select the index)
+    virtual bool asyncArchive() const { return false; }
 };
 
 //----------------------------------------------------------------------------------------------------------------------
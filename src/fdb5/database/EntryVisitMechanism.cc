@@ -20,6 +20,9 @@
 #include "fdb5/database/Store.h"
 #include "fdb5/rules/Schema.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -106,6 +109,21 @@ void EntryVisitMechanism::visit(const FDBToolRequest& request, EntryVisitor& vis
         throw FDBVisitException("Cannot visit entries without visiting indexes", Here());
     }
 
+    try {
+        // n.b. it is not an error if nothing is found (especially in a sub-fdb).
+
+        // And do the visitation
+        for (const URI& uri : locations(request)) {
+            visitDatabase(uri, visitor);
+        }
+    }
+    catch (...) {
+        handleError(std::current_exception());
+    }
+}
+
+std::vector<URI> EntryVisitMechanism::locations(const FDBToolRequest& request) const {
+
     // A request against all is the same as using an empty key in visitableLocations.
 
     ASSERT(request.all() == request.request().empty());
@@ -114,38 +132,86 @@ void EntryVisitMechanism::visit(const FDBToolRequest& request, EntryVisitor& vis
 
     LOG_DEBUG_LIB(LibFdb5) << "REQUEST ====> " << request.request() << std::endl;
 
-    try {
-        fdb5::Manager mg{dbConfig_};
-        std::vector<URI> uris(mg.visitableLocations(request.request(), request.all()));
+    fdb5::Manager mg{dbConfig_};
+    return mg.visitableLocations(request.request(), request.all());
+}
 
-        // n.b. it is not an error if nothing is found (especially in a sub-fdb).
+void EntryVisitMechanism::visit(const std::vector<URI>& uris, size_t threads, const VisitorFactory& makeVisitor,
+                                const std::function<void(size_t)>& done) {
+
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+
+    auto worker = [&] {
+        try {
+            for (size_t i = next++; i < uris.size() && !failed; i = next++) {
+                std::unique_ptr<EntryVisitor> visitor = makeVisitor(i);
+                if (visitor->visitEntries() && !visitor->visitIndexes()) {
+                    throw FDBVisitException("Cannot visit entries without visiting indexes", Here());
+                }
+                visitDatabase(uris[i], *visitor);
+                visitor.reset();
+                done(i);
+            }
+        }
+        catch (...) {
+            failed = true;
+            throw;
+        }
+    };
 
-        // And do the visitation
-        for (const URI& uri : uris) {
-            if (!visitor.preVisitDatabase(uri, dbConfig_.schema())) {
-                continue;
+    std::vector<std::future<void>> workers;
+    for (size_t t = 0; t < std::min(threads, uris.size()); ++t) {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+
+    std::exception_ptr error;
+    for (auto& w : workers) {
+        try {
+            w.get();
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
             }
+        }
+    }
 
-            /// @note: the schema of a URI returned by visitableLocations
-            ///   matches the corresponding Engine type name
-            // fdb5::Engine& ng = fdb5::Engine::backend(uri.scheme());
-            LOG_DEBUG_LIB(LibFdb5) << "FDB processing URI " << uri << std::endl;
+    if (error) {
+        handleError(error);
+    }
+}
 
-            std::unique_ptr<CatalogueReader> catalogue;
-            try {
+void EntryVisitMechanism::visitDatabase(const URI& uri, EntryVisitor& visitor) const {
 
-                catalogue = CatalogueReaderFactory::instance().build(uri, dbConfig_);
-            }
-            catch (fdb5::DatabaseNotFoundException& e) {
-                visitor.onDatabaseNotFound(e);
-            }
+    if (!visitor.preVisitDatabase(uri, dbConfig_.schema())) {
+        return;
+    }
 
-            ASSERT(catalogue->open());
+    /// @note: the schema of a URI returned by visitableLocations
+    ///   matches the corresponding Engine type name
+    // fdb5::Engine& ng = fdb5::Engine::backend(uri.scheme());
+    LOG_DEBUG_LIB(LibFdb5) << "FDB processing URI " << uri << std::endl;
 
-            eckit::AutoCloser<Catalogue> closer(*catalogue);
+    std::unique_ptr<CatalogueReader> catalogue;
+    try {
 
-            catalogue->visitEntries(visitor, /* *store, */ false);
-        }
+        catalogue = CatalogueReaderFactory::instance().build(uri, dbConfig_);
+    }
+    catch (fdb5::DatabaseNotFoundException& e) {
+        visitor.onDatabaseNotFound(e);
+    }
+
+    ASSERT(catalogue->open());
+
+    eckit::AutoCloser<Catalogue> closer(*catalogue);
+
+    catalogue->visitEntries(visitor, /* *store, */ false);
+}
+
+void EntryVisitMechanism::handleError(std::exception_ptr error) const {
+    try {
+        std::rethrow_exception(error);
     }
     catch (eckit::UserError&) {
         throw;
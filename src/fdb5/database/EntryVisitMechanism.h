@@ -14,6 +14,12 @@
 #ifndef fdb5_EntryVisitMechanism_H
 #define fdb5_EntryVisitMechanism_H
 
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "fdb5/config/Config.h"
 #include "fdb5/database/DatabaseNotFoundException.h"
 #include "fdb5/database/Field.h"
@@ -81,6 +87,11 @@ protected:  // members
 
 class EntryVisitMechanism {
 
+public:  // types
+
+    /// Builds the visitor for the database at the given position in the list being visited
+    using VisitorFactory = std::function<std::unique_ptr<EntryVisitor>(size_t)>;
+
 public:  // methods
 
     EntryVisitMechanism(const Config& config);
@@ -92,6 +103,23 @@ public:  // methods
 
     void visit(const FDBToolRequest& request, EntryVisitor& visitor);
 
+    /// The databases that visit() explores for the request, in the order it explores them
+    std::vector<eckit::URI> locations(const FDBToolRequest& request) const;
+
+    /// Visits the databases in @p uris on up to @p threads threads, so that several catalogues are opened and scanned
+    /// at once. Each database gets its own visitor from @p makeVisitor, which is destroyed before @p done is called
+    /// with the position of the database. Visiting stops at the first error, which is rethrown once the workers have
+    /// finished.
+    void visit(const std::vector<eckit::URI>& uris, size_t threads, const VisitorFactory& makeVisitor,
+               const std::function<void(size_t)>& done);
+
+private:  // methods
+
+    void visitDatabase(const eckit::URI& uri, EntryVisitor& visitor) const;
+
+    /// Rethrows @p error if visiting should fail on it, or logs it otherwise
+    void handleError(std::exception_ptr error) const;
+
 private:  // members
 
     const Config& dbConfig_;
@@ -49,16 +49,39 @@ bool InspectIterator::next(ListElement& elem) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-static void purgeCatalogue(Key& key, CatalogueReader*& db) {
+static void purgeCatalogue(Key& key, std::shared_ptr<InspectorCatalogue>& db) {
     LOG_DEBUG_LIB(LibFdb5) << "Purging DB with key " << key << std::endl;
-    delete db;
+    db.reset();
 }
 
+InspectorCatalogueCache::InspectorCatalogueCache(size_t capacity) : cache_(capacity, &purgeCatalogue) {}
+
+std::shared_ptr<InspectorCatalogue> InspectorCatalogueCache::find(const Key& dbKey) {
+    std::lock_guard lock(mutex_);
+    if (cache_.exists(dbKey)) {
+        return cache_.access(dbKey);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<InspectorCatalogue> InspectorCatalogueCache::insert(const Key& dbKey,
+                                                                    std::unique_ptr<CatalogueReader> catalogue) {
+    std::lock_guard lock(mutex_);
+    if (cache_.exists(dbKey)) {
+        return cache_.access(dbKey);
+    }
+    auto entry = std::make_shared<InspectorCatalogue>();
+    entry->catalogue_ = std::move(catalogue);
+    cache_.insert(dbKey, entry);
+    return entry;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 Inspector::Inspector(const Config& dbConfig) :
-    databases_(Resource<size_t>("fdbMaxOpenDatabases", 16), &purgeCatalogue), dbConfig_(dbConfig) {}
+    databases_(Resource<size_t>("fdbMaxOpenDatabases", 16)), dbConfig_(dbConfig) {}
 
 ListIterator Inspector::inspect(const metkit::mars::MarsRequest& request) const {
-    std::lock_guard lock(mutex_);
 
     auto iterator = std::make_unique<InspectIterator>();
     MultiRetrieveVisitor visitor(*iterator, databases_, dbConfig_);
@@ -23,6 +23,7 @@
 
 #include <cstdlib>
 #include <iosfwd>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -63,6 +64,37 @@ private:
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// An open catalogue in the Inspector cache. Catalogues keep the index selection of their user, so only one inspect()
+/// uses a catalogue at a time, holding its mutex while it is selected.
+struct InspectorCatalogue {
+    std::mutex mutex_;
+    std::unique_ptr<CatalogueReader> catalogue_;
+};
+
+/// LRU cache of open catalogues, shared by concurrent inspect() calls. Entries are reference counted, so a catalogue
+/// evicted while in use is closed once its last user releases it.
+class InspectorCatalogueCache {
+
+public:  // methods
+
+    explicit InspectorCatalogueCache(size_t capacity);
+
+    /// @returns the cached catalogue for @p dbKey, or nullptr
+    std::shared_ptr<InspectorCatalogue> find(const Key& dbKey);
+
+    /// Caches @p catalogue, unless another caller has cached one for the same key meanwhile
+    /// @returns the catalogue now cached for @p dbKey
+    std::shared_ptr<InspectorCatalogue> insert(const Key& dbKey, std::unique_ptr<CatalogueReader> catalogue);
+
+private:  // members
+
+    std::mutex mutex_;
+
+    eckit::CacheLRU<Key, std::shared_ptr<InspectorCatalogue>> cache_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 class Inspector {
 
 public:  // methods
@@ -94,9 +126,7 @@ private:  // methods
 
 private:  // data
 
-    mutable std::mutex mutex_;
-
-    mutable eckit::CacheLRU<Key, CatalogueReader*> databases_;
+    mutable InspectorCatalogueCache databases_;
 
     Config dbConfig_;
 };
@@ -30,6 +30,14 @@
 
 namespace fdb5 {
 
+namespace {
+
+/// First byte of a binary fingerprint. Never the first byte of a colon-separated one, which is printable.
+constexpr char fingerprintMarker = '\x01';
+constexpr size_t fingerprintMaxValueLength = 255;
+
+}  // namespace
+
 //----------------------------------------------------------------------------------------------------------------------
 // KEY
 
@@ -66,6 +74,58 @@ std::string Key::valuesToString() const {
     return oss.str();
 }
 
+void Key::valuesToFingerprint(std::string& out) const {
+
+    /// @note same check as in valuesToString
+    if (names().size() != size()) {
+        std::ostringstream oss;
+        oss << "names and keys size mismatch" << '\n'
+            << "    names: " << names().size() << "  " << names() << '\n'
+            << "    keys:  " << size() << "  " << keyDict() << '\n';
+        throw eckit::SeriousBug(oss.str());
+    }
+
+    size_t length = 1;
+    for (const auto& keyword : names()) {
+        const std::string& value = get(keyword);
+        // lengths are stored off by one, so that the fingerprint never contains a nul byte
+        if (value.size() >= fingerprintMaxValueLength) {
+            std::ostringstream oss;
+            oss << "Value too long to fingerprint: " << keyword << "=" << value;
+            throw eckit::SeriousBug(oss.str(), Here());
+        }
+        length += 1 + value.size();
+    }
+
+    out.clear();
+    out.reserve(length);
+    out.push_back(fingerprintMarker);
+
+    for (const auto& keyword : names()) {
+        const std::string& value = get(keyword);
+        out.push_back(static_cast<char>(value.size() + 1));
+        out.append(value);
+    }
+}
+
+bool Key::fingerprintToValues(const std::string& fingerprint, eckit::StringList& values) {
+
+    if (fingerprint.empty() || fingerprint[0] != fingerprintMarker) {
+        return false;
+    }
+
+    size_t pos = 1;
+    while (pos < fingerprint.size()) {
+        const size_t len = static_cast<unsigned char>(fingerprint[pos]) - 1;
+        ++pos;
+        ASSERT(pos + len <= fingerprint.size());
+        values.emplace_back(fingerprint, pos, len);
+        pos += len;
+    }
+
+    return true;
+}
+
 void Key::validateKeys(const Key& other, bool checkAlsoValues) const {
 
     eckit::StringSet missing;
@@ -184,3 +244,16 @@ Key TypedKey::canonical() const {
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace fdb5
+
+namespace std {
+
+size_t hash<fdb5::Key>::operator()(const fdb5::Key& key) const {
+    // hash the values directly rather than joining them into a string (consistent with Key::operator==)
+    size_t seed = 0;
+    for (const auto& kv : key.keyDict()) {
+        seed ^= std::hash<std::string>()(kv.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+}  // namespace std
@@ -51,6 +51,14 @@ public:  // methods
 
     std::string valuesToString() const;
 
+    /// Writes the values into @p out as a binary fingerprint: a marker byte, then each value prefixed by its length.
+    /// Unlike valuesToString(), this needs no stream and can be split back into values without tokenising. It only
+    /// allocates if @p out lacks the capacity, so a buffer reused across keys is written without allocating.
+    void valuesToFingerprint(std::string& out) const;
+
+    /// If @p fingerprint was produced by valuesToFingerprint(), appends its values to @p values and returns true
+    static bool fingerprintToValues(const std::string& fingerprint, eckit::StringList& values);
+
     /// @throws When "other" doesn't contain all the keys of "this"
     void validateKeys(const Key& other, bool checkAlsoValues = false) const;
 
@@ -101,7 +109,7 @@ namespace std {
 
 template <>
 struct hash<fdb5::Key> {
-    size_t operator()(const fdb5::Key& key) const { return std::hash<std::string>()(key.valuesToString()); }
+    size_t operator()(const fdb5::Key& key) const;
 };
 
 }  // namespace std
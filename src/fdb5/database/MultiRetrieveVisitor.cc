@@ -13,7 +13,9 @@
 #include <memory>
 #include <ostream>
 #include <sstream>
+#include <vector>
 
+#include "eckit/config/Resource.h"
 #include "eckit/log/Log.h"
 
 #include "fdb5/LibFdb5.h"
@@ -26,7 +28,7 @@ namespace fdb5 {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-MultiRetrieveVisitor::MultiRetrieveVisitor(InspectIterator& iterator, eckit::CacheLRU<Key, CatalogueReader*>& databases,
+MultiRetrieveVisitor::MultiRetrieveVisitor(InspectIterator& iterator, InspectorCatalogueCache& databases,
                                            const Config& config) :
     databases_(databases), iterator_(iterator), config_(config) {}
 
@@ -45,13 +47,24 @@ bool MultiRetrieveVisitor::selectDatabase(const Key& dbKey, const Key& /* fullKe
             eckit::Log::info() << "This is the current db" << std::endl;
             return true;
         }
+        retrievePending();
+        releaseCatalogue();
     }
 
     /* is the DB already open ? */
 
-    if (databases_.exists(dbKey)) {
+    if (auto cached = databases_.find(dbKey)) {
         LOG_DEBUG_LIB(LibFdb5) << "FDB5 Reusing database " << dbKey << std::endl;
-        catalogue_ = databases_.access(dbKey);
+        lock_ = std::unique_lock(cached->mutex_);
+        cached_ = std::move(cached);
+        catalogue_ = cached_->catalogue_.get();
+
+        // Pick up the indexes added since the database was opened, rather than serve a stale list
+        static bool fdbRefreshOpenDatabases =
+            eckit::Resource<bool>("fdbRefreshOpenDatabases;$FDB_REFRESH_OPEN_DATABASES", false);
+        if (fdbRefreshOpenDatabases) {
+            catalogue_->refresh();
+        }
         return true;
     }
 
@@ -75,8 +88,11 @@ bool MultiRetrieveVisitor::selectDatabase(const Key& dbKey, const Key& /* fullKe
         return false;
     }
     else {
-        catalogue_ = newCatalogue.release();
-        databases_.insert(dbKey, catalogue_);
+        // another inspect() may have opened the same database meanwhile, in which case we use its catalogue
+        auto cached = databases_.insert(dbKey, std::move(newCatalogue));
+        lock_ = std::unique_lock(cached->mutex_);
+        cached_ = std::move(cached);
+        catalogue_ = cached_->catalogue_.get();
         return true;
     }
 }
@@ -84,6 +100,7 @@ bool MultiRetrieveVisitor::selectDatabase(const Key& dbKey, const Key& /* fullKe
 bool MultiRetrieveVisitor::selectIndex(const Key& idxKey) {
     ASSERT(catalogue_);
     LOG_DEBUG_LIB(LibFdb5) << "selectIndex " << idxKey << std::endl;
+    retrievePending();
     return catalogue_->selectIndex(idxKey);
 }
 
@@ -91,27 +108,65 @@ bool MultiRetrieveVisitor::selectDatum(const Key& datumKey, const Key& fullKey)
     ASSERT(catalogue_);
     LOG_DEBUG_LIB(LibFdb5) << "selectDatum " << datumKey << ", " << fullKey << std::endl;
 
-    Field field;
-    if (catalogue_->retrieve(datumKey, field)) {
+    if (!catalogue_->batchRetrieval()) {
+        Field field;
+        if (catalogue_->retrieve(datumKey, field)) {
+            emplace(datumKey, field);
+            return true;
+        }
+        return false;
+    }
+
+    // Looked up with the other keys of the same index, when the index or database changes. Whether it is found is not
+    // known yet, but the return value is not used when expanding a read request.
+    pending_.push_back(datumKey);
+    return true;
+}
+
+void MultiRetrieveVisitor::emplace(const Key& datumKey, const Field& field) {
 
-        Key simplifiedKey;
-        for (const auto& [keyword, value] : datumKey) {
-            if (!value.empty()) {
-                simplifiedKey.push(keyword, value);
-            }
+    Key simplifiedKey;
+    for (const auto& [keyword, value] : datumKey) {
+        if (!value.empty()) {
+            simplifiedKey.push(keyword, value);
         }
+    }
 
-        iterator_.emplace(
-            {catalogue_->key(), catalogue_->indexKey(), simplifiedKey, field.stableLocation(), field.timestamp()});
-        return true;
+    iterator_.emplace(
+        {catalogue_->key(), catalogue_->indexKey(), simplifiedKey, field.stableLocation(), field.timestamp()});
+}
+
+void MultiRetrieveVisitor::retrievePending() {
+    if (pending_.empty()) {
+        return;
     }
 
-    return false;
+    ASSERT(catalogue_);
+
+    std::vector<Field> fields;
+    const std::vector<bool> found = catalogue_->retrieveBatch(pending_, fields);
+    ASSERT(found.size() == pending_.size());
+
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        if (found[i]) {
+            emplace(pending_[i], fields[i]);
+        }
+    }
+
+    pending_.clear();
 }
 
-void MultiRetrieveVisitor::deselectDatabase() {
+void MultiRetrieveVisitor::releaseCatalogue() {
     catalogue_ = nullptr;
-    return;
+    if (lock_.owns_lock()) {
+        lock_.unlock();
+    }
+    cached_.reset();
+}
+
+void MultiRetrieveVisitor::deselectDatabase() {
+    retrievePending();
+    releaseCatalogue();
 }
 
 void MultiRetrieveVisitor::print(std::ostream& out) const {
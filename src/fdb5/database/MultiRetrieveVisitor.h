@@ -16,9 +16,11 @@
 #ifndef fdb5_MultiRetrieveVisitor_H
 #define fdb5_MultiRetrieveVisitor_H
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
-#include "eckit/container/CacheLRU.h"
 #include "eckit/container/Queue.h"
 
 #include "fdb5/api/helpers/ListIterator.h"
@@ -28,6 +30,7 @@
 
 namespace fdb5 {
 
+class Field;
 class HandleGatherer;
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -36,8 +39,7 @@ class MultiRetrieveVisitor : public ReadVisitor {
 
 public:  // methods
 
-    MultiRetrieveVisitor(InspectIterator& queue, eckit::CacheLRU<Key, CatalogueReader*>& databases,
-                         const Config& config);
+    MultiRetrieveVisitor(InspectIterator& queue, InspectorCatalogueCache& databases, const Config& config);
 
     ~MultiRetrieveVisitor();
 
@@ -57,9 +59,25 @@ private:  // methods
 
     const Schema& databaseSchema() const override;
 
+    /// Looks up the datum keys selected since the index was selected, in one batch (see
+    /// CatalogueReader::retrieveBatch), and queues the fields found in request order
+    void retrievePending();
+
+    /// Queues a field found in the current index
+    void emplace(const Key& datumKey, const Field& field);
+
+    /// Gives the current catalogue back to the cache
+    void releaseCatalogue();
+
 private:
 
-    eckit::CacheLRU<Key, CatalogueReader*>& databases_;
+    InspectorCatalogueCache& databases_;
+
+    /// The cached catalogue in use, locked until it is released
+    std::shared_ptr<InspectorCatalogue> cached_;
+    std::unique_lock<std::mutex> lock_;
+
+    std::vector<Key> pending_;
 
     InspectIterator& iterator_;
 
@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "fdb5/database/PipelinedArchiver.h"
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Store.h"
+
+#include <cstring>
+#include <exception>
+#include <utility>
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PipelinedArchiver::ArchiveElement::ArchiveElement(const Key& key, const void* data, size_t len) :
+    keys_{key}, lengths_{len}, data_(data, len) {}
+
+PipelinedArchiver::ArchiveElement::ArchiveElement(const std::vector<ArchiveItem>& items) : data_(0) {
+
+    size_t total = 0;
+    keys_.reserve(items.size());
+    lengths_.reserve(items.size());
+    for (const auto& item : items) {
+        keys_.push_back(item.key);
+        lengths_.push_back(item.length);
+        total += item.length;
+    }
+
+    data_.resize(total);
+    char* p = static_cast<char*>(data_.data());
+    for (const auto& item : items) {
+        ::memcpy(p, item.data, item.length);
+        p += item.length;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PipelinedArchiver::PipelinedArchiver(const Config& dbConfig, const ArchiveCallback& callback, size_t queueSize) :
+    Archiver(dbConfig, callback), archiveQueue_(queueSize), indexQueue_(queueSize) {
+    ASSERT(queueSize > 0);
+    archiveThread_ = std::thread([this] { archiveWorker(); });
+    indexThread_ = std::thread([this] { indexWorker(); });
+}
+
+PipelinedArchiver::~PipelinedArchiver() {
+
+    try {
+        flush();
+    }
+    catch (const std::exception& e) {
+        eckit::Log::error() << "PipelinedArchiver: error flushing on destruction: " << e.what() << std::endl;
+    }
+
+    archiveQueue_.close();
+    archiveThread_.join();
+
+    indexQueue_.close();
+    indexThread_.join();
+}
+
+void PipelinedArchiver::archive(const Key& key, const void* data, size_t len) {
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rethrowError();
+        ++pendingArchive_;
+    }
+
+    // The caller's buffer may be reused as soon as we return, so the queue owns a copy
+    archiveQueue_.emplace(ArchiveElement(key, data, len));
+}
+
+void PipelinedArchiver::archive(const std::vector<ArchiveItem>& items) {
+
+    if (items.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rethrowError();
+        ++pendingArchive_;
+    }
+
+    archiveQueue_.emplace(ArchiveElement(items));
+}
+
+void PipelinedArchiver::flush() {
+
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return pendingArchive_ == 0; });
+        rethrowError();
+    }
+
+    // Flushing each database waits for its outstanding index insertions (see flushDatabase)
+    Archiver::flush();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrowError();
+}
+
+void PipelinedArchiver::flushDatabase(Database& db) {
+    // The store flush completes any outstanding (possibly asynchronous) location callbacks, which may still be
+    // queued for the index worker
+    size_t archived = db.store_->flush();
+    waitIndexed();
+    db.catalogue_->flush(archived);
+}
+
+void PipelinedArchiver::archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey,
+                                        const Key& datumKey, std::shared_ptr<const FieldLocation> location) {
+
+    if (!catalogue->asyncArchive()) {
+        Archiver::archiveLocation(catalogue, idxKey, datumKey, std::move(location));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pendingIndex_;
+    }
+
+    indexQueue_.emplace(IndexElement{catalogue, idxKey, datumKey, std::move(location)});
+}
+
+void PipelinedArchiver::archiveWorker() {
+
+    ArchiveElement elem;
+    while (archiveQueue_.pop(elem) != -1) {
+        try {
+            if (elem.keys_.size() == 1) {
+                Archiver::archive(elem.keys_.front(), elem.data_.data(), elem.data_.size());
+            }
+            else {
+                std::vector<ArchiveItem> items;
+                items.reserve(elem.keys_.size());
+                const char* p = static_cast<const char*>(elem.data_.data());
+                for (size_t i = 0; i < elem.keys_.size(); ++i) {
+                    items.push_back({elem.keys_[i], p, elem.lengths_[i]});
+                    p += elem.lengths_[i];
+                }
+                Archiver::archive(items);
+            }
+        }
+        catch (...) {
+            error(std::current_exception());
+        }
+        done(pendingArchive_);
+    }
+}
+
+void PipelinedArchiver::indexWorker() {
+
+    IndexElement elem;
+    while (indexQueue_.pop(elem) != -1) {
+        try {
+            Archiver::archiveLocation(elem.catalogue_, elem.idxKey_, elem.datumKey_, std::move(elem.location_));
+        }
+        catch (...) {
+            error(std::current_exception());
+        }
+        elem.catalogue_.reset();
+        done(pendingIndex_);
+    }
+}
+
+void PipelinedArchiver::error(std::exception_ptr e) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!error_) {
+        error_ = e;
+    }
+}
+
+void PipelinedArchiver::rethrowError() {
+    if (error_) {
+        std::exception_ptr e;
+        std::swap(e, error_);
+        std::rethrow_exception(e);
+    }
+}
+
+void PipelinedArchiver::done(size_t& pending) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT(pending > 0);
+    --pending;
+    cv_.notify_all();
+}
+
+void PipelinedArchiver::waitIndexed() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pendingIndex_ == 0; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -0,0 +1,116 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   PipelinedArchiver.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "eckit/container/Queue.h"
+#include "eckit/io/Buffer.h"
+
+#include "fdb5/database/Archiver.h"
+#include "fdb5/database/Key.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Archiver that returns from archive() as soon as the field has been copied into a bounded queue.
+///
+/// Fields are expanded against the schema and appended to the store by one worker thread, and their locations are
+/// inserted into the catalogue indexes by a second worker thread, so that consecutive fields overlap. Catalogues that
+/// cannot accept out-of-order locations (see CatalogueWriter::asyncArchive) are indexed on the first worker.
+///
+/// flush() is the barrier: it returns once every field queued before it is written, indexed and flushed. Errors
+/// raised on the workers are rethrown by the next call to archive() or flush().
+class PipelinedArchiver : public Archiver {
+
+public:  // methods
+
+    PipelinedArchiver(const Config& dbConfig, const ArchiveCallback& callback, size_t queueSize);
+
+    ~PipelinedArchiver() override;
+
+    void archive(const Key& key, const void* data, size_t len) override;
+    void archive(const std::vector<ArchiveItem>& items) override;
+
+    void flush() override;
+
+protected:  // methods
+
+    void flushDatabase(Database& db) override;
+
+    void archiveLocation(const std::shared_ptr<CatalogueWriter>& catalogue, const Key& idxKey, const Key& datumKey,
+                         std::shared_ptr<const FieldLocation> location) override;
+
+private:  // types
+
+    /// One field, or a batch of fields archived together
+    struct ArchiveElement {
+        std::vector<Key> keys_;
+        std::vector<size_t> lengths_;
+        eckit::Buffer data_;  ///< the data of all the fields, back to back
+
+        ArchiveElement() : data_(0) {}
+        ArchiveElement(const Key& key, const void* data, size_t len);
+        explicit ArchiveElement(const std::vector<ArchiveItem>& items);
+    };
+
+    struct IndexElement {
+        std::shared_ptr<CatalogueWriter> catalogue_;
+        Key idxKey_;
+        Key datumKey_;
+        std::shared_ptr<const FieldLocation> location_;
+    };
+
+private:  // methods
+
+    void archiveWorker();
+    void indexWorker();
+
+    /// Records the first failure on a worker thread
+    void error(std::exception_ptr e);
+    void rethrowError();
+
+    /// Marks one element of the stage counted by @p pending as completed
+    void done(size_t& pending);
+
+    /// Waits until all the locations handed to archiveLocation() are in the catalogue
+    void waitIndexed();
+
+private:  // members
+
+    eckit::Queue<ArchiveElement> archiveQueue_;
+    eckit::Queue<IndexElement> indexQueue_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    size_t pendingArchive_{0};  ///< fields queued but not yet expanded and written to the store
+    size_t pendingIndex_{0};    ///< locations queued but not yet inserted into the catalogue
+
+    std::exception_ptr error_;
+
+    std::thread archiveThread_;
+    std::thread indexThread_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -34,6 +34,18 @@ void Store::archiveCb(const Key& key, const void* data, eckit::Length length,
     catalogue_archive(archive(key, data, length));
 }
 
+void Store::archiveBatch(
+    const Key& idxKey, const std::vector<const ArchiveItem*>& fields,
+    std::function<void(size_t, std::unique_ptr<const FieldLocation> fieldLocation)> catalogue_archive) {
+    for (size_t i = 0; i < fields.size(); ++i) {
+        // the callback may be invoked after we return (e.g. remote stores), so it must not refer to this frame
+        archiveCb(idxKey, fields[i]->data, fields[i]->length,
+                  [i, catalogue_archive](std::unique_ptr<const FieldLocation> fieldLocation) {
+                      catalogue_archive(i, std::move(fieldLocation));
+                  });
+    }
+}
+
 std::unique_ptr<const FieldLocation> Store::archive(const Key& /*key*/, const void* /*data*/,
                                                     eckit::Length /*length*/) {
     NOTIMP;
@@ -22,6 +22,7 @@
 
 #include "fdb5/api/helpers/MoveIterator.h"
 #include "fdb5/config/Config.h"
+#include "fdb5/database/ArchiveItem.h"
 #include "fdb5/database/Catalogue.h"
 #include "fdb5/database/Field.h"
 #include "fdb5/database/FieldLocation.h"
@@ -44,6 +45,12 @@ public:
         std::function<void(const std::unique_ptr<const FieldLocation> fieldLocation)> catalogue_archive);
     virtual std::unique_ptr<const FieldLocation> archive(const Key& idxKey, const void* data, eckit::Length length);
 
+    /// Archives the data of several fields of the same index. The callback is invoked once for each field, with
+    /// the position of the field in @p fields. By default, the fields are archived one by one.
+    virtual void archiveBatch(
+        const Key& idxKey, const std::vector<const ArchiveItem*>& fields,
+        std::function<void(size_t, std::unique_ptr<const FieldLocation> fieldLocation)> catalogue_archive);
+
     virtual void remove(const eckit::URI& uri, std::ostream& logAlways, std::ostream& logVerbose,
                         bool doit = true) const = 0;
 
@@ -0,0 +1,153 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+
+#include "eckit/log/Log.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/database/TaskPool.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct TaskPool::Group::State {
+
+    std::mutex mutex_;
+    std::condition_variable changed_;  ///< a task was added, or completed
+
+    std::deque<std::function<void()>> pending_;
+    size_t running_{0};
+
+    std::exception_ptr error_;
+
+    /// Runs the next pending task, if any. Called with mutex_ held through @p lock, which is released while the task
+    /// runs.
+    bool runOne(std::unique_lock<std::mutex>& lock) {
+        if (pending_.empty()) {
+            return false;
+        }
+        std::function<void()> task = std::move(pending_.front());
+        pending_.pop_front();
+        ++running_;
+
+        lock.unlock();
+        std::exception_ptr error;
+        try {
+            task();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error && !error_) {
+            error_ = error;
+        }
+        --running_;
+        changed_.notify_all();
+        return true;
+    }
+};
+
+TaskPool::Group::Group(TaskPool& pool) : pool_(pool), state_(std::make_shared<State>()) {}
+
+TaskPool::Group::~Group() {
+    try {
+        wait();
+    }
+    catch (...) {
+        // The owner of the group did not wait for its errors, e.g. as it is handling another one
+    }
+}
+
+void TaskPool::Group::run(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex_);
+        state_->pending_.push_back(std::move(task));
+    }
+    state_->changed_.notify_all();
+    pool_.submit(state_);
+}
+
+void TaskPool::Group::wait() {
+    std::unique_lock<std::mutex> lock(state_->mutex_);
+    for (;;) {
+        if (state_->runOne(lock)) {
+            continue;
+        }
+        if (state_->running_ == 0) {
+            break;
+        }
+        // The tasks running may add more
+        state_->changed_.wait(lock);
+    }
+
+    if (std::exception_ptr error = std::exchange(state_->error_, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TaskPool::TaskPool(const std::string& name, size_t threads) :
+    name_(name), size_(std::max<size_t>(1, threads)), stopping_(false) {}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void TaskPool::submit(const std::shared_ptr<Group::State>& group) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (threads_.empty()) {
+            LOG_DEBUG_LIB(LibFdb5) << "Starting " << size_ << " threads for " << name_ << std::endl;
+            for (size_t i = 0; i < size_; ++i) {
+                threads_.emplace_back([this] { work(); });
+            }
+        }
+        queue_.push_back(group);
+    }
+    ready_.notify_one();
+}
+
+void TaskPool::work() {
+    for (;;) {
+        std::shared_ptr<Group::State> group;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            group = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        std::unique_lock<std::mutex> lock(group->mutex_);
+        group->runOne(lock);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
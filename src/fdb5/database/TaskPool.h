@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   TaskPool.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A fixed number of threads, started on first use, running the tasks of any number of callers.
+///
+/// A caller submits its tasks through a Group, and waits for them with Group::wait(). While it waits, the caller runs
+/// the tasks of its group that no thread of the pool has taken yet, so a group always completes, even if the pool is
+/// busy with the tasks of other callers, or if the caller is itself a task of the pool.
+class TaskPool {
+
+public:  // types
+
+    class Group {
+
+    public:  // methods
+
+        explicit Group(TaskPool& pool);
+
+        /// Waits for the tasks of the group, ignoring their errors
+        ~Group();
+
+        Group(const Group&) = delete;
+        Group& operator=(const Group&) = delete;
+
+        /// Submits a task. May be called from the tasks of the group.
+        void run(std::function<void()> task);
+
+        /// Waits for all the tasks of the group, then rethrows the first exception thrown by any of them
+        void wait();
+
+    private:  // types
+
+        friend class TaskPool;
+
+        struct State;
+
+    private:  // members
+
+        TaskPool& pool_;
+        std::shared_ptr<State> state_;
+    };
+
+public:  // methods
+
+    TaskPool(const std::string& name, size_t threads);
+
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t size() const { return size_; }
+
+private:  // methods
+
+    void submit(const std::shared_ptr<Group::State>& group);
+
+    void work();
+
+private:  // members
+
+    std::string name_;
+    size_t size_;
+
+    std::mutex mutex_;
+    std::condition_variable ready_;
+
+    /// The group of each task submitted, in order. A group may have run the task itself by the time a thread gets to
+    /// it, in which case the thread moves on.
+    std::deque<std::shared_ptr<Group::State>> queue_;
+    bool stopping_;
+
+    std::vector<std::thread> threads_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -17,7 +17,6 @@
 #define fdb5_WriteVisitor_H
 
 #include <iosfwd>
-#include <vector>
 
 #include "fdb5/database/Key.h"
 
@@ -37,7 +36,7 @@ class WriteVisitor {
 
 public:  // methods
 
-    WriteVisitor(std::vector<Key>&);
+    WriteVisitor() = default;
 
     WriteVisitor(const WriteVisitor&) = delete;
     WriteVisitor& operator=(const WriteVisitor&) = delete;
@@ -68,10 +67,6 @@ private:  // members
         return s;
     }
 
-    friend class Rule;
-
-    std::vector<Key>& prev_;
-
     const Rule* rule_{nullptr};  // Last rule used
 };
 
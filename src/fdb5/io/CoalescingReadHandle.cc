@@ -0,0 +1,383 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include <tuple>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/database/FieldLocation.h"
+#include "fdb5/database/TaskPool.h"
+#include "fdb5/io/CoalescingReadHandle.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+#ifdef IOV_MAX
+const size_t maxIovecs = IOV_MAX;
+#else
+const size_t maxIovecs = 1024;
+#endif
+
+/// One field to read, into dest_
+struct Extent {
+    size_t file_;
+    off_t offset_;
+    size_t length_;
+    char* dest_;
+};
+
+/// Consecutive extents of one file, read with a single preadv
+struct Run {
+    size_t file_;
+    off_t offset_;
+    std::vector<Extent> extents_;
+};
+
+void preadvAll(int fd, std::vector<struct iovec>& iov, off_t offset, const eckit::PathName& path) {
+    size_t first = 0;
+    while (first < iov.size()) {
+        size_t count = std::min(iov.size() - first, maxIovecs);
+        ssize_t n;
+        SYSCALL2(n = ::preadv(fd, iov.data() + first, count, offset), path);
+        if (n == 0) {
+            throw eckit::ReadError("Unexpected end of file reading " + std::string(path), Here());
+        }
+        offset += n;
+
+        // Skip over the buffers that have been filled, and trim a partially filled one
+        size_t left = n;
+        while (first < iov.size() && iov[first].iov_len <= left) {
+            left -= iov[first].iov_len;
+            ++first;
+        }
+        if (left > 0) {
+            iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+            iov[first].iov_len -= left;
+        }
+    }
+}
+
+void readRun(const Run& run, int fd, const eckit::PathName& path, std::vector<char>& scratch) {
+    std::vector<struct iovec> iov;
+    iov.reserve(2 * run.extents_.size());
+
+    // The bytes between fields are read into the scratch buffer, and discarded
+    off_t pos = run.offset_;
+    for (const Extent& e : run.extents_) {
+        if (e.offset_ > pos) {
+            size_t gap = e.offset_ - pos;
+            if (scratch.size() < gap) {
+                scratch.resize(gap);
+            }
+            iov.push_back({scratch.data(), gap});
+        }
+        iov.push_back({e.dest_, e.length_});
+        pos = e.offset_ + e.length_;
+    }
+
+    preadvAll(fd, iov, run.offset_, path);
+}
+
+void readHandle(eckit::DataHandle& handle, char* buffer, size_t length) {
+    handle.openForRead();
+    eckit::AutoClose closer(handle);
+
+    while (length > 0) {
+        long n = handle.read(buffer, length);
+        if (n <= 0) {
+            std::ostringstream ss;
+            ss << "Unexpected end of data reading " << handle;
+            throw eckit::ReadError(ss.str(), Here());
+        }
+        buffer += n;
+        length -= n;
+    }
+}
+
+/// The threads reading for all the handles of the process
+TaskPool& readPool() {
+    static const long threads = std::max(1L, eckit::Resource<long>("fdbReadThreads;$FDB_READ_THREADS", 1));
+    // Leaked deliberately, so that the threads are not joined during static deinitialisation
+    static TaskPool& pool = *new TaskPool("coalesced reads", threads);
+    return pool;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CoalescingReadHandle::CoalescingReadHandle(bool sorted) :
+    totalSize_(0),
+    bufferPos_(0),
+    nextField_(0),
+    sorted_(sorted),
+    maxGap_(eckit::Resource<long>("fdbReadCoalesceGap;$FDB_READ_COALESCE_GAP", 64 * 1024)),
+    windowSize_(eckit::Resource<long>("fdbReadWindowSize;$FDB_READ_WINDOW_SIZE", 64 * 1024 * 1024)),
+    maxOpenFiles_(std::max(1L, eckit::Resource<long>("fdbReadMaxOpenFiles;$FDB_READ_MAX_OPEN_FILES", 64))),
+    openFiles_(0) {}
+
+CoalescingReadHandle::~CoalescingReadHandle() {
+    closeFiles();
+}
+
+void CoalescingReadHandle::add(const FieldLocation& location) {
+
+    Field field;
+    field.offset_ = location.offset();
+    field.length_ = location.length();
+
+    // Fields that are plain byte ranges of local files are read directly. Anything else goes through its own handle.
+    if (location.uri().scheme() == "file" && location.remapKey().empty()) {
+        std::string path = location.uri().path();
+        auto it = fileIds_.find(path);
+        if (it == fileIds_.end()) {
+            it = fileIds_.emplace(path, paths_.size()).first;
+            paths_.emplace_back(path);
+            fds_.push_back(-1);
+        }
+        field.file_ = it->second;
+    }
+    else {
+        field.file_ = npos;
+        field.handle_.reset(location.dataHandle());
+    }
+
+    totalSize_ += field.length_;
+    fields_.emplace_back(std::move(field));
+}
+
+void CoalescingReadHandle::openFiles(const std::vector<size_t>& files) {
+
+    ASSERT(files.size() <= maxOpenFiles_);
+
+    // Make room, keeping the files still needed open
+    if (openFiles_ + files.size() > maxOpenFiles_) {
+        std::vector<char> needed(paths_.size(), 0);
+        for (size_t file : files) {
+            needed[file] = 1;
+        }
+        for (size_t file = 0; file < fds_.size() && openFiles_ + files.size() > maxOpenFiles_; ++file) {
+            if (fds_[file] >= 0 && !needed[file]) {
+                ::close(fds_[file]);
+                fds_[file] = -1;
+                --openFiles_;
+            }
+        }
+    }
+
+    for (size_t file : files) {
+        if (fds_[file] < 0) {
+            SYSCALL2(fds_[file] = ::open(paths_[file].localPath(), O_RDONLY), paths_[file]);
+            ++openFiles_;
+        }
+    }
+}
+
+void CoalescingReadHandle::closeFiles() {
+    for (int& fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    openFiles_ = 0;
+}
+
+void CoalescingReadHandle::loadWindow() {
+
+    // The window holds as many whole fields as fit in windowSize_, and at least one
+
+    size_t end = nextField_;
+    size_t size = 0;
+    while (end < fields_.size() && (end == nextField_ || size + fields_[end].length_ <= windowSize_)) {
+        size += fields_[end].length_;
+        ++end;
+    }
+
+    buffer_.resize(size);
+    bufferPos_ = 0;
+
+    std::vector<char*> destinations;
+    destinations.reserve(end - nextField_);
+    size_t slot = 0;
+    for (size_t i = nextField_; i < end; ++i) {
+        destinations.push_back(buffer_.data() + slot);
+        slot += fields_[i].length_;
+    }
+
+    size_t begin = nextField_;
+    nextField_ = end;
+
+    readFields(begin, end, destinations.data());
+}
+
+void CoalescingReadHandle::readInto(char* const* destinations) {
+    readFields(0, fields_.size(), destinations);
+}
+
+void CoalescingReadHandle::readFields(size_t begin, size_t end, char* const* destinations) {
+
+    std::vector<Extent> extents;
+    for (size_t i = begin; i < end; ++i) {
+        Field& f = fields_[i];
+        char* dest = destinations[i - begin];
+        if (f.file_ == npos) {
+            readHandle(*f.handle_, dest, f.length_);
+        }
+        else if (f.length_ > 0) {
+            extents.push_back({f.file_, f.offset_, f.length_, dest});
+        }
+    }
+
+    std::sort(extents.begin(), extents.end(), [](const Extent& a, const Extent& b) {
+        return std::tie(a.file_, a.offset_) < std::tie(b.file_, b.offset_);
+    });
+
+    // Merge fields of the same file separated by at most maxGap_ bytes. Overlapping fields are not merged.
+
+    std::vector<Run> runs;
+    off_t runEnd = 0;
+    for (const Extent& e : extents) {
+        bool merge = !runs.empty() && runs.back().file_ == e.file_ && e.offset_ >= runEnd &&
+                     size_t(e.offset_ - runEnd) <= maxGap_ && 2 * (runs.back().extents_.size() + 1) <= maxIovecs;
+        if (!merge) {
+            runs.push_back({e.file_, e.offset_, {}});
+        }
+        runs.back().extents_.push_back(e);
+        runEnd = e.offset_ + e.length_;
+    }
+
+    LOG_DEBUG_LIB(LibFdb5) << "CoalescingReadHandle: reading " << extents.size() << " of " << (end - begin)
+                           << " fields in " << runs.size() << " reads" << std::endl;
+
+    // The runs are sorted by file, and read in batches using at most maxOpenFiles_ files
+    TaskPool& pool = readPool();
+
+    size_t first = 0;
+    while (first < runs.size()) {
+
+        std::vector<size_t> files;
+        size_t last = first;
+        while (last < runs.size()) {
+            if (files.empty() || files.back() != runs[last].file_) {
+                if (files.size() == maxOpenFiles_) {
+                    break;
+                }
+                files.push_back(runs[last].file_);
+            }
+            ++last;
+        }
+
+        openFiles(files);
+
+        const size_t ntasks = std::min(pool.size(), last - first);
+        if (ntasks <= 1) {
+            std::vector<char> scratch;
+            for (size_t i = first; i < last; ++i) {
+                readRun(runs[i], fds_[runs[i].file_], paths_[runs[i].file_], scratch);
+            }
+        }
+        else {
+            // The group waits for all the tasks before rethrowing, as they write into the destinations
+            TaskPool::Group group(pool);
+            for (size_t t = 0; t < ntasks; ++t) {
+                group.run([this, &runs, t, first, last, ntasks] {
+                    std::vector<char> scratch;
+                    for (size_t i = first + t; i < last; i += ntasks) {
+                        readRun(runs[i], fds_[runs[i].file_], paths_[runs[i].file_], scratch);
+                    }
+                });
+            }
+            group.wait();
+        }
+
+        first = last;
+    }
+}
+
+eckit::Length CoalescingReadHandle::openForRead() {
+    if (sorted_) {
+        std::stable_sort(fields_.begin(), fields_.end(), [](const Field& a, const Field& b) {
+            return std::tie(a.file_, a.offset_) < std::tie(b.file_, b.offset_);
+        });
+    }
+    rewind();
+    return totalSize_;
+}
+
+long CoalescingReadHandle::read(void* buffer, long length) {
+
+    char* p = static_cast<char*>(buffer);
+    long total = 0;
+
+    while (length > 0) {
+        if (bufferPos_ == buffer_.size()) {
+            if (nextField_ == fields_.size()) {
+                break;
+            }
+            loadWindow();
+            continue;
+        }
+
+        size_t n = std::min(size_t(length), buffer_.size() - bufferPos_);
+        ::memcpy(p, buffer_.data() + bufferPos_, n);
+        bufferPos_ += n;
+        p += n;
+        total += n;
+        length -= n;
+    }
+
+    return total;
+}
+
+void CoalescingReadHandle::close() {
+    closeFiles();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+}
+
+void CoalescingReadHandle::rewind() {
+    buffer_.clear();
+    bufferPos_ = 0;
+    nextField_ = 0;
+}
+
+void CoalescingReadHandle::print(std::ostream& s) const {
+    s << "CoalescingReadHandle[fields=" << fields_.size() << ",files=" << paths_.size() << ",size=" << totalSize_
+      << "]";
+}
+
+eckit::Length CoalescingReadHandle::size() {
+    return totalSize_;
+}
+
+eckit::Length CoalescingReadHandle::estimate() {
+    return totalSize_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
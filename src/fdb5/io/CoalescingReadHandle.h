@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   CoalescingReadHandle.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/DataHandle.h"
+
+namespace fdb5 {
+
+class FieldLocation;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// DataHandle returning the data of a list of fields, in the order they are added, that reads them in batches.
+///
+/// The fields are read one window at a time. Within a window, the fields stored in local files are sorted by file and
+/// offset, and neighbouring fields separated by at most a configurable gap are read with a single preadv(2). These
+/// reads are spread over a pool of threads shared by all the handles, and use at most a configurable number of open
+/// files at a time. Fields in other stores, and fields that need to be transformed when read, are read through their
+/// own DataHandle.
+class CoalescingReadHandle : public eckit::DataHandle {
+
+public:  // methods
+
+    /// If @p sorted, the fields are returned in the order they are stored rather than in the order they are added
+    explicit CoalescingReadHandle(bool sorted = false);
+
+    ~CoalescingReadHandle() override;
+
+    /// Adds a field to be returned after the fields already added
+    void add(const FieldLocation& location);
+
+    /// Reads every field added, in one batch, directly into destinations[i] for the i-th field. Each destination must
+    /// hold at least the length of its field. This does not use, or move, the read position of the handle.
+    void readInto(char* const* destinations);
+
+    // From DataHandle
+
+    eckit::Length openForRead() override;
+
+    long read(void*, long) override;
+    void close() override;
+    void rewind() override;
+    void print(std::ostream&) const override;
+
+    eckit::Length size() override;
+    eckit::Length estimate() override;
+
+private:  // types
+
+    struct Field {
+        size_t file_;  ///< index in paths_, or npos if read through handle_
+        off_t offset_;
+        size_t length_;
+        std::unique_ptr<eckit::DataHandle> handle_;
+    };
+
+    static constexpr size_t npos = size_t(-1);
+
+private:  // methods
+
+    /// Reads the next window of fields into the buffer
+    void loadWindow();
+
+    /// Reads the fields [begin, end) into destinations[0 .. end - begin)
+    void readFields(size_t begin, size_t end, char* const* destinations);
+
+    /// Opens @p files, closing other files if needed to keep at most maxOpenFiles_ open
+    void openFiles(const std::vector<size_t>& files);
+    void closeFiles();
+
+private:  // members
+
+    std::vector<Field> fields_;
+
+    std::vector<eckit::PathName> paths_;
+    std::map<std::string, size_t> fileIds_;
+    std::vector<int> fds_;  ///< by index in paths_, -1 if closed
+
+    eckit::Length totalSize_;
+
+    std::vector<char> buffer_;
+    size_t bufferPos_;
+    size_t nextField_;  ///< first field not yet loaded into the buffer
+
+    bool sorted_;
+
+    size_t maxGap_;
+    size_t windowSize_;
+    size_t maxOpenFiles_;
+    size_t openFiles_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
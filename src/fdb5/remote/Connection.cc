@@ -4,18 +4,46 @@
 #include "fdb5/remote/Messages.h"
 
 #include "eckit/io/Buffer.h"
+#include "eckit/io/ResizableBuffer.h"
+#include "eckit/log/Bytes.h"
 #include "eckit/log/Log.h"
+#include "eckit/utils/Compressor.h"
+#include "eckit/utils/Literals.h"
 
 #include <cstdint>
+#include <cstring>
 #include <mutex>
 #include <string_view>
 
+using namespace eckit::literals;
+
 namespace fdb5::remote {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Follows the compressed payload of a Compressed frame
+struct CompressedTrailer {
+    uint32_t message;  ///< the Message of the original frame
+    uint32_t length;   ///< the payload size of the original frame
+};
+
+/// Smaller frames are not worth compressing
+const uint32_t minCompressedLength = 1_KiB;
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 Connection::Connection() : single_(false) {}
 
+Connection::~Connection() {
+    if (compressor_) {
+        printCompressionStatistics(eckit::Log::info());
+    }
+}
+
 void Connection::teardown() {
     if (closingSocket_.exchange(true)) {
         return;
@@ -80,21 +108,146 @@ bool Connection::readUnsafe(const eckit::net::TCPSocket& socket, void* data, siz
     return true;
 }
 
+void Connection::writeUnsafe(bool control, const void* data, size_t length) const {
+    if (!usesSharedMemory(control)) {
+        writeUnsafe(getSocket(control), data, length);
+        return;
+    }
+    if (!sharedMemory_->write(data, length)) {
+        isValid_ = false;
+        std::ostringstream ss;
+        ss << "Write error. Shared memory channel " << sharedMemory_->name()
+           << (sharedMemory_->broken() ? " broken" : " closed");
+        throw TCPException(ss.str(), Here());
+    }
+}
+
+bool Connection::readUnsafe(bool control, void* data, size_t length) const {
+    if (!usesSharedMemory(control)) {
+        return readUnsafe(getSocket(control), data, length);
+    }
+    if (!sharedMemory_->read(data, length)) {
+        isValid_ = false;
+        if (closingSocket_ && !sharedMemory_->broken()) {
+            return false;
+        }
+        std::ostringstream ss;
+        ss << "Read error. Shared memory channel " << sharedMemory_->name()
+           << (sharedMemory_->broken() ? " broken" : " closed");
+        throw TCPException(ss.str(), Here());
+    }
+    return true;
+}
+
+void Connection::useSharedMemory(std::unique_ptr<SharedMemoryChannel> channel) {
+    ASSERT(channel);
+    ASSERT(!single_);
+    // n.b. TCPSocket::socket() is not const
+    channel->watch(const_cast<eckit::net::TCPSocket&>(dataSocket()).socket());
+    sharedMemory_ = std::move(channel);
+    LOG_DEBUG_LIB(LibFdb5) << "Data connection using shared memory channel " << sharedMemory_->name() << std::endl;
+}
+
+void Connection::useCompression(const std::string& compressor) {
+    ASSERT(eckit::CompressorFactory::instance().has(compressor));
+    compressor_.reset(eckit::CompressorFactory::instance().build(compressor));
+    compressorName_ = compressor;
+    LOG_DEBUG_LIB(LibFdb5) << "Connection compressing data frames with " << compressorName_ << std::endl;
+}
+
+void Connection::printCompressionStatistics(std::ostream& out) const {
+    auto print = [&out](const char* direction, const CompressionStatistics& stats) {
+        out << direction << " " << stats.frames << " compressed frames, " << eckit::Bytes(stats.rawBytes) << " in "
+            << eckit::Bytes(stats.wireBytes);
+        if (stats.wireBytes > 0) {
+            out << " (ratio " << double(stats.rawBytes) / double(stats.wireBytes) << ")";
+        }
+        out << ", " << stats.skipped << " frames left uncompressed";
+    };
+    out << "Compression " << compressorName_ << ": ";
+    print("sent", compressionSent_);
+    out << "; ";
+    print("received", compressionReceived_);
+    out << std::endl;
+}
+
+bool Connection::writeCompressed(Message msg, bool control, uint32_t clientID, uint32_t requestID,
+                                 const PayloadList& payloads, uint32_t payloadLength) const {
+
+    // Each frame is compressed on its own, so that the frames can be read as they come
+    eckit::Buffer raw(payloadLength);
+    size_t pos = 0;
+    for (const auto& payload : payloads) {
+        ::memcpy(static_cast<char*>(raw.data()) + pos, payload.data, payload.length);
+        pos += payload.length;
+    }
+
+    eckit::ResizableBuffer compressed(payloadLength);
+    const size_t length = compressor_->compress(raw, payloadLength, compressed);
+
+    if (length + sizeof(CompressedTrailer) >= payloadLength) {
+        compressionSent_.skipped++;
+        return false;
+    }
+
+    CompressedTrailer trailer{static_cast<uint32_t>(msg), payloadLength};
+    write(Message::Compressed, control, clientID, requestID,
+          {{length, compressed.data()}, {sizeof(trailer), &trailer}});
+
+    compressionSent_.frames++;
+    compressionSent_.rawBytes += payloadLength;
+    compressionSent_.wireBytes += length + sizeof(trailer);
+    return true;
+}
+
+eckit::Buffer Connection::uncompress(MessageHeader& hdr, const eckit::Buffer& payload) const {
+
+    if (!compressor_) {
+        throw TCPException("Received a compressed frame, but no compression was agreed for the connection", Here());
+    }
+
+    ASSERT(hdr.payloadSize >= sizeof(CompressedTrailer));
+    const size_t length = hdr.payloadSize - sizeof(CompressedTrailer);
+
+    CompressedTrailer trailer;
+    ::memcpy(&trailer, static_cast<const char*>(payload.data()) + length, sizeof(trailer));
+
+    const auto original = static_cast<Message>(trailer.message);
+    ASSERT(original == Message::Blob || original == Message::MultiBlob);
+
+    eckit::ResizableBuffer raw(trailer.length);
+    compressor_->uncompress(payload, length, raw, trailer.length);
+
+    eckit::Buffer result(trailer.length);
+    ::memcpy(result.data(), raw.data(), trailer.length);
+
+    compressionReceived_.frames++;
+    compressionReceived_.rawBytes += trailer.length;
+    compressionReceived_.wireBytes += hdr.payloadSize;
+
+    // Hand the frame on as if it had been sent uncompressed
+    hdr.message = original;
+    hdr.payloadSize = trailer.length;
+    return result;
+}
+
 eckit::Buffer Connection::read(bool control, MessageHeader& hdr) const {
-    const auto& socket = getSocket(control);
     eckit::FixedString<4> tail;
     hdr.payloadSize = 0;
-    if (readUnsafe(socket, &hdr, sizeof(hdr))) {
+    if (readUnsafe(control, &hdr, sizeof(hdr))) {
         ASSERT(hdr.marker == MessageHeader::StartMarker);
         ASSERT(hdr.version == MessageHeader::currentVersion);
         ASSERT(single_ || hdr.control() == control);
 
         eckit::Buffer payload{hdr.payloadSize};
-        if ((hdr.payloadSize == 0 || readUnsafe(socket, payload, hdr.payloadSize))
+        if ((hdr.payloadSize == 0 || readUnsafe(control, payload, hdr.payloadSize))
             // Ensure we have consumed exactly the correct amount from the socket.
-            && readUnsafe(socket, &tail, sizeof(tail))) {
+            && readUnsafe(control, &tail, sizeof(tail))) {
 
             ASSERT(tail == MessageHeader::EndMarker);
+            if (hdr.message == Message::Compressed) {
+                return uncompress(hdr, payload);
+            }
             return payload;
         }
     }
@@ -112,6 +265,13 @@ void Connection::write(const Message msg, const bool control, const uint32_t cli
         payloadLength += payload.length;
     }
 
+    if (compressor_ && (msg == Message::Blob || msg == Message::MultiBlob) && !usesSharedMemory(control) &&
+        payloadLength >= minCompressedLength) {
+        if (writeCompressed(msg, control, clientID, requestID, payloads, payloadLength)) {
+            return;
+        }
+    }
+
     MessageHeader message{msg, control, clientID, requestID, payloadLength};
 
     const auto& socket = getSocket(control);
@@ -123,13 +283,13 @@ void Connection::write(const Message msg, const bool control, const uint32_t cli
                            << ",payloadLength=" << payloadLength << "]" << std::endl;
 
 
-    writeUnsafe(socket, &message, sizeof(message));
+    writeUnsafe(control, &message, sizeof(message));
 
     for (const auto& payload : payloads) {
-        writeUnsafe(socket, payload.data, payload.length);
+        writeUnsafe(control, payload.data, payload.length);
     }
 
-    writeUnsafe(socket, &MessageHeader::EndMarker, MessageHeader::markerBytes);
+    writeUnsafe(control, &MessageHeader::EndMarker, MessageHeader::markerBytes);
 }
 
 void Connection::error(std::string_view msg, uint32_t clientID, uint32_t requestID) const {
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "fdb5/remote/Messages.h"
+#include "fdb5/remote/SharedMemoryChannel.h"
 
 #include "eckit/exception/Exceptions.h"
 #include "eckit/net/TCPSocket.h"
@@ -21,13 +22,16 @@
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <string_view>
 #include <vector>
 
 namespace eckit {
 
 class Buffer;
+class Compressor;
 class Value;
 
 }  // namespace eckit
@@ -56,6 +60,13 @@ public:  // types
 
     using PayloadList = std::vector<Payload>;
 
+    struct CompressionStatistics {
+        std::atomic<uint64_t> frames{0};     ///< frames compressed
+        std::atomic<uint64_t> skipped{0};    ///< frames left uncompressed, as compression did not make them smaller
+        std::atomic<uint64_t> rawBytes{0};   ///< payload bytes of the frames, before compression
+        std::atomic<uint64_t> wireBytes{0};  ///< payload bytes of the frames, as sent
+    };
+
 public:  // methods
 
     Connection();
@@ -65,7 +76,7 @@ public:  // methods
     Connection(Connection&&) = delete;
     Connection& operator=(Connection&&) = delete;
 
-    virtual ~Connection() = default;
+    virtual ~Connection();
 
     void write(Message msg, bool control, uint32_t clientID, uint32_t requestID, PayloadList payloads = {}) const;
 
@@ -84,10 +95,37 @@ public:  // methods
 
     bool valid() const { return isValid_; }
 
+    const CompressionStatistics& compressionSent() const { return compressionSent_; }
+    const CompressionStatistics& compressionReceived() const { return compressionReceived_; }
+
+    void printCompressionStatistics(std::ostream& out) const;
+
+protected:  // methods
+
+    /// From now on, the data messages go through @p channel rather than the data socket. Must be called before any
+    /// thread reads or writes data messages.
+    void useSharedMemory(std::unique_ptr<SharedMemoryChannel> channel);
+
+    /// From now on, the Blob and MultiBlob frames are sent compressed with @p compressor, a name known to
+    /// eckit::CompressorFactory. Both sides must agree on it before any such frame is sent.
+    void useCompression(const std::string& compressor);
+
 private:  // methods
 
+    bool usesSharedMemory(bool control) const { return sharedMemory_ && !control && !single_; }
+
+    void writeUnsafe(bool control, const void* data, size_t length) const;
+
+    bool readUnsafe(bool control, void* data, size_t length) const;
+
     eckit::Buffer read(bool control, MessageHeader& hdr) const;
 
+    /// Sends the payloads as a Compressed frame. Returns false, without sending, if that does not save space.
+    bool writeCompressed(Message msg, bool control, uint32_t clientID, uint32_t requestID, const PayloadList& payloads,
+                         uint32_t payloadLength) const;
+
+    eckit::Buffer uncompress(MessageHeader& hdr, const eckit::Buffer& payload) const;
+
     void writeUnsafe(const eckit::net::TCPSocket& socket, const void* data, size_t length) const;
 
     bool readUnsafe(const eckit::net::TCPSocket& socket, void* data, size_t length) const;
@@ -114,6 +152,14 @@ private:  // members
     /// Indicates if this instance is in a usable state.
     /// Once this is marked as invalid it cannot be recovered.
     mutable std::atomic<bool> isValid_{true};
+
+    std::unique_ptr<SharedMemoryChannel> sharedMemory_;
+
+    std::string compressorName_;
+    std::unique_ptr<eckit::Compressor> compressor_;
+
+    mutable CompressionStatistics compressionSent_;
+    mutable CompressionStatistics compressionReceived_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -27,6 +27,7 @@
 #include "fdb5/remote/server/AvailablePortList.h"
 #include "fdb5/remote/server/CatalogueHandler.h"
 #include "fdb5/remote/server/StoreHandler.h"
+#include "fdb5/remote/server/WorkScheduler.h"
 
 using namespace eckit;
 
@@ -129,7 +130,7 @@ void FdbServerBase::doRun() {
     startPortReaperThread(config);
 
     int port = config.getInt("serverPort", 7654);
-    bool threaded = config.getBool("serverThreaded", false);
+    bool threaded = FdbServerBase::threaded(config);
 
     net::TCPServer server(net::Port("fdb", port), net::SocketOptions::server().reusePort(true));
     server.closeExec(false);
@@ -154,6 +155,24 @@ void FdbServerBase::doRun() {
     }
 }
 
+bool FdbServerBase::threaded(const Config& config) {
+
+    if (WorkScheduler::instance().slots() == 0) {
+        return config.getBool("serverThreaded", false);
+    }
+
+    if (config.has("serverThreaded") && !config.getBool("serverThreaded")) {
+        std::ostringstream ss;
+        ss << "FDB_SERVER_WORKERS=" << WorkScheduler::instance().slots()
+           << " shares work slots between the connections of one process, and requires serverThreaded";
+        throw UserError(ss.str(), Here());
+    }
+
+    eckit::Log::info() << "FDB serving connections in threads, sharing " << WorkScheduler::instance().slots()
+                       << " work slots" << std::endl;
+    return true;
+}
+
 void FdbServerBase::startPortReaperThread(const Config& config) {
 
     if (config.has("dataPortStart")) {
@@ -59,6 +59,10 @@ public:
 
     virtual void doRun();
 
+    /// Whether connections are served by threads of this process rather than by forked processes. The work slots of
+    /// FDB_SERVER_WORKERS are shared by the connections of one process, so they require a threaded server.
+    static bool threaded(const Config& config);
+
 private:
 
     int port_;
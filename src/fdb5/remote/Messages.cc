@@ -123,6 +123,9 @@ std::ostream& operator<<(std::ostream& s, const Message& m) {
         case Message::MultiBlob:
             s << "MultiBlob";
             break;
+        case Message::Compressed:
+            s << "Compressed";
+            break;
     }
     s << "(" << ((int)m) << ")";
     return s;
@@ -81,7 +81,8 @@ enum class Message : uint16_t {
 
     // Data communication
     Blob = 300,
-    MultiBlob
+    MultiBlob,
+    Compressed  ///< a Blob or MultiBlob, compressed with the compressor agreed for the connection
 };
 
 std::ostream& operator<<(std::ostream& s, const Message& m);
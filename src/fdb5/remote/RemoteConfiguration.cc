@@ -5,6 +5,7 @@
 #include "eckit/config/Configuration.h"
 #include "eckit/log/Log.h"
 #include "eckit/serialisation/Stream.h"
+#include "eckit/utils/Compressor.h"
 #include "eckit/value/Value.h"
 
 #include "fdb5/LibFdb5.h"
@@ -48,6 +49,10 @@ RemoteConfiguration::RemoteConfiguration(const eckit::Configuration& config) {
     else {
         preferSingleConnection_ = std::nullopt;
     }
+
+    pipelinedReads_ = config.getBool("pipelinedReads", true);
+    multiBlobArchive_ = config.getBool("multiBlobArchive", true);
+    compressionAllowed_ = config.getBool("compression", true);
 }
 
 RemoteConfiguration::RemoteConfiguration(eckit::Stream& s) {
@@ -91,6 +96,31 @@ RemoteConfiguration::RemoteConfiguration(eckit::Stream& s) {
     else {
         preferSingleConnection_ = std::nullopt;
     }
+
+    // peers that predate pipelined reads do not send the value
+    if (v.contains("PipelinedReads")) {
+        eckit::Value pr = v["PipelinedReads"];
+        ASSERT(pr.isBool());
+        pipelinedReads_ = pr;
+    }
+
+    if (v.contains("MultiBlobArchive")) {
+        eckit::Value mba = v["MultiBlobArchive"];
+        ASSERT(mba.isBool());
+        multiBlobArchive_ = mba;
+    }
+
+    if (v.contains("SharedMemory")) {
+        eckit::Value shm = v["SharedMemory"];
+        ASSERT(shm.isString());
+        sharedMemory_ = std::string(shm);
+    }
+
+    if (v.contains("Compression")) {
+        eckit::Value c = v["Compression"];
+        ASSERT(c.isString());
+        compression_ = std::string(c);
+    }
 }
 
 bool RemoteConfiguration::singleConnection() const {
@@ -104,6 +134,14 @@ eckit::Stream& operator<<(eckit::Stream& s, const RemoteConfiguration& r) {
     if (r.preferSingleConnection_) {
         val["PreferSingleConnection"] = eckit::toValue(r.preferSingleConnection_.value());
     }
+    val["PipelinedReads"] = eckit::toValue(r.pipelinedReads_);
+    val["MultiBlobArchive"] = eckit::toValue(r.multiBlobArchive_);
+    if (!r.sharedMemory_.empty()) {
+        val["SharedMemory"] = eckit::toValue(r.sharedMemory_);
+    }
+    if (!r.compression_.empty()) {
+        val["Compression"] = eckit::toValue(r.compression_);
+    }
     s << val;
     return s;
 }
@@ -163,6 +201,22 @@ RemoteConfiguration RemoteConfiguration::common(RemoteConfiguration& clientConf,
     agreedConf.numberOfConnections_ = {ncSelected};
     agreedConf.singleConnection_ = (ncSelected == 1);
 
+    agreedConf.pipelinedReads_ = clientConf.pipelinedReads_ && serverConf.pipelinedReads_;
+    LOG_DEBUG_LIB(LibFdb5) << "Protocol negotiation - PipelinedReads " << agreedConf.pipelinedReads_ << std::endl;
+
+    agreedConf.multiBlobArchive_ = clientConf.multiBlobArchive_ && serverConf.multiBlobArchive_;
+    LOG_DEBUG_LIB(LibFdb5) << "Protocol negotiation - MultiBlobArchive " << agreedConf.multiBlobArchive_ << std::endl;
+
+    // The server accepts the segment only once it has managed to open it
+    agreedConf.sharedMemory_ = agreedConf.singleConnection_ ? "" : clientConf.sharedMemory_;
+
+    // The server accepts the compressor only if it allows compression, and has the compressor too
+    if (!clientConf.compression_.empty() && serverConf.compressionAllowed_ &&
+        eckit::CompressorFactory::instance().has(clientConf.compression_)) {
+        agreedConf.compression_ = clientConf.compression_;
+    }
+    LOG_DEBUG_LIB(LibFdb5) << "Protocol negotiation - Compression " << agreedConf.compression_ << std::endl;
+
     return agreedConf;
 }
 
@@ -57,6 +57,20 @@ public:
 
     bool singleConnection() const;
 
+    /// Read requests are sent without waiting for an acknowledgement, and are served concurrently
+    bool pipelinedReads() const { return pipelinedReads_; }
+
+    /// Archived fields may be batched into MultiBlob frames, holding the Blob frames of distinct requests
+    bool multiBlobArchive() const { return multiBlobArchive_; }
+
+    /// Name of the shared memory segment offered by the client for the data connection, if any
+    const std::string& sharedMemory() const { return sharedMemory_; }
+    void sharedMemory(const std::string& name) { sharedMemory_ = name; }
+
+    /// Name of the compressor for the Blob and MultiBlob frames, requested by the client, if any
+    const std::string& compression() const { return compression_; }
+    void compression(const std::string& name) { compression_ = name; }
+
     friend eckit::Stream& operator<<(eckit::Stream& s, const RemoteConfiguration& r);
 
 private:
@@ -67,6 +81,17 @@ private:
     std::optional<bool> preferSingleConnection_;
 
     bool singleConnection_{false};
+
+    bool pipelinedReads_{false};
+
+    bool multiBlobArchive_{false};
+
+    std::string sharedMemory_;
+
+    std::string compression_;
+
+    /// Whether this side allows the data frames to be compressed. Not sent: the server decides on the compressor.
+    bool compressionAllowed_{true};
 };
 
 //----------------------------------------------------------------------------------------------------------------------
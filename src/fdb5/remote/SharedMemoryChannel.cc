@@ -0,0 +1,369 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+#include "eckit/maths/Functions.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/remote/SharedMemoryChannel.h"
+
+namespace fdb5::remote {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// The state of a ring, written by both sides. The counters only grow: head - tail is the number of bytes to read.
+/// n.b. the peer can write anything to the segment, so each side keeps its own counter, and checks the counter of the
+/// peer against it before using it.
+struct RingControl {
+    alignas(64) std::atomic<uint64_t> head;  ///< bytes written
+    alignas(64) std::atomic<uint64_t> tail;  ///< bytes read
+
+    // futex words, and the number of sides sleeping on them
+    alignas(64) std::atomic<uint32_t> dataSeq;
+    std::atomic<uint32_t> dataWaiters;
+    std::atomic<uint32_t> spaceSeq;
+    std::atomic<uint32_t> spaceWaiters;
+
+    std::atomic<uint32_t> closed;
+};
+
+struct SegmentHeader {
+    char magic_[8];
+    uint64_t ringSize_;
+    RingControl rings_[2];  ///< to the server, and to the client
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory rings need lock-free atomics");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex words must be 32 bits");
+
+const char segmentMagic[8] = {'F', 'D', 'B', 'S', 'H', 'M', '1', '\0'};
+
+const size_t pageSize = 4096;
+
+/// How often a waiting side checks that its peer is still there
+const long waitMilliseconds = 100;
+
+size_t dataOffset() {
+    return eckit::round(sizeof(SegmentHeader), pageSize);
+}
+
+size_t segmentSize(size_t ringSize) {
+    return dataOffset() + 2 * ringSize;
+}
+
+#if defined(__linux__)
+
+void futexWait(std::atomic<uint32_t>& word, uint32_t value) {
+    struct timespec timeout{0, waitMilliseconds * 1000 * 1000};
+    // n.b. not FUTEX_PRIVATE_FLAG, as the word is shared between processes
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, value, &timeout, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>& word) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+#endif
+
+void notify(std::atomic<uint32_t>& seq, std::atomic<uint32_t>& waiters) {
+    seq.fetch_add(1);
+#if defined(__linux__)
+    if (waiters.load() > 0) {
+        futexWake(seq);
+    }
+#endif
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct SharedMemoryChannel::Ring {
+    RingControl* control_;
+    char* data_;
+    size_t size_;
+};
+
+SharedMemoryChannel::SharedMemoryChannel(const std::string& name, void* address, size_t size, size_t ringSize,
+                                         bool owner) :
+    name_(name),
+    address_(address),
+    size_(size),
+    ringSize_(ringSize),
+    owner_(owner),
+    linked_(owner),
+    broken_(false),
+    peerSocket_(-1),
+    written_(0),
+    read_(0) {}
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+    close();
+    unlink();
+    ::munmap(address_, size_);
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::create(size_t ringSize) {
+
+#if defined(__linux__)
+    ringSize = eckit::round(std::max(ringSize, pageSize), pageSize);
+    const size_t size = segmentSize(ringSize);
+
+    static std::atomic<unsigned> counter{0};
+
+    for (int attempt = 0; attempt < 16; ++attempt) {
+
+        // The random part keeps a server on another host from attaching to an unrelated segment of the same name
+        std::string name = "/fdb-" + std::to_string(::getpid()) + "-" + std::to_string(counter++) + "-" +
+                           std::to_string(std::random_device{}());
+
+        // Only the same user can attach
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            if (errno == EEXIST) {
+                continue;  // left over by a process with the same pid
+            }
+            LOG_DEBUG_LIB(LibFdb5) << "Cannot create shared memory segment " << name << ": " << eckit::Log::syserr
+                                   << std::endl;
+            return nullptr;
+        }
+
+        void* address = MAP_FAILED;
+        if (::ftruncate(fd, size) == 0) {
+            address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+
+        if (address == MAP_FAILED) {
+            LOG_DEBUG_LIB(LibFdb5) << "Cannot map shared memory segment " << name << ": " << eckit::Log::syserr
+                                   << std::endl;
+            ::shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        // The new segment is zero-filled, which is the initial state of the rings
+        auto* header = static_cast<SegmentHeader*>(address);
+        header->ringSize_ = ringSize;
+        ::memcpy(header->magic_, segmentMagic, sizeof(segmentMagic));
+
+        return std::unique_ptr<SharedMemoryChannel>(new SharedMemoryChannel(name, address, size, ringSize, true));
+    }
+#endif
+
+    return nullptr;
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::open(const std::string& name) {
+
+#if defined(__linux__)
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        LOG_DEBUG_LIB(LibFdb5) << "Cannot open shared memory segment " << name << ": " << eckit::Log::syserr
+                               << std::endl;
+        return nullptr;
+    }
+
+    struct stat st;
+    void* address = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && size_t(st.st_size) > dataOffset()) {
+        address = ::mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const auto* header = static_cast<const SegmentHeader*>(address);
+    if (::memcmp(header->magic_, segmentMagic, sizeof(segmentMagic)) != 0 ||
+        segmentSize(header->ringSize_) != size_t(st.st_size)) {
+        eckit::Log::warning() << "Ignoring invalid shared memory segment " << name << std::endl;
+        ::munmap(address, st.st_size);
+        return nullptr;
+    }
+
+    // n.b. the ring size is read once, here, as the client could change it afterwards
+    return std::unique_ptr<SharedMemoryChannel>(
+        new SharedMemoryChannel(name, address, st.st_size, header->ringSize_, false));
+#else
+    return nullptr;
+#endif
+}
+
+void SharedMemoryChannel::unlink() {
+    if (linked_) {
+        ::shm_unlink(name_.c_str());
+        linked_ = false;
+    }
+}
+
+SharedMemoryChannel::Ring SharedMemoryChannel::ring(bool toServer) const {
+    auto* header = static_cast<SegmentHeader*>(address_);
+    const size_t n = toServer ? 0 : 1;
+    return Ring{&header->rings_[n], static_cast<char*>(address_) + dataOffset() + n * ringSize_, ringSize_};
+}
+
+bool SharedMemoryChannel::corrupt(const char* counter, uint64_t value, uint64_t own) {
+    eckit::Log::error() << "Shared memory channel " << name_ << " is corrupt: " << counter << " " << value
+                        << " is inconsistent with " << own << " in a ring of " << ringSize_ << " bytes" << std::endl;
+    broken_ = true;
+    close();
+    return false;
+}
+
+bool SharedMemoryChannel::peerAlive() const {
+    if (peerSocket_ < 0) {
+        return true;
+    }
+    // Nothing is sent on the socket any more, so anything to read is the hang-up of the peer
+    struct pollfd pfd{peerSocket_, POLLIN, 0};
+    return ::poll(&pfd, 1, 0) == 0;
+}
+
+bool SharedMemoryChannel::write(const void* data, size_t length) {
+
+    Ring r = ring(owner_);
+    RingControl& c = *r.control_;
+    const char* p = static_cast<const char*>(data);
+
+    while (length > 0) {
+
+        if (c.closed.load()) {
+            return false;
+        }
+
+        const uint64_t head = written_;
+        const uint64_t tail = c.tail.load();
+        if (tail > head || head - tail > r.size_) {
+            return corrupt("tail", tail, head);
+        }
+        const size_t space = r.size_ - (head - tail);
+
+        if (space == 0) {
+            c.spaceWaiters.fetch_add(1);
+            uint32_t seq = c.spaceSeq.load();
+            if (c.tail.load() == tail && !c.closed.load()) {
+#if defined(__linux__)
+                futexWait(c.spaceSeq, seq);
+#endif
+            }
+            c.spaceWaiters.fetch_sub(1);
+            if (c.tail.load() == tail && !peerAlive()) {
+                return false;
+            }
+            continue;
+        }
+
+        const size_t n = std::min(length, space);
+        const size_t pos = head % r.size_;
+        const size_t first = std::min(n, r.size_ - pos);
+        ASSERT(first <= r.size_ && n - first <= pos);
+        ::memcpy(r.data_ + pos, p, first);
+        ::memcpy(r.data_, p + first, n - first);
+
+        written_ = head + n;
+        c.head.store(written_);
+        notify(c.dataSeq, c.dataWaiters);
+
+        p += n;
+        length -= n;
+    }
+
+    return true;
+}
+
+bool SharedMemoryChannel::read(void* data, size_t length) {
+
+    Ring r = ring(!owner_);
+    RingControl& c = *r.control_;
+    char* p = static_cast<char*>(data);
+
+    while (length > 0) {
+
+        const uint64_t tail = read_;
+        const uint64_t head = c.head.load();
+        if (head < tail || head - tail > r.size_) {
+            return corrupt("head", head, tail);
+        }
+        const size_t available = head - tail;
+
+        if (available == 0) {
+            if (c.closed.load()) {
+                return false;
+            }
+            c.dataWaiters.fetch_add(1);
+            uint32_t seq = c.dataSeq.load();
+            if (c.head.load() == head && !c.closed.load()) {
+#if defined(__linux__)
+                futexWait(c.dataSeq, seq);
+#endif
+            }
+            c.dataWaiters.fetch_sub(1);
+            if (c.head.load() == head && !peerAlive()) {
+                return false;
+            }
+            continue;
+        }
+
+        const size_t n = std::min(length, available);
+        const size_t pos = tail % r.size_;
+        const size_t first = std::min(n, r.size_ - pos);
+        ASSERT(first <= r.size_ && n - first <= pos);
+        ::memcpy(p, r.data_ + pos, first);
+        ::memcpy(p + first, r.data_, n - first);
+
+        read_ = tail + n;
+        c.tail.store(read_);
+        notify(c.spaceSeq, c.spaceWaiters);
+
+        p += n;
+        length -= n;
+    }
+
+    return true;
+}
+
+void SharedMemoryChannel::close() {
+    for (bool toServer : {true, false}) {
+        Ring r = ring(toServer);
+        r.control_->closed.store(1);
+        notify(r.control_->dataSeq, r.control_->dataWaiters);
+        notify(r.control_->spaceSeq, r.control_->spaceWaiters);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::remote
@@ -0,0 +1,109 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   SharedMemoryChannel.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace fdb5::remote {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A pair of byte rings in a POSIX shared memory segment, used in place of the data socket between a client and an
+/// fdb-server running on the same host.
+///
+/// The client creates the segment and offers its name during the Startup handshake. The server opens it, and the
+/// client then removes the name, so that the segment goes away with the two mappings. One ring carries the data from
+/// the client to the server, the other one back. Each ring has a single writer and a single reader, which sleep on a
+/// futex in the segment when the ring is full or empty. While they wait, they check periodically that the peer is
+/// still there, through the data socket, which stays connected but is otherwise unused.
+///
+/// The counters of the rings are in the segment, where the peer could write anything. Values that would take a side
+/// past the data it owns break the channel: it is closed, and reads and writes fail. The data socket cannot take over
+/// from there, as the stream is out of step.
+class SharedMemoryChannel {
+
+public:  // methods
+
+    ~SharedMemoryChannel();
+
+    SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+    SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+    /// Creates a segment with rings of @p ringSize bytes, for the client side. Returns nullptr if shared memory is
+    /// not available.
+    static std::unique_ptr<SharedMemoryChannel> create(size_t ringSize);
+
+    /// Opens the segment created by a client, for the server side. Returns nullptr if it cannot be opened, which is
+    /// the case if the client is on another host, or is run by another user.
+    static std::unique_ptr<SharedMemoryChannel> open(const std::string& name);
+
+    const std::string& name() const { return name_; }
+
+    /// Removes the name of the segment. The mappings remain valid.
+    void unlink();
+
+    /// The socket whose hang-up tells that the peer is gone
+    void watch(int fd) { peerSocket_ = fd; }
+
+    /// Returns false if the channel is closed, or the peer is gone
+    bool write(const void* data, size_t length);
+
+    /// Returns false if the channel is closed, or the peer is gone, and there is no more data to read
+    bool read(void* data, size_t length);
+
+    /// Wakes up the peer, which then sees the channel closed once it has read all the data
+    void close();
+
+    /// Whether the channel was closed because the peer left its rings in an inconsistent state
+    bool broken() const { return broken_; }
+
+private:  // types
+
+    struct Ring;
+
+private:  // methods
+
+    SharedMemoryChannel(const std::string& name, void* address, size_t size, size_t ringSize, bool owner);
+
+    Ring ring(bool toServer) const;
+
+    /// Breaks the channel, as the @p counter of the peer is inconsistent with the one of this side. Returns false.
+    bool corrupt(const char* counter, uint64_t value, uint64_t own);
+
+    bool peerAlive() const;
+
+private:  // members
+
+    std::string name_;
+
+    void* address_;
+    size_t size_;
+    size_t ringSize_;
+
+    bool owner_;  ///< the client side, which writes to the server
+    bool linked_;
+    bool broken_;
+
+    int peerSocket_;
+
+    uint64_t written_;  ///< the head of the ring this side writes
+    uint64_t read_;     ///< the tail of the ring this side reads
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::remote
@@ -126,6 +126,20 @@ eckit::Buffer Client::controlWriteReadResponse(const Message msg, const uint32_t
     return waitControlResponse(response, msg, requestID);
 }
 
+void Client::controlWriteNoResponse(const Message msg, const uint32_t requestID, const void* const payload,
+                                    const uint32_t payloadLength) const {
+
+    ASSERT(requestID);
+    ASSERT(!(!payloadLength ^ !payload));
+
+    PayloadList payloads;
+    if (payloadLength > 0) {
+        payloads.emplace_back(payloadLength, payload);
+    }
+
+    connection_->controlSend(*this, msg, requestID, payloads);
+}
+
 void Client::dataWrite(Message msg, uint32_t requestID, PayloadList payloads) {
     connection_->dataWrite(*this, msg, requestID, std::move(payloads));
 }
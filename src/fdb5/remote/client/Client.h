@@ -80,8 +80,14 @@ public:  // methods
     eckit::Buffer controlWriteReadResponse(Message msg, uint32_t requestID, const void* payload = nullptr,
                                            uint32_t payloadLength = 0) const;
 
+    // non-blocking request, which the server does not acknowledge
+    void controlWriteNoResponse(Message msg, uint32_t requestID, const void* payload = nullptr,
+                                uint32_t payloadLength = 0) const;
+
     void dataWrite(Message msg, uint32_t requestID, PayloadList payloads = {});
 
+    bool pipelinedReads() const { return connection_->pipelinedReads(); }
+
     virtual const eckit::Configuration& clientConfig() const = 0;
 
     // handlers for incoming messages - to be defined in the client class
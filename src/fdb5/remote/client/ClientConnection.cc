@@ -19,6 +19,7 @@
 #include "eckit/net/Endpoint.h"
 #include "eckit/runtime/SessionID.h"
 #include "eckit/serialisation/MemoryStream.h"
+#include "eckit/utils/Compressor.h"
 #include "eckit/utils/Literals.h"
 
 #include <unistd.h>
@@ -70,6 +71,7 @@ ClientConnection::ClientConnection(const net::Endpoint& controlEndpoint, const s
 void ClientConnection::add(Client& client) {
     std::lock_guard lock(clientsMutex_);
     clients_[client.id()] = &client;
+    numClients_ = clients_.size();
 }
 
 bool ClientConnection::remove(uint32_t clientID) {
@@ -91,6 +93,7 @@ bool ClientConnection::remove(uint32_t clientID) {
             }
 
             clients_.erase(it);
+            numClients_ = clients_.size();
         }
     }
 
@@ -140,6 +143,9 @@ bool ClientConnection::connect(const Configuration& config, bool singleAttempt)
             LOG_DEBUG_LIB(LibFdb5) << "Received data endpoint from host: " << dataEndpoint_ << std::endl;
             dataClient_.connect(dataEndpoint_, fdbMaxConnectRetries, fdbConnectTimeout);
             writeDataStartupMessage(serverSession);
+            if (sharedMemoryOffer_) {
+                useSharedMemory(std::move(sharedMemoryOffer_));
+            }
 
             listeningDataThread_ = std::thread([this] { listeningDataThreadLoop(); });
         }
@@ -209,6 +215,16 @@ std::future<Buffer> ClientConnection::controlWrite(const Client& client, const M
     return f;
 }
 
+void ClientConnection::controlSend(const Client& client, const Message msg, const uint32_t requestID,
+                                   const PayloadList payloads) const {
+    if (!valid()) {
+        throw RemoteFDBException("Connection to " + std::string(controlEndpoint_) + " is no longer valid",
+                                 controlEndpoint_);
+    }
+
+    Connection::write(msg, true, client.clientId(), requestID, payloads);
+}
+
 void ClientConnection::dataWrite(DataWriteRequest& request) const {
     Connection::write(request.msg_, false, request.client_->clientId(), request.id_, request.data_.data(),
                       request.data_.size());
@@ -251,19 +267,81 @@ void ClientConnection::dataWrite(Client& client, remote::Message msg, uint32_t r
     dataWriteQueue_->emplace(&client, msg, requestID, std::move(buffer));
 }
 
+void ClientConnection::dataWriteBatch(const Client* client, uint32_t requestID, size_t count,
+                                      const Buffer& buffer, size_t length) const {
+    ASSERT(count > 0);
+    if (count == 1) {
+        // a lone field is sent as a plain Blob, without the header and end marker of its batched frame
+        const char* data = static_cast<const char*>(buffer.data()) + sizeof(MessageHeader);
+        const size_t dataLength = length - sizeof(MessageHeader) - MessageHeader::markerBytes;
+        Connection::write(Message::Blob, false, client->clientId(), requestID, data, dataLength);
+        return;
+    }
+    Connection::write(Message::MultiBlob, false, client->clientId(), requestID, buffer.data(), length);
+}
+
 void ClientConnection::dataWriteThreadLoop() {
 
+    // Small archived fields are batched into MultiBlob frames, to save a round of socket writes for each. A batch is
+    // sent once it is full, or as soon as the queue is empty, so that no field waits for the ones archived after it.
+    static size_t batchSize = Resource<size_t>("fdbArchiveBatchSize;$FDB_ARCHIVE_BATCH_SIZE", 1_MiB);
+    const size_t maxBatch = multiBlobArchive_ ? batchSize : 0;
+
     Timer timer;
     DataWriteRequest element;
 
+    Buffer batch{maxBatch};
+    size_t batchLength = 0;
+    size_t batchCount = 0;
+    const Client* batchClient = nullptr;
+    uint32_t batchID = 0;
+
+    auto flushBatch = [&]() {
+        if (batchCount > 0) {
+            dataWriteBatch(batchClient, batchID, batchCount, batch, batchLength);
+            batchLength = 0;
+            batchCount = 0;
+        }
+    };
+
     try {
 
         ASSERT(dataWriteQueue_);
         while (dataWriteQueue_->pop(element) != -1) {
 
-            dataWrite(element);
+            const size_t framed = sizeof(MessageHeader) + element.data_.size() + MessageHeader::markerBytes;
+
+            if (element.msg_ != Message::Blob || framed > maxBatch) {
+                flushBatch();
+                dataWrite(element);
+                continue;
+            }
+
+            if (batchCount > 0 && (batchClient != element.client_ || batchLength + framed > maxBatch)) {
+                flushBatch();
+            }
+
+            if (batchCount == 0) {
+                batchClient = element.client_;
+                batchID = element.id_;
+            }
+
+            MessageHeader hdr{Message::Blob, false, element.client_->clientId(), element.id_,
+                              static_cast<uint32_t>(element.data_.size())};
+            batch.copy(&hdr, sizeof(hdr), batchLength);
+            batchLength += sizeof(hdr);
+            batch.copy(element.data_.data(), element.data_.size(), batchLength);
+            batchLength += element.data_.size();
+            batch.copy(&MessageHeader::EndMarker, MessageHeader::markerBytes, batchLength);
+            batchLength += MessageHeader::markerBytes;
+            ++batchCount;
+
+            if (dataWriteQueue_->empty()) {
+                flushBatch();
+            }
         }
 
+        flushBatch();
         dataWriteQueue_.reset();
     }
     catch (...) {
@@ -282,7 +360,32 @@ void ClientConnection::writeControlStartupMessage(const Configuration& config) {
     s << sessionID_;
     s << net::Endpoint(controlEndpoint_.hostname(), controlEndpoint_.port());
     s << LibFdb5::instance().remoteProtocolVersion().used();
-    s << availableFunctionality(config);
+
+    RemoteConfiguration functionality = availableFunctionality(config);
+
+    // Offer a shared memory channel for the data connection. The server takes it if it runs on this host.
+    static bool useSharedMemory = Resource<bool>("fdbSharedMemory;$FDB_SHARED_MEMORY", false);
+    static size_t ringSize = Resource<size_t>("fdbSharedMemoryRingSize;$FDB_SHARED_MEMORY_RING_SIZE", 16_MiB);
+    if (useSharedMemory) {
+        sharedMemoryOffer_ = SharedMemoryChannel::create(ringSize);
+        if (sharedMemoryOffer_) {
+            functionality.sharedMemory(sharedMemoryOffer_->name());
+        }
+    }
+
+    // Ask for the data frames to be compressed
+    static std::string compression = Resource<std::string>("fdbRemoteCompression;$FDB_REMOTE_COMPRESSION", "");
+    if (!compression.empty()) {
+        if (CompressorFactory::instance().has(compression)) {
+            functionality.compression(compression);
+        }
+        else {
+            Log::warning() << "Remote compression " << compression << " is not available, data is sent uncompressed"
+                           << std::endl;
+        }
+    }
+
+    s << functionality;
 
     LOG_DEBUG_LIB(LibFdb5) << "writeControlStartupMessage - Sending session " << sessionID_ << " to control "
                            << controlEndpoint_ << std::endl;
@@ -332,6 +435,25 @@ SessionID ClientConnection::verifyServerStartupResponse() {
     if (serverFunctionality.has("NumberOfConnections") && serverFunctionality.getInt("NumberOfConnections") == 1) {
         single_ = true;
     }
+    pipelinedReads_ = serverFunctionality.has("PipelinedReads") && serverFunctionality.getBool("PipelinedReads");
+    multiBlobArchive_ =
+        serverFunctionality.has("MultiBlobArchive") && serverFunctionality.getBool("MultiBlobArchive");
+
+    if (serverFunctionality.has("Compression")) {
+        const std::string compression = serverFunctionality.getString("Compression");
+        if (!compression.empty()) {
+            useCompression(compression);
+        }
+    }
+
+    if (sharedMemoryOffer_) {
+        // The server has opened the segment, if it accepted it, so the name is no longer needed
+        sharedMemoryOffer_->unlink();
+        if (single_ || !serverFunctionality.has("SharedMemory") ||
+            serverFunctionality.getString("SharedMemory") != sharedMemoryOffer_->name()) {
+            sharedMemoryOffer_.reset();
+        }
+    }
 
     if (single_ && !(dataEndpoint_ == controlEndpoint_)) {
         Log::warning() << "Returned control interface does not match. " << dataEndpoint_ << " /= " << controlEndpoint_
@@ -20,6 +20,7 @@
 #include "eckit/net/TCPSocket.h"
 #include "eckit/runtime/SessionID.h"
 
+#include <atomic>
 #include <cstdint>
 #include <exception>
 #include <future>
@@ -54,6 +55,9 @@ public:  // methods
     std::future<eckit::Buffer> controlWrite(const Client& client, Message msg, uint32_t requestID,
                                             bool /*dataListener*/, PayloadList payload = {}) const;
 
+    /// Sends a control message for which the server sends no response
+    void controlSend(const Client& client, Message msg, uint32_t requestID, PayloadList payload = {}) const;
+
     void dataWrite(Client& client, Message msg, uint32_t requestID, PayloadList payloads = {});
 
     void add(Client& client);
@@ -66,6 +70,12 @@ public:  // methods
     const eckit::net::Endpoint& controlEndpoint() const;
     const std::string& defaultEndpoint() const { return defaultEndpoint_; }
 
+    /// Whether the server agreed to serve unacknowledged, concurrent read requests
+    bool pipelinedReads() const { return pipelinedReads_; }
+
+    /// Number of clients using the connection
+    size_t numClients() const { return numClients_; }
+
     using Connection::valid;
 
 private:  // methods
@@ -74,6 +84,10 @@ private:  // methods
 
     void dataWrite(DataWriteRequest& request) const;
 
+    /// Sends the Blob frames batched in @p buffer, as a single MultiBlob frame if there are several
+    void dataWriteBatch(const Client* client, uint32_t requestID, size_t count, const eckit::Buffer& buffer,
+                        size_t length) const;
+
     // construct dictionary for protocol negotiation - to be defined in the client class
     RemoteConfiguration availableFunctionality(const eckit::Configuration& config) const;
 
@@ -115,6 +129,9 @@ private:  // members
     std::mutex clientsMutex_;
     std::map<uint32_t, Client*> clients_;
 
+    /// Size of clients_, read by the router without taking clientsMutex_
+    std::atomic<size_t> numClients_{0};
+
     std::thread listeningControlThread_;
     std::thread listeningDataThread_;
 
@@ -126,6 +143,12 @@ private:  // members
 
     bool connected_;
 
+    bool pipelinedReads_{false};
+    bool multiBlobArchive_{false};
+
+    /// Shared memory segment offered to the server for the data connection, until it is accepted
+    std::unique_ptr<SharedMemoryChannel> sharedMemoryOffer_;
+
     mutable std::mutex promisesMutex_;
 
     mutable std::map<uint32_t, std::promise<eckit::Buffer>> promises_;
@@ -2,10 +2,12 @@
 
 #include "fdb5/remote/client/ClientConnection.h"
 
+#include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/log/Log.h"
 #include "eckit/net/Endpoint.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -49,23 +51,45 @@ size_t random(size_t const max) {
     return dist(rndGen, std::uniform_int_distribution<size_t>::param_type{0, max});
 }
 
+namespace {
+
+/// The live connection of the pool used by the fewest clients, so that their data writes are spread across the pool
+std::shared_ptr<ClientConnection> leastLoaded(const std::vector<std::weak_ptr<ClientConnection>>& pool) {
+    std::shared_ptr<ClientConnection> best;
+    for (const auto& weak : pool) {
+        auto conn = weak.lock();
+        if (conn && conn->valid() && (!best || conn->numClients() < best->numClients())) {
+            best = std::move(conn);
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
 //----------------------------------------------------------------------------------------------------------------------
 
+ClientConnectionRouter::ClientConnectionRouter() :
+    poolSize_(std::max<size_t>(
+        1, eckit::Resource<size_t>("fdbRemoteConnectionsPerEndpoint;$FDB_REMOTE_CONNECTIONS_PER_ENDPOINT", 1))) {}
+
 std::shared_ptr<ClientConnection> ClientConnectionRouter::connection(const eckit::Configuration& config,
                                                                      const eckit::net::Endpoint& endpoint,
                                                                      const std::string& defaultEndpoint) {
     std::lock_guard lock(connectionMutex_);
     reap();
-    if (const auto iter = connections_.find(endpoint); iter != connections_.end()) {
-        if (auto conn = iter->second.lock(); conn && conn->valid()) {
-            return conn;
-        }
+    if (auto conn = pooled(endpoint)) {
+        return conn;
     }
     auto clientConnection = std::make_shared<ClientConnection>(endpoint, defaultEndpoint);
     if (clientConnection->connect(config)) {
-        connections_.insert_or_assign(endpoint, clientConnection);
+        connections_[endpoint].push_back(clientConnection);
         return clientConnection;
     }
+    // The endpoint is still usable through the connections already in its pool
+    if (auto conn = live(endpoint)) {
+        return conn;
+    }
     throw ConnectionError(endpoint);
 }
 
@@ -81,20 +105,23 @@ std::shared_ptr<ClientConnection> ClientConnectionRouter::connection(
         size_t idx = random(fullEndpoints.size() - 1);
         eckit::net::Endpoint endpoint = fullEndpoints.at(idx).first;
 
-        // look for the selected endpoint (a dead connection must not be handed out; replace it)
-        if (const auto it = connections_.find(endpoint); it != connections_.end()) {
-            if (auto conn = it->second.lock(); conn && conn->valid()) {
-                return conn;
-            }
+        // look for the selected endpoint (dead connections have been reaped, and are never handed out)
+        if (auto conn = pooled(endpoint)) {
+            return conn;
         }
 
-        // not yet there, trying to connect
+        // not yet there, or room for another one in the pool, trying to connect
         auto clientConnection = std::make_shared<ClientConnection>(endpoint, fullEndpoints.at(idx).second);
         if (clientConnection->connect(config, true)) {
-            connections_.insert_or_assign(endpoint, clientConnection);
+            connections_[endpoint].push_back(clientConnection);
             return clientConnection;
         }
 
+        // the endpoint is still usable through the connections already in its pool
+        if (auto conn = live(endpoint)) {
+            return conn;
+        }
+
         // unable to connect to "endpoint", remove it and try again
         if (idx != fullEndpoints.size() - 1) {  // swap with the last element
             fullEndpoints[idx] = std::move(fullEndpoints.back());
@@ -110,26 +137,34 @@ std::shared_ptr<ClientConnection> ClientConnectionRouter::refresh(const eckit::C
                                                                   const std::shared_ptr<ClientConnection>& connection) {
     std::lock_guard lock(connectionMutex_);
     reap();
-    if (const auto iter = connections_.find(connection->controlEndpoint()); iter != connections_.end()) {
-        // Another client may already have refreshed this endpoint: reuse the live connection.
-        if (auto conn = iter->second.lock(); conn && conn->valid()) {
-            return conn;
-        }
+    // Another client may already have refreshed this endpoint: reuse the live connection.
+    if (auto conn = pooled(connection->controlEndpoint())) {
+        return conn;
     }
     auto newConnection =
         std::make_shared<ClientConnection>(connection->controlEndpoint(), connection->defaultEndpoint());
     if (newConnection->connect(config)) {
-        // Replacing keeps a single pooled connection per endpoint.
-        connections_.insert_or_assign(newConnection->controlEndpoint(), newConnection);
+        // The dead connection has been reaped, so this takes its place in the pool.
+        connections_[newConnection->controlEndpoint()].push_back(newConnection);
         return newConnection;
     }
+    // Other connections of the pool may have survived
+    if (auto conn = live(newConnection->controlEndpoint())) {
+        return conn;
+    }
     throw ConnectionError(newConnection->controlEndpoint());
 }
 
 void ClientConnectionRouter::reap() {
     for (auto iter = connections_.begin(); iter != connections_.end();) {
-        auto conn = iter->second.lock();
-        if (!conn || !conn->valid()) {
+        auto& pool = iter->second;
+        pool.erase(std::remove_if(pool.begin(), pool.end(),
+                                  [](const auto& weak) {
+                                      auto conn = weak.lock();
+                                      return !conn || !conn->valid();
+                                  }),
+                   pool.end());
+        if (pool.empty()) {
             iter = connections_.erase(iter);
         }
         else {
@@ -138,12 +173,34 @@ void ClientConnectionRouter::reap() {
     }
 }
 
+std::shared_ptr<ClientConnection> ClientConnectionRouter::pooled(const eckit::net::Endpoint& endpoint) {
+    const auto iter = connections_.find(endpoint);
+    if (iter == connections_.end() || iter->second.size() < poolSize_) {
+        return nullptr;
+    }
+    return leastLoaded(iter->second);
+}
+
+std::shared_ptr<ClientConnection> ClientConnectionRouter::live(const eckit::net::Endpoint& endpoint) {
+    const auto iter = connections_.find(endpoint);
+    if (iter == connections_.end()) {
+        return nullptr;
+    }
+    return leastLoaded(iter->second);
+}
+
 void ClientConnectionRouter::deregister(ClientConnection& connection) {
     std::lock_guard lock(connectionMutex_);
     const auto iter = connections_.find(connection.controlEndpoint());
     if (iter != connections_.end()) {
-        auto conn = iter->second.lock();
-        if (!conn || conn.get() == &connection) {
+        auto& pool = iter->second;
+        pool.erase(std::remove_if(pool.begin(), pool.end(),
+                                  [&connection](const auto& weak) {
+                                      auto conn = weak.lock();
+                                      return !conn || conn.get() == &connection;
+                                  }),
+                   pool.end());
+        if (pool.empty()) {
             connections_.erase(iter);
         }
     }
@@ -159,10 +216,12 @@ ClientConnectionRouter& ClientConnectionRouter::instance() {
 ClientConnectionRouter::~ClientConnectionRouter() {
     // there is nothing to tear down here; as a courtesy we notify the server for those.
     std::lock_guard lock(connectionMutex_);
-    for (auto& [endp, weak] : connections_) {
-        if (auto conn = weak.lock()) {
-            eckit::Log::warning() << "closing connection " << endp << std::endl;
-            conn->teardown();
+    for (auto& [endp, pool] : connections_) {
+        for (auto& weak : pool) {
+            if (auto conn = weak.lock()) {
+                eckit::Log::warning() << "closing connection " << endp << std::endl;
+                conn->teardown();
+            }
         }
     }
     connections_.clear();
@@ -17,6 +17,7 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace eckit {
 class Configuration;
@@ -52,17 +53,30 @@ public:
 
 private:
 
-    ClientConnectionRouter() {}  ///< private constructor only used by singleton
+    using Pool = std::vector<std::weak_ptr<ClientConnection>>;
+
+    ClientConnectionRouter();  ///< private constructor only used by singleton
 
     /// Drop entries whose connection has been destroyed (expired) or invalidated.
     /// Caller must hold connectionMutex_.
     void reap();
 
+    /// The least loaded connection of the pool of @p endpoint, or nullptr if the pool has room for another one.
+    /// Caller must hold connectionMutex_.
+    std::shared_ptr<ClientConnection> pooled(const eckit::net::Endpoint& endpoint);
+
+    /// The least loaded live connection of the pool of @p endpoint, if any, for when a new one cannot be made.
+    /// Caller must hold connectionMutex_.
+    std::shared_ptr<ClientConnection> live(const eckit::net::Endpoint& endpoint);
+
     std::mutex connectionMutex_;
 
+    /// Number of connections opened to each endpoint, each with its own control and data sockets
+    const size_t poolSize_;
+
     /// @note ClientConnections are owned by the Client objects.
     /// dead slots are never handed out and purged lazily by reap().
-    std::unordered_map<eckit::net::Endpoint, std::weak_ptr<ClientConnection>> connections_;
+    std::unordered_map<eckit::net::Endpoint, Pool> connections_;
 };
 
 }  // namespace fdb5::remote
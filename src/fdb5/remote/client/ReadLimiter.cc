@@ -103,7 +103,9 @@ void ReadLimiter::finishRequest(uint32_t clientID, uint32_t requestID) {
         resultSizes_.erase({clientID, requestID});
     }
 
-    tryNextRequest();
+    // The memory released may be enough for several of the queued requests
+    while (tryNextRequest()) {
+    }
 }
 
 /// @note: Only called when a RemoteStore is destroyed, which is currently on exit.
@@ -134,7 +136,8 @@ void ReadLimiter::evictClient(size_t clientID) {
         }
     }
 
-    tryNextRequest();
+    while (tryNextRequest()) {
+    }
 }
 
 void ReadLimiter::print(std::ostream& out) const {
@@ -156,6 +159,12 @@ void ReadLimiter::print(std::ostream& out) const {
 }
 
 void ReadLimiter::sendRequest(const RequestInfo& request) const {
+    // With pipelined reads, the requests are not acknowledged, so that sending one does not cost a round trip. Any
+    // error is reported to the message queue of the request.
+    if (request.client->pipelinedReads()) {
+        request.client->controlWriteNoResponse(Message::Read, request.id, request.requestBuffer, request.requestSize);
+        return;
+    }
     request.client->controlWriteCheckResponse(Message::Read, request.id, true, request.requestBuffer,
                                               request.requestSize);
 }
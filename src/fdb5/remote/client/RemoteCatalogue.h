@@ -44,6 +44,7 @@ public:  // methods
     void overlayDB(const Catalogue& otherCatalogue, const std::set<std::string>& variableKeys, bool unmount) override;
     void index(const Key& key, const eckit::URI& uri, eckit::Offset offset, eckit::Length length) override;
     void reconsolidate() override;
+    bool asyncArchive() const override { return true; }
 
     // From CatalogueReader
     DbStats stats() const override { return {}; }
@@ -458,12 +458,16 @@ eckit::DataHandle* RemoteStore::dataHandle(const FieldLocation& fieldLocation, c
 
     uint32_t id = generateRequestID();
 
+    // The server completes the reads out of order, so the queue must hold a whole field: the data handles are read in
+    // order, and the listening thread must not block on the queue of a later field.
     static size_t queueSize = 320;
+    const size_t fieldQueueSize = std::max<size_t>(queueSize, size_t(fieldLocation.length()) / 1_MiB + 2);
+
     std::shared_ptr<MessageQueue> queue = nullptr;
     {
         std::lock_guard lock(messageMutex_);
 
-        auto entry = messageQueues_.emplace(id, std::make_shared<MessageQueue>(queueSize));
+        auto entry = messageQueues_.emplace(id, std::make_shared<MessageQueue>(fieldQueueSize));
         ASSERT(entry.second);
 
         queue = entry.first->second;
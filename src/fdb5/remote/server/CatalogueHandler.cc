@@ -26,9 +26,11 @@
 #include "eckit/serialisation/MemoryStream.h"
 #include "eckit/utils/Literals.h"
 
+#include <algorithm>
 #include <future>
 #include <mutex>
 #include <utility>
+#include <vector>
 
 using namespace eckit;
 using namespace eckit::literals;
@@ -509,6 +511,24 @@ void CatalogueHandler::flush(uint32_t clientID, uint32_t requestID, eckit::Buffe
 // A helper function to make archiveThreadLoop a bit cleaner
 void CatalogueHandler::archiveBlob(const uint32_t clientID, const uint32_t requestID, const void* data, size_t length) {
 
+    CatalogueArchiver& archiver = catalogueArchiver(clientID);
+
+    archiveEntry(*archiver.catalogue, data, length);
+
+    locationsArchived(archiver, 1);
+}
+
+void CatalogueHandler::archiveBlobs(const uint32_t clientID, const std::vector<ArchiveBlob>& blobs) {
+
+    CatalogueArchiver& archiver = catalogueArchiver(clientID);
+
+    archiveEntries(*archiver.catalogue, blobs);
+
+    locationsArchived(archiver, blobs.size());
+}
+
+void CatalogueHandler::archiveEntry(CatalogueWriter& catalogue, const void* data, size_t length) {
+
     MemoryStream s(data, length);
 
     fdb5::Key idxKey(s);
@@ -516,31 +536,70 @@ void CatalogueHandler::archiveBlob(const uint32_t clientID, const uint32_t reque
 
     std::unique_ptr<FieldLocation> location(eckit::Reanimator<FieldLocation>::reanimate(s));
 
-    LOG_DEBUG_LIB(LibFdb5) << "CatalogueHandler::archiveBlob key: " << idxKey << datumKey
+    LOG_DEBUG_LIB(LibFdb5) << "CatalogueHandler::archiveEntry key: " << idxKey << datumKey
                            << "  location: " << location->uri() << std::endl;
 
-    std::map<uint32_t, CatalogueArchiver>::iterator it;
-    {
-        std::lock_guard<std::mutex> lock(handlerMutex_);
-        it = catalogues_.find(clientID);
-        if (it == catalogues_.end()) {
-            std::string what("Requested unknown catalogue id: " + std::to_string(clientID));
-            error(what, 0, 0);
-            throw SeriousBug(what, Here());
-        }
+    if (!catalogue.selectIndex(idxKey)) {
+        catalogue.createIndex(idxKey, datumKey.keys().size());
     }
+    catalogue.archive(idxKey, datumKey, std::move(location));
+}
+
+void CatalogueHandler::archiveEntries(CatalogueWriter& catalogue, const std::vector<ArchiveBlob>& blobs) {
+
+    struct Entry {
+        fdb5::Key datumKey;
+        std::unique_ptr<FieldLocation> location;
+    };
+
+    // Group the entries by index, in order of first appearance, so that each index is selected once. The order of
+    // the entries of an index is kept, and with it the order of repeated archivals of the same key.
+    std::vector<std::pair<fdb5::Key, std::vector<Entry>>> groups;
 
-    if (!it->second.catalogue->selectIndex(idxKey)) {
-        it->second.catalogue->createIndex(idxKey, datumKey.keys().size());
+    for (const auto& blob : blobs) {
+        MemoryStream s(blob.data_, blob.length_);
+
+        fdb5::Key idxKey(s);
+        fdb5::Key datumKey(s);
+        std::unique_ptr<FieldLocation> location(eckit::Reanimator<FieldLocation>::reanimate(s));
+
+        auto it = std::find_if(groups.begin(), groups.end(), [&idxKey](const auto& g) { return g.first == idxKey; });
+        if (it == groups.end()) {
+            it = groups.emplace(groups.end(), std::move(idxKey), std::vector<Entry>{});
+        }
+        it->second.push_back(Entry{std::move(datumKey), std::move(location)});
     }
-    it->second.catalogue->archive(idxKey, datumKey, std::move(location));
-    {
-        std::lock_guard<std::mutex> lock(fieldLocationsMutex_);
-        it->second.locationsArchived++;
-        if (it->second.locationsExpected != 0 && it->second.archivalCompleted.valid() &&
-            it->second.locationsExpected == it->second.locationsArchived) {
-            it->second.fieldLocationsReceived.set_value(it->second.locationsExpected);
+
+    LOG_DEBUG_LIB(LibFdb5) << "CatalogueHandler::archiveEntries " << blobs.size() << " entries in " << groups.size()
+                           << " indexes" << std::endl;
+
+    for (auto& [idxKey, entries] : groups) {
+        if (!catalogue.selectIndex(idxKey)) {
+            catalogue.createIndex(idxKey, entries.front().datumKey.keys().size());
         }
+        for (auto& entry : entries) {
+            catalogue.archive(idxKey, entry.datumKey, std::move(entry.location));
+        }
+    }
+}
+
+CatalogueArchiver& CatalogueHandler::catalogueArchiver(uint32_t clientID) {
+    std::lock_guard<std::mutex> lock(handlerMutex_);
+    auto it = catalogues_.find(clientID);
+    if (it == catalogues_.end()) {
+        std::string what("Requested unknown catalogue id: " + std::to_string(clientID));
+        error(what, 0, 0);
+        throw SeriousBug(what, Here());
+    }
+    return it->second;
+}
+
+void CatalogueHandler::locationsArchived(CatalogueArchiver& archiver, size_t count) {
+    std::lock_guard<std::mutex> lock(fieldLocationsMutex_);
+    archiver.locationsArchived += count;
+    if (archiver.locationsExpected != 0 && archiver.archivalCompleted.valid() &&
+        archiver.locationsExpected == archiver.locationsArchived) {
+        archiver.fieldLocationsReceived.set_value(archiver.locationsExpected);
     }
 }
 
@@ -54,6 +54,13 @@ public:  // methods
     CatalogueHandler(eckit::net::TCPSocket& socket, const Config& config);
     ~CatalogueHandler() override;
 
+    /// Archives the (index key, datum key, location) entry of the Blob frame of a RemoteCatalogue
+    static void archiveEntry(CatalogueWriter& catalogue, const void* data, size_t length);
+
+    /// Archives the entries of the Blob frames of a MultiBlob, as archiving each in turn would, but selecting each
+    /// of their indexes once
+    static void archiveEntries(CatalogueWriter& catalogue, const std::vector<ArchiveBlob>& blobs);
+
 private:  // methods
 
     Handled handleControl(Message message, uint32_t clientID, uint32_t requestID) override;
@@ -74,6 +81,10 @@ private:  // methods
     void exists(uint32_t clientID, uint32_t requestID, eckit::Buffer&& payload) const;
 
     void archiveBlob(const uint32_t clientID, const uint32_t requestID, const void* data, size_t length) override;
+    void archiveBlobs(uint32_t clientID, const std::vector<ArchiveBlob>& blobs) override;
+
+    CatalogueArchiver& catalogueArchiver(uint32_t clientID);
+    void locationsArchived(CatalogueArchiver& archiver, size_t count);
 
     bool remove(bool control, uint32_t clientID) override;
 
@@ -21,6 +21,7 @@
 #include "fdb5/fdb5_version.h"
 #include "fdb5/remote/Connection.h"
 #include "fdb5/remote/Messages.h"
+#include "fdb5/remote/SharedMemoryChannel.h"
 #include "fdb5/remote/server/AvailablePortList.h"
 
 #include "eckit/config/LocalConfiguration.h"
@@ -70,6 +71,8 @@ ServerConnection::ServerConnection(eckit::net::TCPSocket& socket, const Config&
     dataListenHostname_(config.getString("dataListenHostname", "")),
     readLocationQueue_(eckit::Resource<size_t>("fdbRetrieveQueueSize", defaultRetrieveQueueSize)),
     archiveQueue_(eckit::Resource<size_t>("fdbServerMaxQueueSize", defaultArchiveQueueSize)),
+    archiveFlow_(1.0),
+    readFlow_(WorkScheduler::readWeight()),
     controlSocket_(socket) {
 
     LOG_DEBUG_LIB(LibFdb5) << "ServerConnection::ServerConnection initialized" << std::endl;
@@ -187,6 +190,23 @@ void ServerConnection::initialiseConnections() {
         return;
     }
 
+    // Take the shared memory channel offered by the client, if it is on this host. It replaces the data socket once
+    // the data connection is established.
+    std::unique_ptr<SharedMemoryChannel> sharedMemory;
+    if (!agreedConf_.sharedMemory().empty()) {
+        if (config_.getBool("sharedMemory", true)) {
+            sharedMemory = SharedMemoryChannel::open(agreedConf_.sharedMemory());
+        }
+        if (!sharedMemory) {
+            agreedConf_.sharedMemory("");
+        }
+    }
+
+    // Compress the data frames as the client asked, if this server can
+    if (!agreedConf_.compression().empty()) {
+        useCompression(agreedConf_.compression());
+    }
+
     // We want a data connection too. Send info to RemoteFDB, and wait for connection
     // n.b. FDB-192: we use the host communicated from the client endpoint. This
     //               ensures that if a specific interface has been selected and the
@@ -252,6 +272,10 @@ void ServerConnection::initialiseConnections() {
             ss << "Session IDs do not match: " << serverSession << " != " << sessionID_;
             throw eckit::BadValue(ss.str(), Here());
         }
+
+        if (sharedMemory) {
+            useSharedMemory(std::move(sharedMemory));
+        }
     }
 }
 
@@ -275,15 +299,20 @@ size_t ServerConnection::archiveThreadLoop() {
     try {
         while (archiveQueue_.pop(elem) != -1) {
             if (elem.multiblob_) {
-                // Handle MultiBlob
+                // Handle MultiBlob. Each Blob frame is a field of its own request, for which a location is returned.
 
                 const char* firstData = reinterpret_cast<const char*>(elem.payload_.data());  // For pointer arithmetic
                 const char* charData = firstData;
+                std::vector<ArchiveBlob> blobs;
                 while (size_t(charData - firstData) < elem.payload_.size()) {
+                    ASSERT(size_t(charData - firstData) + sizeof(MessageHeader) <= elem.payload_.size());
                     const MessageHeader* hdr = reinterpret_cast<const MessageHeader*>(charData);
+                    ASSERT(hdr->marker == MessageHeader::StartMarker);
                     ASSERT(hdr->message == Message::Blob);
                     ASSERT(hdr->clientID() == elem.clientID_);
-                    ASSERT(hdr->requestID == elem.requestID_);
+                    ASSERT(size_t(charData - firstData) + sizeof(MessageHeader) + hdr->payloadSize +
+                               MessageHeader::markerBytes <=
+                           elem.payload_.size());
                     charData += sizeof(MessageHeader);
 
                     const void* payloadData = charData;
@@ -293,12 +322,16 @@ size_t ServerConnection::archiveThreadLoop() {
                     ASSERT(*e == MessageHeader::EndMarker);
                     charData += MessageHeader::markerBytes;
 
-                    archiveBlob(elem.clientID_, elem.requestID_, payloadData, hdr->payloadSize);
-                    totalArchived += 1;
+                    blobs.push_back(ArchiveBlob{hdr->requestID, payloadData, hdr->payloadSize});
                 }
+
+                auto slot = WorkScheduler::instance().acquire(archiveFlow_, elem.payload_.size());
+                archiveBlobs(elem.clientID_, blobs);
+                totalArchived += blobs.size();
             }
             else {
                 // Handle single blob
+                auto slot = WorkScheduler::instance().acquire(archiveFlow_, elem.payload_.size());
                 archiveBlob(elem.clientID_, elem.requestID_, elem.payload_.data(), elem.payload_.size());
                 totalArchived += 1;
             }
@@ -313,6 +346,12 @@ size_t ServerConnection::archiveThreadLoop() {
     return totalArchived;
 }
 
+void ServerConnection::archiveBlobs(uint32_t clientID, const std::vector<ArchiveBlob>& blobs) {
+    for (const auto& blob : blobs) {
+        archiveBlob(clientID, blob.requestID_, blob.data_, blob.length_);
+    }
+}
+
 void ServerConnection::listeningThreadLoopData() {
 
     MessageHeader hdr;
@@ -436,6 +475,10 @@ void ServerConnection::handle() {
                             listeningThreadData = std::thread([this] { listeningThreadLoopData(); });
                         }
                     }
+                        // Pipelined reads are not acknowledged. Errors are reported on the data connection.
+                        if (handled == Handled::YesAddReadListener && agreedConf_.pipelinedReads()) {
+                            break;
+                        }
                         [[fallthrough]];
                     case Handled::Yes:
                         write(Message::Received, true, hdr.clientID(), hdr.requestID);
@@ -513,9 +556,12 @@ void ServerConnection::waitForWorkers() {
     }
 
     std::lock_guard<std::mutex> lock(readLocationMutex_);
-    if (readLocationWorker_.joinable()) {
-        readLocationWorker_.join();
+    for (auto& worker : readLocationWorkers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
     }
+    readLocationWorkers_.clear();
 }
 
 }  // namespace fdb5::remote
@@ -19,6 +19,8 @@
 
 #include <future>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "eckit/container/Queue.h"
 #include "eckit/io/Buffer.h"
@@ -31,6 +33,7 @@
 #include "fdb5/remote/Connection.h"
 #include "fdb5/remote/Messages.h"
 #include "fdb5/remote/RemoteConfiguration.h"
+#include "fdb5/remote/server/WorkScheduler.h"
 
 namespace fdb5::remote {
 
@@ -85,6 +88,13 @@ struct ArchiveElem {
         clientID_(clientID), requestID_(requestID), payload_(std::move(payload)), multiblob_(multiblob) {}
 };
 
+/// One of the Blob frames of a MultiBlob, referring into its payload
+struct ArchiveBlob {
+    uint32_t requestID_;
+    const void* data_;
+    size_t length_;
+};
+
 class ServerConnection : public Connection, public Handler {
 public:  // methods
 
@@ -117,6 +127,9 @@ protected:
 
     virtual void archiveBlob(uint32_t clientID, uint32_t requestID, const void* data, size_t length) = 0;
 
+    /// Archives the Blob frames of a MultiBlob, in order. By default, each is archived on its own.
+    virtual void archiveBlobs(uint32_t clientID, const std::vector<ArchiveBlob>& blobs);
+
     // archival helper methods
     void archiver();
     void queue(Message message, uint32_t clientID, uint32_t requestID, eckit::Buffer&& payload);
@@ -146,12 +159,16 @@ protected:
     eckit::SessionID sessionID_;
     RemoteConfiguration agreedConf_;
     std::mutex readLocationMutex_;
-    std::thread readLocationWorker_;
+    std::vector<std::thread> readLocationWorkers_;
 
     std::map<uint32_t, std::future<void>> workerThreads_;
     eckit::Queue<ArchiveElem> archiveQueue_;
     std::future<size_t> archiveFuture_;
 
+    // this connection's share of the server's work slots
+    WorkScheduler::Flow archiveFlow_;
+    WorkScheduler::Flow readFlow_;
+
     eckit::net::TCPSocket controlSocket_;
 
     std::mutex handlerMutex_;
@@ -18,6 +18,7 @@
 #include "fdb5/remote/Messages.h"
 #include "fdb5/remote/RemoteFieldLocation.h"
 #include "fdb5/remote/server/ServerConnection.h"
+#include "fdb5/remote/server/WorkScheduler.h"
 
 #include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
@@ -28,6 +29,7 @@
 #include "eckit/types/Types.h"
 #include "eckit/utils/Literals.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -41,6 +43,17 @@ namespace fdb5::remote {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+size_t readThreads() {
+    static size_t nthreads = eckit::Resource<size_t>("fdbServerReadThreads;$FDB_SERVER_READ_THREADS", 4);
+    return std::max<size_t>(nthreads, 1);
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 StoreHandler::StoreHandler(eckit::net::TCPSocket& socket, const Config& config) : ServerConnection(socket, config) {
     LibFdb5::instance().constructorCallback()(*this);
 }
@@ -78,7 +91,9 @@ Handled StoreHandler::handleControl(Message message, uint32_t clientID, uint32_t
         switch (message) {
 
             case Message::Read:  // notification that the client is starting to send data location for read
-                read(clientID, requestID, payload);
+                if (!read(clientID, requestID, payload)) {
+                    return Handled::Replied;
+                }
                 return Handled::YesAddReadListener;
 
             case Message::Flush:  // flush store
@@ -130,25 +145,40 @@ Handled StoreHandler::handleControl(Message message, uint32_t clientID, uint32_t
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void StoreHandler::read(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload) {
+bool StoreHandler::read(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload) {
 
     {
+        // The reads are served concurrently, and complete out of order. The client demultiplexes the Blob frames of
+        // the requests on their requestID.
         std::lock_guard<std::mutex> lock(readLocationMutex_);
-        if (!readLocationWorker_.joinable()) {
-            readLocationWorker_ = std::thread([this] { readLocationThreadLoop(); });
+        if (readLocationWorkers_.empty()) {
+            for (size_t i = 0; i < readThreads(); ++i) {
+                readLocationWorkers_.emplace_back([this] { readLocationThreadLoop(); });
+            }
         }
     }
 
-    MemoryStream s(payload);
+    std::unique_ptr<eckit::DataHandle> dh;
+    try {
+        MemoryStream s(payload);
 
-    std::unique_ptr<FieldLocation> location(eckit::Reanimator<FieldLocation>::reanimate(s));
+        std::unique_ptr<FieldLocation> location(eckit::Reanimator<FieldLocation>::reanimate(s));
 
-    LOG_DEBUG_LIB(LibFdb5) << "Queuing for read: " << requestID << " " << *location << std::endl;
+        LOG_DEBUG_LIB(LibFdb5) << "Queuing for read: " << requestID << " " << *location << std::endl;
 
-    std::unique_ptr<eckit::DataHandle> dh;
-    dh.reset(location->dataHandle());
+        dh.reset(location->dataHandle());
+    }
+    catch (std::exception& e) {
+        // Without an acknowledgement, the client only learns of the failure through the data of the request
+        if (!agreedConf().pipelinedReads()) {
+            throw;
+        }
+        error(e.what(), clientID, requestID);
+        return false;
+    }
 
     readLocationQueue_.emplace(readLocationElem(clientID, requestID, std::move(dh)));
+    return true;
 }
 
 void StoreHandler::readLocationThreadLoop() {
@@ -176,7 +206,15 @@ void StoreHandler::writeToParent(const uint32_t clientID, const uint32_t request
         dh->openForRead();
         LOG_DEBUG_LIB(LibFdb5) << "Reading: " << requestID << " dh size: " << dh->size() << std::endl;
 
-        while ((dataRead = dh->read(writeBuffer, writeBuffer.size())) != 0) {
+        while (true) {
+            {
+                // n.b. the slot is not held while sending, so that a slow client does not take it from the others
+                auto slot = WorkScheduler::instance().acquire(readFlow_, writeBuffer.size());
+                dataRead = dh->read(writeBuffer, writeBuffer.size());
+            }
+            if (dataRead == 0) {
+                break;
+            }
             write(Message::Blob, false, clientID, requestID, writeBuffer, dataRead);
         }
 
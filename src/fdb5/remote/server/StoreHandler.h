@@ -38,7 +38,9 @@ private:  // methods
 
     void flush(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload);
 
-    void read(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload);
+    /// Queues the read of a field. Returns false if the request was dropped, its error having been reported on the
+    /// data connection, as pipelined reads are not acknowledged.
+    bool read(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload);
 
     void exists(uint32_t clientID, uint32_t requestID, const eckit::Buffer& payload) const;
 
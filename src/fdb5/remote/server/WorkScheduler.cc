@@ -0,0 +1,93 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <algorithm>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+
+#include "fdb5/remote/server/WorkScheduler.h"
+
+namespace fdb5::remote {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+WorkScheduler::Slot::~Slot() {
+    if (scheduler_) {
+        scheduler_->release();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+WorkScheduler::WorkScheduler(size_t slots) :
+    slots_(slots), busy_(0), virtualTime_(0), granted_(0), sequence_(0) {}
+
+WorkScheduler& WorkScheduler::instance() {
+    static WorkScheduler scheduler(eckit::Resource<size_t>("fdbServerWorkers;$FDB_SERVER_WORKERS", 0));
+    return scheduler;
+}
+
+double WorkScheduler::readWeight() {
+    static double weight = eckit::Resource<double>("fdbServerReadWeight;$FDB_SERVER_READ_WEIGHT", 4.0);
+    return weight;
+}
+
+WorkScheduler::Slot WorkScheduler::acquire(Flow& flow, size_t cost) {
+
+    if (slots_ == 0) {
+        return Slot(nullptr);
+    }
+
+    ASSERT(flow.weight_ > 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // A flow that has been idle starts from the current virtual time, and gets no credit for the idle period
+    const double start = std::max(flow.finish_, advance());
+    const double finish = start + double(std::max<size_t>(cost, 1)) / flow.weight_;
+    flow.finish_ = finish;
+
+    const auto ticket = waiting_.emplace(finish, sequence_++).first;
+    const auto started = starts_.insert(start);
+
+    cv_.wait(lock, [this, &ticket] { return busy_ < slots_ && waiting_.begin() == ticket; });
+
+    waiting_.erase(ticket);
+    starts_.erase(started);
+    granted_ = std::max(granted_, finish);
+    advance();
+    ++busy_;
+
+    // The next in line may take another free slot
+    cv_.notify_all();
+
+    return Slot(this);
+}
+
+double WorkScheduler::advance() {
+    virtualTime_ = std::max(virtualTime_, starts_.empty() ? granted_ : *starts_.begin());
+    return virtualTime_;
+}
+
+void WorkScheduler::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ASSERT(busy_ > 0);
+        --busy_;
+    }
+    cv_.notify_all();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::remote
@@ -0,0 +1,119 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   WorkScheduler.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <utility>
+
+namespace fdb5::remote {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Shares a fixed number of work slots of an fdb-server between the connections it serves.
+///
+/// The archive and retrieve workers of each connection take a slot for each piece of work (archiving a blob, reading
+/// a chunk of a field), which caps the work done at once by the whole server. Each connection has a flow for its
+/// archives and one for its retrieves, and waiting work is granted slots in weighted fair order (by virtual finish
+/// time, with the cost of the work in bytes), so that a connection archiving heavily cannot hold up the retrieves of
+/// the others.
+///
+/// As in start-time fair queuing, the virtual time is the smallest start tag of the waiting work (or, with none
+/// waiting, the largest finish tag granted), so a flow that becomes busy again queues from where the busy flows are.
+/// Over any period in which two flows f and g are both waiting, the work granted to each, divided by its weight,
+/// differs by at most cost_f / weight_f + cost_g / weight_g, for the largest piece of work of each.
+///
+/// The slots are shared by the connections of one process: a server with slots serves its connections in threads.
+class WorkScheduler {
+
+public:  // types
+
+    class Flow {
+    public:
+
+        explicit Flow(double weight) : weight_(weight), finish_(0) {}
+
+    private:
+
+        friend class WorkScheduler;
+
+        double weight_;
+        double finish_;  ///< virtual finish time of the last work of the flow
+    };
+
+    /// Holds a slot until destroyed
+    class Slot {
+    public:
+
+        explicit Slot(WorkScheduler* scheduler) : scheduler_(scheduler) {}
+        Slot(Slot&& other) : scheduler_(std::exchange(other.scheduler_, nullptr)) {}
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        Slot& operator=(Slot&&) = delete;
+        ~Slot();
+
+    private:
+
+        WorkScheduler* scheduler_;
+    };
+
+public:  // methods
+
+    /// @p slots of 0 means no limit, so that work is never held back
+    explicit WorkScheduler(size_t slots);
+
+    /// The scheduler shared by the connections of the server process, with the slots of $FDB_SERVER_WORKERS (none by
+    /// default)
+    static WorkScheduler& instance();
+
+    /// Weight of the retrieve flows, relative to the archive flows
+    static double readWeight();
+
+    /// Waits for a slot, for work of the given cost
+    Slot acquire(Flow& flow, size_t cost);
+
+    size_t slots() const { return slots_; }
+
+private:  // methods
+
+    void release();
+
+    /// Advances the virtual time to the smallest start tag of the waiting work, and returns it
+    double advance();
+
+private:  // members
+
+    const size_t slots_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    size_t busy_;
+    double virtualTime_;
+    double granted_;  ///< largest virtual finish time granted a slot
+    uint64_t sequence_;
+
+    /// (virtual finish time, arrival) of the waiting work
+    std::set<std::pair<double, uint64_t>> waiting_;
+
+    /// Virtual start times of the waiting work
+    std::multiset<double> starts_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::remote
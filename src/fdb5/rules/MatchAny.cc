@@ -9,6 +9,8 @@
  */
 
 #include <ostream>
+#include <set>
+#include <string>
 
 #include "fdb5/database/Key.h"
 #include "fdb5/rules/MatchAny.h"
@@ -60,6 +62,11 @@ bool MatchAny::match(const std::string& value) const {
     return (values_.find(value) != values_.end());
 }
 
+bool MatchAny::matchingValues(std::set<std::string>& values) const {
+    values.insert(values_.begin(), values_.end());
+    return true;
+}
+
 void MatchAny::dump(std::ostream& s, const std::string& keyword, const TypesRegistry& registry) const {
     const char* sep = "";
     registry.dump(s, keyword);
@@ -36,6 +36,8 @@ public:  // methods
 
     bool match(const std::string& keyword, const Key& key) const override;
 
+    bool matchingValues(std::set<std::string>& values) const override;
+
     void dump(std::ostream& s, const std::string& keyword, const TypesRegistry& registry) const override;
 
     const eckit::ReanimatorBase& reanimator() const override { return reanimator_; }
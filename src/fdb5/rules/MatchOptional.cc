@@ -90,15 +90,15 @@ const std::vector<std::string>& MatchOptional::values(const metkit::mars::MarsRe
 }
 
 const std::vector<std::string>& MatchOptional::optionalValues() const {
-    if (!optionalValues_) {
+    std::call_once(optionalValuesOnce_, [this] {
         if (!defaultValue().empty()) {
             optionalValues_ = std::vector<std::string>{defaultValue(), ""};
         }
         else {
             optionalValues_ = std::vector<std::string>{defaultValue()};
         }
-    }
-    return *optionalValues_;
+    });
+    return optionalValues_;
 }
 
 const std::string& MatchOptional::defaultValue() const {
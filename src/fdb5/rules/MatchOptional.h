@@ -17,7 +17,7 @@
 #define fdb5_MatchOptional_H
 
 #include <iosfwd>
-#include <optional>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -64,7 +64,9 @@ private:  // members
     static eckit::Reanimator<MatchOptional> reanimator_;
 
     std::vector<std::string> default_;
-    mutable std::optional<std::vector<std::string>> optionalValues_ = std::nullopt;
+    // built on first use, possibly from several threads sharing the schema
+    mutable std::once_flag optionalValuesOnce_;
+    mutable std::vector<std::string> optionalValues_;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -9,6 +9,7 @@
  */
 
 #include <ostream>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -49,6 +50,11 @@ bool MatchValue::match(const std::string& keyword, const Key& key) const {
     return false;
 }
 
+bool MatchValue::matchingValues(std::set<std::string>& values) const {
+    values.insert(value_);
+    return true;
+}
+
 void MatchValue::dump(std::ostream& s, const std::string& keyword, const TypesRegistry& registry) const {
     registry.dump(s, keyword);
     s << "=" << value_;
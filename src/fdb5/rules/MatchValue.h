@@ -17,6 +17,7 @@
 #define fdb5_MatchValue_H
 
 #include <iosfwd>
+#include <set>
 #include <string>
 
 #include "fdb5/rules/Matcher.h"
@@ -37,6 +38,8 @@ public:  // methods
 
     bool match(const std::string& keyword, const Key& key) const override;
 
+    bool matchingValues(std::set<std::string>& values) const override;
+
     void dump(std::ostream& out, const std::string& keyword, const TypesRegistry& registry) const override;
 
     // streamable
@@ -17,6 +17,8 @@
 #define fdb5_Matcher_H
 
 #include <iosfwd>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "eckit/serialisation/Streamable.h"
@@ -52,6 +54,9 @@ public:  // methods
 
     virtual const std::string& defaultValue() const;
 
+    /// If only the listed values match, and keys without the keyword do not match, adds them to @p values
+    virtual bool matchingValues(std::set<std::string>& /* values */) const { return false; }
+
     virtual bool match(const std::string& value) const = 0;
     virtual bool match(const std::string& keyword, const Key& key) const = 0;
     virtual void fill(Key& key, const std::string& keyword, const std::string& value) const;
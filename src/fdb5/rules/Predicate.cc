@@ -9,6 +9,7 @@
  */
 
 #include <ostream>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -64,6 +65,10 @@ bool Predicate::optional() const {
     return matcher_->optional();
 }
 
+bool Predicate::matchingValues(std::set<std::string>& values) const {
+    return matcher_->matchingValues(values);
+}
+
 const std::string& Predicate::value(const Key& key) const {
     return matcher_->value(key, keyword_);
 }
@@ -18,6 +18,7 @@
 
 #include <iosfwd>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -64,6 +65,9 @@ public:  // methods
 
     bool optional() const;
 
+    /// If only the listed values match, and keys without the keyword do not match, adds them to @p values
+    bool matchingValues(std::set<std::string>& values) const;
+
     const std::string& keyword() const { return keyword_; }
 
     // streamable
@@ -10,10 +10,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <list>
+#include <map>
 #include <optional>
 #include <ostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -78,40 +82,63 @@ public:  // methods
     std::size_t size() const { return nodes_.size(); }
 
     std::vector<Key> makeKeys() const {
-        std::set<Key> seen;
         std::vector<Key> keys;
+        visitKeys([&keys](const Key& key) { keys.push_back(key); });
+        return keys;
+    }
+
+    /// Calls @p visit on each key, in turn, without materialising the cross-product of the values
+    void visitKeys(const std::function<void(const Key&)>& visit) const {
 
-        if (!nodes_.empty()) {
-            Key key;
-            visit(nodes_.begin(), key, seen, keys);
+        if (nodes_.empty()) {
+            return;
         }
 
-        return keys;
+        Key key;
+
+        // Distinct values under distinct keywords make distinct keys, which we don't need to remember
+        if (distinct_) {
+            visitNode(nodes_.begin(), key, visit);
+            return;
+        }
+
+        std::set<Key> seen;
+        visitNode(nodes_.begin(), key, [&seen, &visit](const Key& candidate) {
+            if (seen.insert(candidate).second) {
+                visit(candidate);
+            }
+        });
     }
 
+    /// Canonicalises the keywords and values, and drops the values that become repeated. This does not change the
+    /// order in which the keys are first visited.
     void canonicalise(const TypesRegistry& registry) {
+        std::set<std::string> keywords;
+        distinct_ = true;
         for (auto& [keyword, values] : nodes_) {
             const auto& type = registry.lookupType(keyword);
-            for (auto& value : values) {
-                if (!value.empty()) {
-                    value = type.toKey(value);
+            std::set<std::string> seen;
+            eckit::StringList canonical;
+            canonical.reserve(values.size());
+            for (const auto& value : values) {
+                std::string v = value.empty() ? value : type.toKey(value);
+                if (seen.insert(v).second) {
+                    canonical.push_back(std::move(v));
                 }
             }
+            values = std::move(canonical);
             keyword = type.alias();
+            distinct_ = distinct_ && keywords.insert(keyword).second;
         }
     }
 
 private:  // methods
 
     // Recursive DFS (depth-first search) to generate all possible keys
-    void visit(const_iterator iter, Key& key, std::set<Key>& seen, std::vector<Key>& keys) const {
+    void visitNode(const_iterator iter, Key& key, const std::function<void(const Key&)>& visit) const {
 
         if (iter == nodes_.end()) {
-            auto it = seen.find(key);
-            if (it == seen.end()) {
-                seen.insert(key);
-                keys.push_back(key);
-            }
+            visit(key);
             return;
         }
 
@@ -122,7 +149,7 @@ private:  // methods
 
         for (const auto& value : values) {
             key.push(keyword, value);
-            visit(next, key, seen, keys);
+            visitNode(next, key, visit);
             key.pop(keyword);
         }
     }
@@ -130,6 +157,9 @@ private:  // methods
 private:  // members
 
     value_type nodes_;
+
+    /// Whether the values of each node, and the keywords of the nodes, are distinct
+    bool distinct_{false};
 };
 
 }  // namespace
@@ -325,7 +355,8 @@ std::vector<Key> Rule::findMatchingKeys(const metkit::mars::MarsRequest& request
     return graph.makeKeys();
 }
 
-std::vector<Key> Rule::findMatchingKeys(const metkit::mars::MarsRequest& request, ReadVisitor& visitor) const {
+void Rule::visitMatchingKeys(const metkit::mars::MarsRequest& request, ReadVisitor& visitor,
+                             const std::function<void(const Key&)>& visit) const {
 
     RuleGraph graph;
 
@@ -340,7 +371,7 @@ std::vector<Key> Rule::findMatchingKeys(const metkit::mars::MarsRequest& request
                 values = pred->optionalValues();
             }
             else {
-                return {};
+                return;
             }
         }
         else {
@@ -359,13 +390,13 @@ std::vector<Key> Rule::findMatchingKeys(const metkit::mars::MarsRequest& request
                 node.emplace_back("");
             }
             else {
-                return {};
+                return;
             }
         }
     }
 
     graph.canonicalise(registry_);
-    return graph.makeKeys();
+    graph.visitKeys(visit);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -379,6 +410,24 @@ bool Rule::match(const Key& key) const {
     return true;
 }
 
+std::map<std::string, std::set<std::string>> Rule::constraints() const {
+    std::map<std::string, std::set<std::string>> result;
+    for (const auto& pred : predicates_) {
+        std::set<std::string> values;
+        if (!pred->matchingValues(values)) {
+            continue;
+        }
+        // A keyword restricted twice only takes the values allowed by both predicates
+        if (auto [iter, inserted] = result.emplace(pred->keyword(), values); !inserted) {
+            std::set<std::string> both;
+            std::set_intersection(iter->second.begin(), iter->second.end(), values.begin(), values.end(),
+                                  std::inserter(both, both.end()));
+            iter->second = std::move(both);
+        }
+    }
+    return result;
+}
+
 bool Rule::tryFill(Key& key, const eckit::StringList& values) const {
     // See FDB-103. This is a hack to work around the indexing abstraction
     // being leaky.
@@ -438,7 +487,10 @@ Key Rule::makeKey(const std::string& keyFingerprint) const {
     Key key;
 
     /// @note assumed keyFingerprint is canonical
-    const auto values = eckit::Tokenizer(":", true).tokenize(keyFingerprint);
+    eckit::StringList values;
+    if (!Key::fingerprintToValues(keyFingerprint, values)) {
+        values = eckit::Tokenizer(":", true).tokenize(keyFingerprint);
+    }
 
     fill(key, values);
 
@@ -540,14 +592,13 @@ void RuleDatum::encode(eckit::Stream& out) const {
 
 void RuleDatum::expand(const metkit::mars::MarsRequest& request, ReadVisitor& visitor, Key& full) const {
 
-    for (const auto& key : findMatchingKeys(request, visitor)) {
-
+    visitMatchingKeys(request, visitor, [&visitor, &full](const Key& key) {
         full.pushFrom(key);
 
         visitor.selectDatum(key, full);
 
         full.popFrom(key);
-    }
+    });
 }
 
 bool RuleDatum::expand(const Key& field, WriteVisitor& visitor, Key& full) const {
@@ -605,13 +656,13 @@ void RuleIndex::updateParent(const Rule* parent) {
 }
 
 void RuleIndex::expand(const metkit::mars::MarsRequest& request, ReadVisitor& visitor, Key& full) const {
-    for (const auto& key : findMatchingKeys(request, visitor)) {
+    visitMatchingKeys(request, visitor, [this, &request, &visitor, &full](const Key& key) {
         full.pushFrom(key);
         if (visitor.selectIndex(key)) {
             rule_->expand(request, visitor, full);
         }
         full.popFrom(key);
-    }
+    });
 }
 
 bool RuleIndex::expand(const Key& field, WriteVisitor& visitor, Key& full) const {
@@ -637,7 +688,7 @@ bool RuleIndex::expand(const Key& field, WriteVisitor& visitor, Key& full) const
 
 RuleDatabase::RuleDatabase(const std::size_t line, Predicates& predicates, const eckit::StringDict& types,
                            Children& rules) :
-    Rule(line, predicates, types), rules_{std::move(rules)} {}
+    Rule(line, predicates, types), rules_{std::move(rules)}, tree_{rules_} {}
 
 RuleDatabase::RuleDatabase(eckit::Stream& stream) : Rule() {
     decode(stream);
@@ -649,6 +700,8 @@ RuleDatabase::RuleDatabase(eckit::Stream& stream) : Rule() {
     for (size_t i = 0; i < numRules; i++) {
         rules_.emplace_back(new RuleIndex(stream));
     }
+
+    tree_ = RuleDecisionTree(rules_);
 }
 
 void RuleDatabase::encode(eckit::Stream& out) const {
@@ -667,7 +720,8 @@ void RuleDatabase::updateParent(const Rule* /* parent */) {
 
 void RuleDatabase::expand(const metkit::mars::MarsRequest& request, ReadVisitor& visitor) const {
 
-    for (auto& key : findMatchingKeys(request, visitor)) {
+    visitMatchingKeys(request, visitor, [&request, &visitor](const Key& dbKey) {
+        Key key = dbKey;
 
         if (visitor.selectDatabase(key, key)) {
             // (important) using the database's schema
@@ -676,7 +730,7 @@ void RuleDatabase::expand(const metkit::mars::MarsRequest& request, ReadVisitor&
             }
             visitor.deselectDatabase();
         }
-    }
+    });
 }
 
 bool RuleDatabase::expand(const Key& field, WriteVisitor& visitor) const {
@@ -685,8 +739,9 @@ bool RuleDatabase::expand(const Key& field, WriteVisitor& visitor) const {
 
         if (visitor.selectDatabase(*key, *key)) {
             // (important) using the database's schema
-            for (const auto& rule : visitor.databaseSchema().matchingRule(*key).rules()) {
-                if (rule->expand(field, visitor, *key)) {
+            const auto& dbRule = visitor.databaseSchema().matchingRule(*key);
+            for (size_t i : dbRule.candidates(field)) {
+                if (dbRule.rules_[i]->expand(field, visitor, *key)) {
                     return true;
                 }
             }
@@ -17,15 +17,20 @@
 #define fdb5_Rule_H
 
 #include <cstddef>
+#include <functional>
 #include <iosfwd>
+#include <map>
 #include <memory>
 #include <optional>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "eckit/serialisation/Reanimator.h"
 #include "eckit/serialisation/Streamable.h"
 #include "eckit/types/Types.h"
 
+#include "fdb5/rules/RuleDecisionTree.h"
 #include "fdb5/types/TypesRegistry.h"
 
 namespace metkit::mars {
@@ -63,6 +68,9 @@ public:  // methods
 
     bool match(const Key& key) const;
 
+    /// The keywords that the rule restricts to a listed set of values, with these values
+    std::map<std::string, std::set<std::string>> constraints() const;
+
     void check(const Key& key) const;
 
     void dump(std::ostream& out) const;
@@ -85,7 +93,9 @@ protected:  // methods
 
     std::optional<Key> findMatchingKey(const Key& field) const;
 
-    std::vector<Key> findMatchingKeys(const metkit::mars::MarsRequest& request, ReadVisitor& visitor) const;
+    /// Calls @p visit with each key of the request that matches the rule, as the keys are enumerated
+    void visitMatchingKeys(const metkit::mars::MarsRequest& request, ReadVisitor& visitor,
+                           const std::function<void(const Key&)>& visit) const;
 
 private:  // methods
 
@@ -231,6 +241,9 @@ public:  // methods
 
     const Children& rules() const { return rules_; }
 
+    /// The positions in rules() of the index rules that may match @p key. The other rules do not match it.
+    const std::vector<size_t>& candidates(const Key& key) const { return tree_.candidates(key); }
+
     const char* type() const override { return "RuleDatabase"; }
 
     // streamable
@@ -253,6 +266,8 @@ private:  // members
 
     Children rules_;
 
+    RuleDecisionTree tree_;
+
     // streamable
 
     static eckit::ClassSpec classSpec_;
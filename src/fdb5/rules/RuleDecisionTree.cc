@@ -0,0 +1,135 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fdb5/database/Key.h"
+#include "fdb5/rules/Rule.h"
+#include "fdb5/rules/RuleDecisionTree.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+RuleDecisionTree::RuleDecisionTree() : nodes_(1) {}
+
+void RuleDecisionTree::build(const std::vector<const Rule*>& rules) {
+
+    Constraints constraints;
+    constraints.reserve(rules.size());
+    for (const auto* rule : rules) {
+        constraints.push_back(rule->constraints());
+    }
+
+    std::vector<size_t> all(rules.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        all[i] = i;
+    }
+
+    nodes_.clear();
+    std::set<std::string> tested;
+    build(constraints, std::move(all), tested);
+}
+
+size_t RuleDecisionTree::build(const Constraints& constraints, std::vector<size_t> rules,
+                               std::set<std::string>& tested) {
+
+    const size_t id = nodes_.size();
+    nodes_.emplace_back();
+
+    // Test the keyword that the most rules restrict, which is the one that discards the most rules on average
+    std::string keyword;
+    if (rules.size() > 1) {
+        std::map<std::string, size_t> restricted;
+        for (size_t rule : rules) {
+            for (const auto& [kw, values] : constraints[rule]) {
+                if (tested.find(kw) == tested.end()) {
+                    ++restricted[kw];
+                }
+            }
+        }
+        size_t best = 0;
+        for (const auto& [kw, count] : restricted) {
+            if (count > best) {
+                best = count;
+                keyword = kw;
+            }
+        }
+    }
+
+    if (keyword.empty()) {
+        nodes_[id].rules_ = std::move(rules);
+        return id;
+    }
+
+    std::vector<size_t> unrestricted;
+    std::map<std::string, std::vector<size_t>> byValue;
+    for (size_t rule : rules) {
+        auto it = constraints[rule].find(keyword);
+        if (it == constraints[rule].end()) {
+            unrestricted.push_back(rule);
+            continue;
+        }
+        for (const auto& value : it->second) {
+            byValue[value].push_back(rule);
+        }
+    }
+
+    tested.insert(keyword);
+
+    // n.b. building the children appends to nodes_, so we fill in this node afterwards
+    std::unordered_map<std::string, size_t> children;
+    for (const auto& [value, accepting] : byValue) {
+        std::vector<size_t> merged;
+        merged.reserve(accepting.size() + unrestricted.size());
+        std::merge(accepting.begin(), accepting.end(), unrestricted.begin(), unrestricted.end(),
+                   std::back_inserter(merged));
+        children.emplace(value, build(constraints, std::move(merged), tested));
+    }
+    const size_t otherwise = build(constraints, std::move(unrestricted), tested);
+
+    tested.erase(keyword);
+
+    Node& node = nodes_[id];
+    node.keyword_ = std::move(keyword);
+    node.values_ = std::move(children);
+    node.otherwise_ = otherwise;
+
+    return id;
+}
+
+const std::vector<size_t>& RuleDecisionTree::candidates(const Key& key) const {
+
+    const Node* node = &nodes_.front();
+
+    while (!node->keyword_.empty()) {
+        size_t next = node->otherwise_;
+        if (const auto [iter, found] = key.find(node->keyword_); found) {
+            if (auto child = node->values_.find(iter->second); child != node->values_.end()) {
+                next = child->second;
+            }
+        }
+        node = &nodes_[next];
+    }
+
+    return node->rules_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
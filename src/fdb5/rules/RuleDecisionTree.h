@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   RuleDecisionTree.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fdb5 {
+
+class Key;
+class Rule;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Selects, from a list of sibling rules, the ones that may match a key, without evaluating their predicates.
+///
+/// Each node of the tree tests the value of one keyword, chosen amongst those that the rules restrict to a listed set
+/// of values (e.g. class=od/rd), and has a child for each of these values. A rule is in the subtree of each value it
+/// accepts, and, if it does not restrict the keyword, in all the subtrees. The leaves list the remaining rules in
+/// their original order, so the first of them to match is the rule that a walk through the whole list would find.
+class RuleDecisionTree {
+
+public:  // methods
+
+    RuleDecisionTree();
+
+    template <typename T>
+    explicit RuleDecisionTree(const std::vector<std::unique_ptr<T>>& rules) : RuleDecisionTree() {
+        std::vector<const Rule*> list;
+        list.reserve(rules.size());
+        for (const auto& rule : rules) {
+            list.push_back(rule.get());
+        }
+        build(list);
+    }
+
+    /// The positions of the rules that may match @p key, in increasing order. The other rules do not match it.
+    const std::vector<size_t>& candidates(const Key& key) const;
+
+    /// The number of nodes
+    size_t size() const { return nodes_.size(); }
+
+private:  // types
+
+    using Constraints = std::vector<std::map<std::string, std::set<std::string>>>;
+
+    struct Node {
+        std::string keyword_;                             ///< empty for a leaf
+        std::unordered_map<std::string, size_t> values_;  ///< child for each listed value of the keyword
+        size_t otherwise_{0};                             ///< child for other values, or if the keyword is missing
+        std::vector<size_t> rules_;                       ///< candidates, at a leaf
+    };
+
+private:  // methods
+
+    void build(const std::vector<const Rule*>& rules);
+
+    size_t build(const Constraints& constraints, std::vector<size_t> rules, std::set<std::string>& tested);
+
+private:  // members
+
+    std::vector<Node> nodes_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -89,11 +89,13 @@ Schema::~Schema() {
 
 const RuleDatum& Schema::matchingRule(const Key& dbKey, const Key& idxKey) const {
 
-    for (const auto& dbRule : rules_) {
+    for (size_t i : tree_.candidates(dbKey)) {
+        const auto& dbRule = rules_[i];
         if (!dbRule->match(dbKey)) {
             continue;
         }
-        for (const auto& idxRule : dbRule->rules()) {
+        for (size_t j : dbRule->candidates(idxKey)) {
+            const auto& idxRule = dbRule->rules()[j];
             if (!idxRule->match(idxKey)) {
                 continue;
             }
@@ -108,9 +110,9 @@ const RuleDatum& Schema::matchingRule(const Key& dbKey, const Key& idxKey) const
 
 const RuleDatabase& Schema::matchingRule(const Key& dbKey) const {
 
-    for (const auto& rule : rules_) {
-        if (rule->match(dbKey)) {
-            return *rule;
+    for (size_t i : tree_.candidates(dbKey)) {
+        if (rules_[i]->match(dbKey)) {
+            return *rules_[i];
         }
     }
 
@@ -142,8 +144,9 @@ void Schema::expand(const Key& field, WriteVisitor& visitor) const {
 
     visitor.rule(nullptr);  // reset to no rule so we verify that we pick at least one
 
-    for (const auto& rule : rules_) {
-        if (rule->expand(field, visitor)) {
+    // n.b. the rules that are not candidates would not match the field, so we can skip them
+    for (size_t i : tree_.candidates(field)) {
+        if (rules_[i]->expand(field, visitor)) {
             break;
         }
     }
@@ -215,6 +218,7 @@ void Schema::load(std::istream& s, const bool replace) {
 
 void Schema::clear() {
     rules_.clear();
+    tree_ = RuleDecisionTree();
 }
 
 void Schema::dump(std::ostream& s) const {
@@ -226,10 +230,16 @@ void Schema::dump(std::ostream& s) const {
 }
 
 void Schema::check() {
+    registry_.resolveTypes();
     for (auto& rule : rules_) {
         rule->registry_.updateParent(registry_);
         rule->updateParent(nullptr);
     }
+
+    tree_ = RuleDecisionTree(rules_);
+
+    LOG_DEBUG_LIB(LibFdb5) << "Schema " << path_ << ": " << rules_.size() << " database rules, decision tree of "
+                           << tree_.size() << " nodes" << std::endl;
 }
 
 void Schema::print(std::ostream& out) const {
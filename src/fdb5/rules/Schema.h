@@ -31,6 +31,7 @@
 
 #include "fdb5/config/Config.h"
 #include "fdb5/rules/Rule.h"
+#include "fdb5/rules/RuleDecisionTree.h"
 
 namespace metkit::mars {
 class MarsRequest;
@@ -121,6 +122,8 @@ private:  // members
 
     RuleList rules_;
 
+    RuleDecisionTree tree_;
+
     std::string path_;
 
     // streamable
@@ -8,7 +8,10 @@
  * does it submit to any jurisdiction.
  */
 
+#include <sstream>
+
 #include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
 #include "eckit/log/BigNum.h"
 
 #include "fdb5/toc/BTreeIndex.h"
@@ -129,6 +132,31 @@ void TBTreeIndex<KEYSIZE, RECSIZE, PAYLOAD>::preload() {
     btree_.preload();
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+
+/// BTree index keyed on binary fingerprints (see Key::valuesToFingerprint) instead of colon-separated values.
+/// It has its own type names so that readers that only know colon-separated fingerprints reject it.
+template <int KEYSIZE, int RECSIZE, typename PAYLOAD>
+class TBinaryBTreeIndex : public TBTreeIndex<KEYSIZE, RECSIZE, PAYLOAD> {
+
+public:  // methods
+
+    using TBTreeIndex<KEYSIZE, RECSIZE, PAYLOAD>::TBTreeIndex;
+
+private:  // methods
+
+    void fingerprint(const Key& key, std::string& out) const override {
+        key.valuesToFingerprint(out);
+        // The binary form is 2 bytes longer than the colon-separated one, so some keys only fit in the latter
+        if (out.size() > KEYSIZE) {
+            std::ostringstream oss;
+            oss << "Key " << key << " has a binary fingerprint of " << out.size() << " bytes, longer than the "
+                << KEYSIZE << " bytes of the index type";
+            throw eckit::UserError(oss.str(), Here());
+        }
+    }
+};
+
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -146,11 +174,26 @@ BTREE(32, 65536, FieldRefFull);
 BTREE(32, 4194304, FieldRefReduced);
 BTREE(64, 65536, FieldRefReduced);
 
+#define BINARYBTREE(KEYSIZE, RECSIZE, PAYLOAD)                                                                         \
+    struct BTreeIndexBinary_##KEYSIZE##_##RECSIZE##_##PAYLOAD : public TBinaryBTreeIndex<KEYSIZE, RECSIZE, PAYLOAD> {  \
+        BTreeIndexBinary_##KEYSIZE##_##RECSIZE##_##PAYLOAD(const eckit::PathName& path, bool readOnly, off_t offset) : \
+            TBinaryBTreeIndex<KEYSIZE, RECSIZE, PAYLOAD>(path, readOnly, offset){};                                    \
+    };                                                                                                                 \
+    static BTreeIndexBuilder<BTreeIndexBinary_##KEYSIZE##_##RECSIZE##_##PAYLOAD>                                       \
+        maker_BTreeIndexBinary_##KEYSIZE##_##RECSIZE##_##PAYLOAD("BTreeIndexBinary_" #KEYSIZE "_" #RECSIZE "_" #PAYLOAD)
+
+BINARYBTREE(32, 65536, FieldRefReduced);
+BINARYBTREE(64, 65536, FieldRefReduced);
+
 
 //----------------------------------------------------------------------------------------------------------------------
 
 BTreeIndex::~BTreeIndex() {}
 
+void BTreeIndex::fingerprint(const Key& key, std::string& out) const {
+    out = key.valuesToString();
+}
+
 static std::string defaultIndexType = "BTreeIndex";
 static std::string wideIndexType = "BTreeIndex64";
 
@@ -166,6 +209,9 @@ static BTreeIndexBuilder<BTreeIndex_64_65536_FieldRefReduced> wideIndex(wideInde
 static BTreeIndexBuilder<BTreeIndex_32_65536_FieldRefFull> PointDBIndex("PointDBIndex");
 static BTreeIndexBuilder<BTreeIndex_32_4194304_FieldRefReduced> BTreeIndex4MB("BTreeIndex4MB");
 
+static BTreeIndexBuilder<BTreeIndexBinary_32_65536_FieldRefReduced> binaryIndex("BTreeIndexBinary");
+static BTreeIndexBuilder<BTreeIndexBinary_64_65536_FieldRefReduced> wideBinaryIndex("BTreeIndexBinary64");
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace fdb5
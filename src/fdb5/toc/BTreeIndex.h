@@ -52,6 +52,9 @@ public:
     virtual void funlock() = 0;
     virtual void preload() = 0;
 
+    /// Encodes a datum key into the fingerprint used as the key of this index
+    virtual void fingerprint(const Key& key, std::string& out) const;
+
 
     static const std::string& defaultType(size_t keySize);
 };
@@ -0,0 +1,290 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/Stat.h"
+#include "eckit/utils/StringTools.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/toc/RootCatalogue.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+const char* catalogueName = ".fdb-catalogue";
+
+/// Starts the lines recording the generation of the root
+const std::string generationTag = "#\t";
+
+/// The modification time of a directory, to the resolution of the file system
+std::string generation(const eckit::Stat::Struct& info) {
+#if defined(__APPLE__)
+    const struct timespec& mtime = info.st_mtimespec;
+#else
+    const struct timespec& mtime = info.st_mtim;
+#endif
+    std::ostringstream out;
+    out << mtime.tv_sec << '.' << mtime.tv_nsec;
+    return out.str();
+}
+
+/// Records the current generation of @p root at the end of the catalogue open in @p fd
+void appendGeneration(int fd, const eckit::PathName& root, const std::string& entries) {
+    eckit::Stat::Struct info;
+    SYSCALL2(eckit::Stat::stat(root.localPath(), &info), root);
+    // A single write, so that concurrent readers see either none or all of the update
+    const std::string update = entries + generationTag + generation(info) + '\n';
+    if (::write(fd, update.c_str(), update.size()) != ssize_t(update.size())) {
+        eckit::Log::warning() << "Cannot update root catalogue of " << root << eckit::Log::syserr << std::endl;
+    }
+}
+
+/// Opens the catalogue for update, locked against other updates. A removal replaces the file, so once the lock is
+/// taken we make sure that it is still the catalogue. The file takes the permissions of the root, within the umask.
+int openLocked(const eckit::PathName& path) {
+
+    eckit::Stat::Struct rootInfo;
+    SYSCALL2(eckit::Stat::stat(path.dirName().localPath(), &rootInfo), path.dirName());
+    const mode_t mode = rootInfo.st_mode & 0666;
+
+    for (;;) {
+        int fd;
+        SYSCALL2(fd = ::open(path.localPath(), O_RDWR | O_CREAT | O_APPEND, mode), path);
+
+        if (::flock(fd, LOCK_EX) != 0) {
+            // Not supported by the file system: appends are still atomic
+            LOG_DEBUG_LIB(LibFdb5) << "Cannot lock " << path << eckit::Log::syserr << std::endl;
+            return fd;
+        }
+
+        eckit::Stat::Struct opened;
+        eckit::Stat::Struct current;
+        if (eckit::Stat::fstat(fd, &opened) == 0 && eckit::Stat::stat(path.localPath(), &current) == 0 &&
+            opened.st_dev == current.st_dev && opened.st_ino == current.st_ino) {
+            return fd;
+        }
+
+        ::close(fd);
+    }
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The parsed contents of a catalogue file, as of a given state of the file
+struct RootCatalogue::Contents {
+
+    dev_t device = 0;
+    ino_t inode = 0;
+    off_t size = 0;
+    std::string modified;
+
+    Databases databases;
+
+    /// The directory names of the databases, by their lowercase names
+    std::map<std::string, std::string> lowercase;
+
+    /// The generation of the root recorded by the last update, empty if the file is incomplete or inconsistent
+    std::string generation;
+
+    bool sameFile(const eckit::Stat::Struct& info) const {
+        return device == info.st_dev && inode == info.st_ino && size == info.st_size &&
+               modified == fdb5::generation(info);
+    }
+};
+
+bool RootCatalogue::enabled() {
+    static bool enabled = eckit::Resource<bool>("fdbRootCatalogue;$FDB_ROOT_CATALOGUE", false);
+    return enabled;
+}
+
+eckit::PathName RootCatalogue::path(const eckit::PathName& root) {
+    return root / catalogueName;
+}
+
+RootCatalogue::RootCatalogue(const eckit::PathName& root) : contents_(std::make_shared<Contents>()), usable_(false) {
+
+    if (!enabled()) {
+        return;
+    }
+
+    const eckit::PathName file = path(root);
+
+    eckit::Stat::Struct rootInfo;
+    eckit::Stat::Struct fileInfo;
+    if (eckit::Stat::stat(root.localPath(), &rootInfo) != 0 || eckit::Stat::stat(file.localPath(), &fileInfo) != 0) {
+        return;
+    }
+
+    // The contents parsed by any catalogue of this process, while the file is unchanged
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const Contents>> parsed;
+
+    const std::string name = file.asString();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = parsed.find(name); it != parsed.end() && it->second->sameFile(fileInfo)) {
+            contents_ = it->second;
+        }
+    }
+
+    if (contents_->modified.empty()) {
+        auto contents = std::make_shared<Contents>();
+        contents->device   = fileInfo.st_dev;
+        contents->inode    = fileInfo.st_ino;
+        contents->size     = fileInfo.st_size;
+        contents->modified = generation(fileInfo);
+
+        std::ifstream in(file.localPath());
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, generationTag.size(), generationTag) == 0) {
+                contents->generation = line.substr(generationTag.size());
+                continue;
+            }
+            // An entry must be followed by a generation
+            contents->generation.clear();
+            // n.b. a line may be partial, if a writer died while appending it. The catalogue is then not used.
+            const auto tab = line.find('\t');
+            if (tab == std::string::npos || tab == 0) {
+                break;
+            }
+            try {
+                const std::string db = line.substr(0, tab);
+                contents->databases[db] = Key::parse(line.substr(tab + 1));
+                contents->lowercase[eckit::StringTools::lower(db)] = db;
+            }
+            catch (const eckit::Exception&) {
+                break;
+            }
+        }
+        if (!in.eof()) {
+            contents->generation.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        parsed[name] = contents;
+        contents_    = contents;
+    }
+
+    usable_ = !contents_->generation.empty() && contents_->generation == generation(rootInfo);
+    if (usable_ && rootInfo.st_nlink >= 2) {
+        // The file system counts subdirectories: also catch changes within the resolution of its timestamps
+        usable_ = (rootInfo.st_nlink - 2 == contents_->databases.size());
+    }
+
+    LOG_DEBUG_LIB(LibFdb5) << "Root catalogue " << file << " lists " << contents_->databases.size() << " databases"
+                           << (usable_ ? "" : ", and is stale") << std::endl;
+}
+
+const RootCatalogue::Databases& RootCatalogue::databases() const {
+    return contents_->databases;
+}
+
+const RootCatalogue::Databases::value_type* RootCatalogue::find(const std::string& name) const {
+    const auto it = contents_->lowercase.find(eckit::StringTools::lower(name));
+    if (it == contents_->lowercase.end()) {
+        return nullptr;
+    }
+    return &*contents_->databases.find(it->second);
+}
+
+void RootCatalogue::add(const eckit::PathName& directory, const Key& dbKey) {
+
+    if (!enabled()) {
+        return;
+    }
+
+    const eckit::PathName root = directory.dirName();
+
+    std::ostringstream line;
+    line << directory.baseName().asString() << '\t' << dbKey.toString() << '\n';
+
+    // n.b. the root generation is read once the catalogue exists, as creating it changes the root
+    int fd = openLocked(path(root));
+    appendGeneration(fd, root, line.str());
+    ::close(fd);
+}
+
+void RootCatalogue::remove(const eckit::PathName& directory) {
+
+    if (!enabled()) {
+        return;
+    }
+
+    const eckit::PathName root = directory.dirName();
+    const eckit::PathName file = path(root);
+    if (!file.exists()) {
+        return;
+    }
+
+    const std::string prefix = directory.baseName().asString() + '\t';
+
+    int fd = openLocked(file);
+
+    // Without the generations, which the update records anew
+    std::string kept;
+    {
+        std::ifstream in(file.localPath());
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, prefix.size(), prefix) != 0 &&
+                line.compare(0, generationTag.size(), generationTag) != 0) {
+                kept += line + '\n';
+            }
+        }
+    }
+
+    eckit::Stat::Struct info;
+    SYSCALL2(eckit::Stat::fstat(fd, &info), file);
+
+    // Replace the catalogue atomically, while holding the lock on the old one
+    eckit::PathName tmp = eckit::PathName::unique(file);
+    {
+        std::ofstream out(tmp.localPath());
+        out << kept;
+        if (!out.good()) {
+            ::close(fd);
+            tmp.unlink(false);
+            eckit::Log::warning() << "Cannot remove " << directory << " from root catalogue " << file << std::endl;
+            return;
+        }
+    }
+    SYSCALL2(::chmod(tmp.localPath(), info.st_mode & 07777), tmp);
+    eckit::PathName::rename(tmp, file);
+    ::close(fd);
+
+    // The rename changed the root
+    fd = openLocked(file);
+    appendGeneration(fd, root, "");
+    ::close(fd);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
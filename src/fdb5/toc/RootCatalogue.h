@@ -0,0 +1,86 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   RootCatalogue.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "eckit/filesystem/PathName.h"
+
+#include "fdb5/database/Key.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A file in a root listing the databases of the root, with their keys, so that they can be found without scanning
+/// the root and opening the TOC of each candidate.
+///
+/// Entries are appended when a TOC is initialised, and removed when a database is wiped. Each update also records
+/// the modification time of the root, as a generation, once the database directory has been created or removed. The
+/// catalogue is only used while the root still has that modification time, and, on file systems that count
+/// subdirectories in the link count of their parent, while it lists as many databases as the root has
+/// subdirectories. Databases created or removed without updating the catalogue (e.g. by older versions of FDB) thus
+/// make it stale, and the root is then scanned as before.
+///
+/// The contents of a catalogue are parsed once, and shared by the catalogues of its root until the file changes.
+class RootCatalogue {
+
+public:  // types
+
+    /// The databases of the root, by directory name
+    using Databases = std::map<std::string, Key>;
+
+public:  // methods
+
+    /// Whether catalogues are maintained and used ($FDB_ROOT_CATALOGUE)
+    static bool enabled();
+
+    /// Loads the catalogue of @p root, if enabled and present
+    explicit RootCatalogue(const eckit::PathName& root);
+
+    /// Whether the catalogue lists exactly the databases of the root
+    bool usable() const { return usable_; }
+
+    /// The databases of the root, by directory name
+    const Databases& databases() const;
+
+    /// The database of the directory @p name, compared ignoring case as the scan of a root does, if listed
+    const Databases::value_type* find(const std::string& name) const;
+
+    /// Records the database in @p directory in the catalogue of its root
+    static void add(const eckit::PathName& directory, const Key& dbKey);
+
+    /// Removes the database in @p directory from the catalogue of its root
+    static void remove(const eckit::PathName& directory);
+
+private:  // types
+
+    struct Contents;
+
+private:  // methods
+
+    static eckit::PathName path(const eckit::PathName& root);
+
+private:  // members
+
+    std::shared_ptr<const Contents> contents_;
+
+    bool usable_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
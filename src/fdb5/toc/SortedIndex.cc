@@ -0,0 +1,522 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/types/FixedString.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/toc/BTreeIndex.h"
+#include "fdb5/toc/FieldRef.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// On-disk header, at the index offset, followed by the entries sorted by key. The entries start at the first
+/// position after the header that is aligned for them, as the index offset (the size of the file when the index was
+/// created) is arbitrary and the entries are read in place from the mapped file.
+struct SortedIndexHeader {
+    char magic_[8];
+    uint32_t version_;
+    uint32_t keySize_;
+    uint64_t entrySize_;
+    uint64_t count_;
+};
+
+const char sortedIndexMagic[8] = {'F', 'D', 'B', 'S', 'I', 'D', 'X', '\0'};
+const uint32_t sortedIndexVersion = 1;
+
+void pwriteAll(int fd, const void* data, size_t len, off_t offset, const eckit::PathName& path) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n;
+        SYSCALL2(n = ::pwrite(fd, p, len, offset), path);
+        p += n;
+        len -= n;
+        offset += n;
+    }
+}
+
+void preadAll(int fd, void* data, size_t len, off_t offset, const eckit::PathName& path) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        ssize_t n;
+        SYSCALL2(n = ::pread(fd, p, len, offset), path);
+        if (n == 0) {
+            throw eckit::ReadError("Unexpected end of file reading sorted index", path, Here());
+        }
+        p += n;
+        len -= n;
+        offset += n;
+    }
+}
+
+/// The number of entries a writer keeps in memory before spilling them to a sorted run
+size_t runEntries() {
+    static size_t fdbSortedIndexRunEntries =
+        eckit::Resource<size_t>("fdbSortedIndexRunEntries;$FDB_SORTED_INDEX_RUN_ENTRIES", 1 << 20);
+    return std::max<size_t>(1, fdbSortedIndexRunEntries);
+}
+
+/// The number of entries read or written at once when streaming runs
+constexpr size_t blockEntries = 4096;
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Immutable index of fixed-width keys and payloads, stored as one sorted array.
+///
+/// When writing, the entries are kept in memory up to $FDB_SORTED_INDEX_RUN_ENTRIES, then spilled as a sorted run to
+/// an anonymous temporary file next to the index. On flush, the runs and the entries in memory are merged, the newest
+/// entry of a key winning, and the array is streamed to the index offset. When reading, the array is memory-mapped,
+/// and lookups are binary searches that do not need any system calls.
+template <int KEYSIZE, typename PAYLOAD>
+class TSortedIndex : public BTreeIndex {
+
+public:  // types
+
+    typedef eckit::FixedString<KEYSIZE> IndexKey;
+
+    struct Entry {
+        IndexKey key_;
+        PAYLOAD payload_;
+    };
+
+    /// Entries spilled from memory, sorted by key, at offset_ in the spill file
+    struct Run {
+        off_t offset_;
+        size_t count_;
+    };
+
+    class RunReader;
+
+public:  // methods
+
+    TSortedIndex(const eckit::PathName& path, bool readOnly, off_t offset);
+    ~TSortedIndex() override;
+
+private:  // methods
+
+    bool get(const std::string& key, FieldRef& data) const override;
+    bool set(const std::string& key, const FieldRef& data) override;
+    void flush() override;
+    void sync() override;
+    void flock() override;
+    void funlock() override;
+    void visit(BTreeIndexVisitor& visitor) const override;
+    void preload() override;
+
+    void map();
+    void unmap();
+
+    /// Position of the first entry in the file
+    off_t entriesOffset() const;
+
+    /// Writes the entries in memory as a new run, and clears them
+    void spill();
+
+    /// Calls @p visit with each key written, in order, and its newest payload
+    template <typename VISIT>
+    void merge(VISIT visit) const;
+
+private:  // members
+
+    eckit::PathName path_;
+    bool readOnly_;
+    off_t offset_;
+    int fd_;
+
+    // reading
+    void* mapped_;
+    size_t mappedLength_;
+    const Entry* begin_;
+    const Entry* end_;
+
+    // writing
+    std::map<IndexKey, PAYLOAD> entries_;  ///< the newest entries
+    std::vector<Run> runs_;                ///< the older entries, oldest first
+    int spillFd_;
+    off_t spillSize_;
+    bool locked_;
+};
+
+/// Reads the entries of a run in order, a block at a time
+template <int KEYSIZE, typename PAYLOAD>
+class TSortedIndex<KEYSIZE, PAYLOAD>::RunReader {
+public:
+
+    RunReader(const TSortedIndex& index, const Run& run) : index_(index), run_(run), next_(0), pos_(0) { load(); }
+
+    bool done() const { return pos_ == block_.size(); }
+
+    const Entry& entry() const { return block_[pos_]; }
+
+    void advance() {
+        if (++pos_ == block_.size()) {
+            load();
+        }
+    }
+
+private:
+
+    void load() {
+        const size_t n = std::min(blockEntries, run_.count_ - next_);
+        block_.resize(n);
+        if (n > 0) {
+            preadAll(index_.spillFd_, block_.data(), n * sizeof(Entry), run_.offset_ + next_ * sizeof(Entry),
+                     index_.path_);
+        }
+        next_ += n;
+        pos_ = 0;
+    }
+
+    const TSortedIndex& index_;
+    const Run& run_;
+    size_t next_;  ///< the first entry of the run not yet read
+    std::vector<Entry> block_;
+    size_t pos_;
+};
+
+template <int KEYSIZE, typename PAYLOAD>
+TSortedIndex<KEYSIZE, PAYLOAD>::TSortedIndex(const eckit::PathName& path, bool readOnly, off_t offset) :
+    path_(path),
+    readOnly_(readOnly),
+    offset_(offset),
+    fd_(-1),
+    mapped_(nullptr),
+    mappedLength_(0),
+    begin_(nullptr),
+    end_(nullptr),
+    spillFd_(-1),
+    spillSize_(0),
+    locked_(false) {
+
+    SYSCALL2(fd_ = ::open(path_.localPath(), readOnly_ ? O_RDONLY : (O_RDWR | O_CREAT), (mode_t)0777), path_);
+
+    if (readOnly_) {
+        map();
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+TSortedIndex<KEYSIZE, PAYLOAD>::~TSortedIndex() {
+    unmap();
+    if (fd_ >= 0) {
+        funlock();
+        ::close(fd_);
+    }
+    if (spillFd_ >= 0) {
+        ::close(spillFd_);
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+off_t TSortedIndex<KEYSIZE, PAYLOAD>::entriesOffset() const {
+    constexpr off_t alignment = alignof(Entry);
+    const off_t end = offset_ + sizeof(SortedIndexHeader);
+    return (end + alignment - 1) / alignment * alignment;
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::map() {
+
+    SortedIndexHeader header;
+    preadAll(fd_, &header, sizeof(header), offset_, path_);
+
+    if (::memcmp(header.magic_, sortedIndexMagic, sizeof(sortedIndexMagic)) != 0 ||
+        header.version_ != sortedIndexVersion || header.keySize_ != KEYSIZE || header.entrySize_ != sizeof(Entry)) {
+        std::ostringstream ss;
+        ss << "Invalid sorted index header in " << path_ << " at offset " << offset_;
+        throw eckit::SeriousBug(ss.str(), Here());
+    }
+
+    if (header.count_ == 0) {
+        return;
+    }
+
+    // mmap requires a page-aligned file offset, so the entries are as aligned in memory as they are in the file
+    static const off_t pageSize = ::sysconf(_SC_PAGESIZE);
+    const off_t start = offset_ - (offset_ % pageSize);
+    const size_t skip = entriesOffset() - start;
+
+    mappedLength_ = skip + header.count_ * sizeof(Entry);
+    mapped_ = ::mmap(nullptr, mappedLength_, PROT_READ, MAP_SHARED, fd_, start);
+    if (mapped_ == MAP_FAILED) {
+        mapped_ = nullptr;
+        throw eckit::FailedSystemCall("mmap", Here(), errno);
+    }
+
+    begin_ = reinterpret_cast<const Entry*>(static_cast<const char*>(mapped_) + skip);
+    end_ = begin_ + header.count_;
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::unmap() {
+    if (mapped_) {
+        ::munmap(mapped_, mappedLength_);
+        mapped_ = nullptr;
+        begin_ = end_ = nullptr;
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+bool TSortedIndex<KEYSIZE, PAYLOAD>::get(const std::string& key, FieldRef& data) const {
+    IndexKey k(key);
+
+    if (!readOnly_) {
+        auto it = entries_.find(k);
+        if (it != entries_.end()) {
+            data = FieldRef(it->second);
+            return true;
+        }
+        // The newest run holding the key
+        Entry e;
+        for (auto run = runs_.rbegin(); run != runs_.rend(); ++run) {
+            size_t lo = 0;
+            size_t hi = run->count_;
+            while (lo < hi) {
+                const size_t mid = lo + (hi - lo) / 2;
+                preadAll(spillFd_, &e, sizeof(Entry), run->offset_ + mid * sizeof(Entry), path_);
+                if (e.key_ < k) {
+                    lo = mid + 1;
+                }
+                else {
+                    hi = mid;
+                }
+            }
+            if (lo < run->count_) {
+                preadAll(spillFd_, &e, sizeof(Entry), run->offset_ + lo * sizeof(Entry), path_);
+                if (e.key_ == k) {
+                    data = FieldRef(e.payload_);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    const Entry* e =
+        std::lower_bound(begin_, end_, k, [](const Entry& entry, const IndexKey& value) { return entry.key_ < value; });
+    if (e == end_ || k < e->key_) {
+        return false;
+    }
+    data = FieldRef(e->payload_);
+    return true;
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+bool TSortedIndex<KEYSIZE, PAYLOAD>::set(const std::string& key, const FieldRef& data) {
+    ASSERT(!readOnly_);
+    // n.b. only tells whether the key was replaced in memory, not in the runs already spilled
+    auto [it, inserted] = entries_.insert_or_assign(IndexKey(key), PAYLOAD(data));
+    if (entries_.size() >= runEntries()) {
+        spill();
+    }
+    return !inserted;
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::spill() {
+
+    if (spillFd_ < 0) {
+        // Removed as soon as it is open, so that it goes away with the writer, however that ends
+        const eckit::PathName spill = eckit::PathName::unique(path_);
+        SYSCALL2(spillFd_ = ::open(spill.localPath(), O_RDWR | O_CREAT | O_EXCL, (mode_t)0600), spill);
+        SYSCALL2(::unlink(spill.localPath()), spill);
+    }
+
+    LOG_DEBUG_LIB(LibFdb5) << "Spilling " << entries_.size() << " sorted index entries for " << path_ << std::endl;
+
+    const Run run{spillSize_, entries_.size()};
+
+    std::vector<Entry> block;
+    block.reserve(std::min(blockEntries, entries_.size()));
+    off_t pos = run.offset_;
+    auto write = [&] {
+        pwriteAll(spillFd_, block.data(), block.size() * sizeof(Entry), pos, path_);
+        pos += block.size() * sizeof(Entry);
+        block.clear();
+    };
+    for (const auto& [key, payload] : entries_) {
+        block.push_back(Entry{key, payload});
+        if (block.size() == blockEntries) {
+            write();
+        }
+    }
+    write();
+
+    runs_.push_back(run);
+    spillSize_ = pos;
+    entries_.clear();
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+template <typename VISIT>
+void TSortedIndex<KEYSIZE, PAYLOAD>::merge(VISIT visit) const {
+
+    std::vector<RunReader> readers;
+    readers.reserve(runs_.size());
+    for (const Run& run : runs_) {
+        readers.emplace_back(*this, run);
+    }
+    auto memory = entries_.begin();
+
+    for (;;) {
+        const IndexKey* least = nullptr;
+        for (const RunReader& reader : readers) {
+            if (!reader.done() && (!least || reader.entry().key_ < *least)) {
+                least = &reader.entry().key_;
+            }
+        }
+        if (memory != entries_.end() && (!least || memory->first < *least)) {
+            least = &memory->first;
+        }
+        if (!least) {
+            return;
+        }
+
+        // Each source holds a key at most once, and the later sources are the newer
+        Entry entry{*least, PAYLOAD()};
+        for (RunReader& reader : readers) {
+            if (!reader.done() && reader.entry().key_ == entry.key_) {
+                entry.payload_ = reader.entry().payload_;
+                reader.advance();
+            }
+        }
+        if (memory != entries_.end() && memory->first == entry.key_) {
+            entry.payload_ = memory->second;
+            ++memory;
+        }
+
+        visit(entry);
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::flush() {
+
+    ASSERT(!readOnly_);
+
+    // The index is immutable once written: the whole array is (re)written at the index offset, a block at a time,
+    // and the header last, once the number of entries is known
+    const size_t skip = entriesOffset() - offset_;
+    std::vector<char> buffer(skip, 0);
+    buffer.reserve(skip + blockEntries * sizeof(Entry));
+
+    off_t pos = offset_;
+    uint64_t count = 0;
+
+    // n.b. the buffer is only aligned as the file is, so the entries are copied into it
+    merge([&](const Entry& entry) {
+        const char* p = reinterpret_cast<const char*>(&entry);
+        buffer.insert(buffer.end(), p, p + sizeof(Entry));
+        ++count;
+        if (buffer.size() >= blockEntries * sizeof(Entry)) {
+            pwriteAll(fd_, buffer.data(), buffer.size(), pos, path_);
+            pos += buffer.size();
+            buffer.clear();
+        }
+    });
+    pwriteAll(fd_, buffer.data(), buffer.size(), pos, path_);
+
+    SortedIndexHeader header;
+    ::memset(&header, 0, sizeof(header));
+    ::memcpy(header.magic_, sortedIndexMagic, sizeof(sortedIndexMagic));
+    header.version_ = sortedIndexVersion;
+    header.keySize_ = KEYSIZE;
+    header.entrySize_ = sizeof(Entry);
+    header.count_ = count;
+
+    LOG_DEBUG_LIB(LibFdb5) << "Writing sorted index with " << count << " entries, merged from " << runs_.size()
+                           << " runs, to " << path_ << " at " << offset_ << std::endl;
+
+    pwriteAll(fd_, &header, sizeof(header), offset_, path_);
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::sync() {
+    if (!readOnly_) {
+        SYSCALL2(::fsync(fd_), path_);
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::flock() {
+    if (!readOnly_ && !locked_) {
+        SYSCALL2(::flock(fd_, LOCK_EX), path_);
+        locked_ = true;
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::funlock() {
+    if (locked_) {
+        ::flock(fd_, LOCK_UN);
+        locked_ = false;
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::visit(BTreeIndexVisitor& visitor) const {
+    if (!readOnly_) {
+        merge([&](const Entry& entry) { visitor.visit(entry.key_, FieldRef(entry.payload_)); });
+        return;
+    }
+    for (const Entry* e = begin_; e != end_; ++e) {
+        visitor.visit(e->key_, FieldRef(e->payload_));
+    }
+}
+
+template <int KEYSIZE, typename PAYLOAD>
+void TSortedIndex<KEYSIZE, PAYLOAD>::preload() {
+    if (mapped_) {
+        ::madvise(mapped_, mappedLength_, MADV_WILLNEED);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define SORTEDINDEX(KEYSIZE, PAYLOAD)                                                                         \
+    struct SortedIndex_##KEYSIZE##_##PAYLOAD : public TSortedIndex<KEYSIZE, PAYLOAD> {                        \
+        SortedIndex_##KEYSIZE##_##PAYLOAD(const eckit::PathName& path, bool readOnly, off_t offset) :         \
+            TSortedIndex<KEYSIZE, PAYLOAD>(path, readOnly, offset){};                                         \
+    };                                                                                                        \
+    static BTreeIndexBuilder<SortedIndex_##KEYSIZE##_##PAYLOAD> maker_SortedIndex_##KEYSIZE##_##PAYLOAD(      \
+        "SortedIndex_" #KEYSIZE "_" #PAYLOAD)
+
+SORTEDINDEX(32, FieldRefReduced);
+SORTEDINDEX(64, FieldRefReduced);
+
+static BTreeIndexBuilder<SortedIndex_32_FieldRefReduced> sortedIndex("SortedIndex");
+static BTreeIndexBuilder<SortedIndex_64_FieldRefReduced> wideSortedIndex("SortedIndex64");  // 64 char-limit for key
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -18,6 +18,7 @@
 #include "fdb5/database/Catalogue.h"
 #include "fdb5/database/WipeState.h"
 #include "fdb5/rules/Rule.h"
+#include "fdb5/toc/RootCatalogue.h"
 #include "fdb5/toc/RootManager.h"
 #include "fdb5/toc/TocCatalogue.h"
 #include "fdb5/toc/TocMoveVisitor.h"
@@ -241,6 +242,11 @@ void TocCatalogue::finaliseWipeState(CatalogueWipeState& wipeState) const {
     // schema
     catalogueURIs.emplace("file", schemaPath().path());
 
+    // cached index list
+    if (snapshotPath().exists()) {
+        catalogueURIs.emplace("file", snapshotPath().path());
+    }
+
     // lockfiles
     for (const auto& lck : lockfilePaths()) {
         controlURIs.emplace("file", lck);
@@ -322,6 +328,7 @@ void TocCatalogue::doWipeEmptyDatabase() const {
     eckit::PathName path = uri().path();
     if (path.exists()) {
         remove(path, std::cout, std::cout, true);
+        RootCatalogue::remove(path);
     }
     cleanupEmptyDatabase_ = false;
 }
@@ -9,12 +9,17 @@
  */
 
 #include <algorithm>
+#include <functional>
+#include <mutex>
+#include <utility>
 #include <vector>
 
+#include "eckit/config/Resource.h"
 #include "eckit/log/Log.h"
 
 #include "fdb5/LibFdb5.h"
 #include "fdb5/database/Key.h"
+#include "fdb5/database/TaskPool.h"
 #include "fdb5/toc/TocCatalogueReader.h"
 #include "fdb5/toc/TocIndex.h"
 
@@ -22,6 +27,30 @@ namespace fdb5 {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Whether open databases are refreshed (see MultiRetrieveVisitor), so that readers keep what they need to do it
+bool refreshOpenDatabases() {
+    static const bool refresh = eckit::Resource<bool>("fdbRefreshOpenDatabases;$FDB_REFRESH_OPEN_DATABASES", false);
+    return refresh;
+}
+
+long retrieveIndexThreads() {
+    static const long nthreads = eckit::Resource<long>("fdbRetrieveIndexThreads;$FDB_RETRIEVE_INDEX_THREADS", 1);
+    return nthreads;
+}
+
+/// The threads probing indexes for retrieveBatch(), shared by all the readers of the process
+TaskPool& retrieveIndexPool() {
+    // Leaked deliberately, so that the threads are not joined during static deinitialisation
+    static TaskPool& pool = *new TaskPool("index probes", retrieveIndexThreads());
+    return pool;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 TocCatalogueReader::TocCatalogueReader(const Key& dbKey, const fdb5::Config& config) : TocCatalogue(dbKey, config) {
     loadIndexesAndRemap();
 }
@@ -36,15 +65,56 @@ TocCatalogueReader::~TocCatalogueReader() {
 }
 
 void TocCatalogueReader::loadIndexesAndRemap() const {
+    std::vector<Index> indexes;
     std::vector<Key> remapKeys;
     /// @todo: this should throw DatabaseNotFoundException if the toc file is not found
-    std::vector<Index> indexes = loadIndexes(false, nullptr, nullptr, &remapKeys);
+    if (refreshOpenDatabases()) {
+        refreshIndexes(indexes, remapKeys);
+    }
+    else {
+        indexes = loadIndexes(false, nullptr, nullptr, &remapKeys);
+    }
+
+    ASSERT(remapKeys.size() == indexes.size());
+    indexes_.clear();
+    indexes_.reserve(remapKeys.size());
+    for (size_t i = 0; i < remapKeys.size(); ++i) {
+        indexes_.emplace_back(indexes[i], remapKeys[i]);
+    }
+}
+
+bool TocCatalogueReader::refresh() {
+
+    // Only the readers of a process that refreshes its open databases keep the records refreshIndexes() starts from
+    if (!refreshOpenDatabases()) {
+        return false;
+    }
+
+    std::vector<Index> indexes;
+    std::vector<Key> remapKeys;
+    if (!refreshIndexes(indexes, remapKeys)) {
+        return false;
+    }
 
     ASSERT(remapKeys.size() == indexes.size());
+    indexes_.clear();
     indexes_.reserve(remapKeys.size());
     for (size_t i = 0; i < remapKeys.size(); ++i) {
         indexes_.emplace_back(indexes[i], remapKeys[i]);
     }
+
+    // matching_ points into indexes_, so select the current index again
+    Key idxKey = currentIndexKey_;
+    currentIndexKey_ = Key();
+    matching_.clear();
+    invalidateAxis();
+    if (!idxKey.empty()) {
+        selectIndex(idxKey);
+    }
+
+    LOG_DEBUG_LIB(LibFdb5) << "Refreshed DB " << directory() << ", " << indexes_.size() << " indexes" << std::endl;
+
+    return true;
 }
 
 bool TocCatalogueReader::selectIndex(const Key& idxKey) {
@@ -128,6 +198,77 @@ bool TocCatalogueReader::retrieve(const Key& key, Field& field) const {
     return false;
 }
 
+bool TocCatalogueReader::batchRetrieval() const {
+    return retrieveIndexThreads() > 1 && matching_.size() > 1;
+}
+
+std::vector<bool> TocCatalogueReader::retrieveBatch(const std::vector<Key>& keys, std::vector<Field>& fields) const {
+
+    if (!batchRetrieval()) {
+        return CatalogueReader::retrieveBatch(keys, fields);
+    }
+
+    const size_t nstages = std::min(static_cast<size_t>(retrieveIndexThreads()), matching_.size());
+
+    LOG_DEBUG_LIB(LibFdb5) << "Probing " << matching_.size() << " indexes for " << keys.size() << " keys in "
+                           << nstages << " stages" << std::endl;
+
+    // The matching indexes, in order of precedence, are split into consecutive runs (stages), each probed by one
+    // thread at a time as an open index is not safe to share between threads. The keys go through the stages in
+    // chunks, and each key stops at the first index that has it, as in retrieve(). While a chunk is probed by a
+    // stage, the previous stages work on the following chunks.
+    std::vector<std::mutex> stages(nstages);
+    std::vector<char> found(keys.size(), 0);
+    fields.resize(keys.size());
+
+    // n.b. declared before the group, which waits for its tasks when destroyed
+    std::function<void(size_t, std::vector<size_t>)> probe;
+
+    TaskPool::Group group(retrieveIndexPool());
+
+    probe = [&](size_t stage, std::vector<size_t> todo) {
+        const size_t begin = stage * matching_.size() / nstages;
+        const size_t end = (stage + 1) * matching_.size() / nstages;
+
+        std::vector<size_t> missed;
+        {
+            std::lock_guard<std::mutex> lock(stages[stage]);
+            for (size_t k : todo) {
+                for (size_t i = begin; i < end; ++i) {
+                    const Index& idx(matching_[i]->first);
+                    if (idx.mayContain(keys[k])) {
+                        const_cast<Index&>(idx).open();
+                        if (idx.get(keys[k], matching_[i]->second, fields[k])) {
+                            found[k] = 1;
+                            break;
+                        }
+                    }
+                }
+                if (!found[k]) {
+                    missed.push_back(k);
+                }
+            }
+        }
+
+        if (!missed.empty() && stage + 1 < nstages) {
+            group.run([&probe, stage, missed = std::move(missed)]() mutable { probe(stage + 1, std::move(missed)); });
+        }
+    };
+
+    const size_t chunk = std::max<size_t>(1, (keys.size() + 2 * nstages - 1) / (2 * nstages));
+    for (size_t first = 0; first < keys.size(); first += chunk) {
+        std::vector<size_t> todo;
+        for (size_t k = first; k < std::min(keys.size(), first + chunk); ++k) {
+            todo.push_back(k);
+        }
+        group.run([&probe, todo = std::move(todo)]() mutable { probe(0, std::move(todo)); });
+    }
+
+    group.wait();
+
+    return std::vector<bool>(found.begin(), found.end());
+}
+
 void TocCatalogueReader::print(std::ostream& out) const {
     out << "TocCatalogueReader(" << directory() << ")";
 }
@@ -49,6 +49,8 @@ public:  // methods
     std::vector<Index> indexes(bool sorted) const override;
     DbStats stats() const override { return TocHandler::stats(); }
 
+    bool refresh() override;
+
 private:  // methods
 
     void loadIndexesAndRemap() const;
@@ -61,6 +63,8 @@ private:  // methods
     void close() override;
 
     bool retrieve(const Key& key, Field& field) const override;
+    bool batchRetrieval() const override;
+    std::vector<bool> retrieveBatch(const std::vector<Key>& keys, std::vector<Field>& fields) const override;
 
     void print(std::ostream& out) const override;
 
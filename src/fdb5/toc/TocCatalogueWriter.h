@@ -70,6 +70,7 @@ public:  // methods
     const TocSerialisationVersion& serialisationVersion() const;
 
     size_t archivedLocations() const override { return archivedLocations_; }
+    bool asyncArchive() const override { return true; }
 
 protected:  // methods
 
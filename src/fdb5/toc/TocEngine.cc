@@ -30,6 +30,7 @@
 #include "fdb5/LibFdb5.h"
 #include "fdb5/rules/Rule.h"
 #include "fdb5/rules/Schema.h"
+#include "fdb5/toc/RootCatalogue.h"
 #include "fdb5/toc/RootManager.h"
 #include "fdb5/toc/TocEngine.h"
 #include "fdb5/toc/TocHandler.h"
@@ -132,14 +133,13 @@ static constexpr const char* regexForMissingValues = "[^:/]*";
 
 std::map<eckit::PathName, const Rule*> TocEngine::databases(const std::map<Key, const Rule*>& keys,
                                                             const std::vector<eckit::PathName>& roots,
-                                                            const Config& config) const {
+                                                            const Config& config,
+                                                            std::map<eckit::PathName, Key>& catalogued) const {
 
     std::map<eckit::PathName, const Rule*> result;
 
     for (std::vector<eckit::PathName>::const_iterator j = roots.begin(); j != roots.end(); ++j) {
 
-        LOG_DEBUG_LIB(LibFdb5) << "Scanning for TOC FDBs in root " << *j << std::endl;
-
         std::string regex_prefix = "^" + eckit::StringTools::lower(Regex::escape(j->asString()));
 
         if (regex_prefix.back() != '/') {
@@ -147,7 +147,20 @@ std::map<eckit::PathName, const Rule*> TocEngine::databases(const std::map<Key,
         }
 
         std::list<std::string> dbs;
-        scan_dbs(*j, dbs);
+
+        RootCatalogue catalogue(*j);
+        if (catalogue.usable()) {
+            LOG_DEBUG_LIB(LibFdb5) << "Listing TOC FDBs in root catalogue of " << *j << std::endl;
+            for (const auto& [name, dbKey] : catalogue.databases()) {
+                eckit::PathName db = *j / name;
+                dbs.push_back(db.asString());
+                catalogued.emplace(db, dbKey);
+            }
+        }
+        else {
+            LOG_DEBUG_LIB(LibFdb5) << "Scanning for TOC FDBs in root " << *j << std::endl;
+            scan_dbs(*j, dbs);
+        }
 
         for (const auto& [key, rule] : keys) {
 
@@ -156,6 +169,17 @@ std::map<eckit::PathName, const Rule*> TocEngine::databases(const std::map<Key,
 
             for (const std::string& dbpath : dbpaths) {
 
+                // A fully specified key names its database directly
+                if (catalogue.usable() && dbpath.find(regexForMissingValues) == std::string::npos &&
+                    dbpath.find('/') == std::string::npos) {
+                    if (const auto* entry = catalogue.find(dbpath)) {
+                        LOG_DEBUG_LIB(LibFdb5) << " -> key " << key << " dbpath " << dbpath << " catalogued"
+                                               << std::endl;
+                        result.emplace(*j / entry->first, rule);
+                    }
+                    continue;
+                }
+
                 std::string regex = regex_prefix + eckit::StringTools::lower(dbpath) + "$";
                 eckit::Regex reg(regex);
 
@@ -195,11 +219,19 @@ std::vector<eckit::URI> TocEngine::databases(const Key& key, const std::vector<e
 
     LOG_DEBUG_LIB(LibFdb5) << "Matched DB schemas for key " << key << " -> keys " << keys << std::endl;
 
-    std::map<eckit::PathName, const Rule*> databasesMatchRegex(databases(keys, roots, config));
+    std::map<eckit::PathName, Key> catalogued;
+    std::map<eckit::PathName, const Rule*> databasesMatchRegex(databases(keys, roots, config, catalogued));
 
     std::vector<eckit::URI> result;
     for (const auto& [path, rule] : databasesMatchRegex) {
         try {
+            if (const auto it = catalogued.find(path); it != catalogued.end()) {
+                if (it->second.match(key) && path.exists()) {
+                    LOG_DEBUG_LIB(LibFdb5) << " found match with " << path << std::endl;
+                    result.push_back(eckit::URI(TocEngine::typeName(), path));
+                }
+                continue;
+            }
             TocHandler toc(path, config);
             if (toc.databaseKey().match(key)) {
                 LOG_DEBUG_LIB(LibFdb5) << " found match with " << path << std::endl;
@@ -228,21 +260,24 @@ std::vector<eckit::URI> TocEngine::databases(const metkit::mars::MarsRequest& re
     }
     LOG_DEBUG_LIB(LibFdb5) << "]" << std::endl;
 
-    std::map<eckit::PathName, const Rule*> databasesMatchRegex(databases(keys, roots, config));
+    std::map<eckit::PathName, Key> catalogued;
+    std::map<eckit::PathName, const Rule*> databasesMatchRegex(databases(keys, roots, config, catalogued));
 
     std::vector<eckit::URI> result;
     for (const auto& [p, rule] : databasesMatchRegex) {
         try {
-            /// @todo we don't have to open tocs to check if they match the request
             if (p.exists()) {
                 eckit::PathName path = p.isDir() ? p : p.dirName();
                 path = path.realName();
 
                 LOG_DEBUG_LIB(LibFdb5) << "FDB processing Path " << path << std::endl;
 
-                TocHandler toc(path, config);
                 auto canonical = rule->registry().canonicalise(request);
-                if (toc.databaseKey().partialMatch(canonical)) {
+
+                // The root catalogue saves opening the TOC for its key
+                const auto it = catalogued.find(p);
+                const Key dbKey = (it != catalogued.end()) ? it->second : TocHandler(path, config).databaseKey();
+                if (dbKey.partialMatch(canonical)) {
                     LOG_DEBUG_LIB(LibFdb5) << " found match with " << path << std::endl;
                     result.push_back(eckit::URI(TocEngine::typeName(), path));
                 }
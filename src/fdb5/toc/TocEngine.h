@@ -32,9 +32,10 @@ public:  // methods
 
 private:  // methods
 
+    /// Fills @p catalogued with the keys of the databases found through root catalogues, which need not be read
     std::map<eckit::PathName, const Rule*> databases(const std::map<Key, const Rule*>& keys,
-                                                     const std::vector<eckit::PathName>& dirs,
-                                                     const Config& config) const;
+                                                     const std::vector<eckit::PathName>& dirs, const Config& config,
+                                                     std::map<eckit::PathName, Key>& catalogued) const;
 
     std::vector<eckit::URI> databases(const Key& key, const std::vector<eckit::PathName>& dirs,
                                       const Config& config) const;
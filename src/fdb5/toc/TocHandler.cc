@@ -10,6 +10,7 @@
 
 #include <fcntl.h>
 #include <pwd.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <cstddef>
 #include <utility>
@@ -30,6 +31,7 @@
 #include "fdb5/api/helpers/ControlIterator.h"
 #include "fdb5/database/Index.h"
 #include "fdb5/io/LustreSettings.h"
+#include "fdb5/toc/RootCatalogue.h"
 #include "fdb5/toc/TocCommon.h"
 #include "fdb5/toc/TocFieldLocation.h"
 #include "fdb5/toc/TocHandler.h"
@@ -53,6 +55,11 @@ constexpr const char* archive_lock_file = "archive.lock";
 constexpr const char* list_lock_file = "list.lock";
 constexpr const char* wipe_lock_file = "wipe.lock";
 constexpr const char* allow_duplicates_file = "duplicates.allow";
+
+bool useTocSnapshot() {
+    static bool fdbTocSnapshot = eckit::Resource<bool>("fdbTocSnapshot;$FDB_TOC_SNAPSHOT", false);
+    return fdbTocSnapshot;
+}
 }  // namespace
 
 const std::map<ControlIdentifier, const char*> controlfile_lookup{
@@ -1073,6 +1080,10 @@ void TocHandler::writeInitRecord(const Key& key) {
         s << isSubToc_;
         append(*r2, s.position());
         dbUID_ = r2->header_.uid_;
+
+        if (!isSubToc_) {
+            RootCatalogue::add(directory_, key);
+        }
     }
     else {
         ASSERT(r->header_.tag_ == TocRecord::TOC_INIT);
@@ -1142,14 +1153,8 @@ void TocHandler::writeIndexRecord(const Index& index) {
                 handler_.serialisationVersion_.used(),
                 TocRecord::TOC_INDEX);  // allocate (large) TocRecord on heap not stack (MARS-779)
 
-            eckit::MemoryStream s(&r->payload_[0], r->maxPayloadSize);
-
-            s << location.uri().path().baseName();
-            s << location.offset();
-            s << index_.type();
-
-            index_.encode(s, r->header_.serialisationVersion_);
-            handler_.append(*r, s.position());
+            // As for the records of compacted sub-TOCs, including the Bloom filter of the index
+            handler_.append(*r, TocHandler::buildIndexRecord(*r, index_));
 
             LOG_DEBUG_LIB(LibFdb5) << "Write TOC_INDEX " << location.uri().path().baseName() << " - "
                                    << location.offset() << " " << index_.type() << std::endl;
@@ -1309,20 +1314,161 @@ std::vector<Index> TocHandler::loadIndexes(bool sorted, std::set<std::string>* s
         return indexes;
     }
 
-    // If we haven't yet read the TOC_INIT record to extract the parentKey, it may be needed for
-    // subtoc handling...
-    // We've got a bit mangled with our constness here...
-    if (parentKey_.empty() && remapKeys && !isSubToc_) {
-        const auto& k = const_cast<TocHandler&>(*this).databaseKey();
-        parentKey_ = k;
+    std::unique_ptr<TocSnapshot> snapshot = indexSnapshot(!!remapKeys);
+
+    indexes = deserialiseIndexes(*snapshot, {});
+
+    for (const TocSnapshot::Entry& e : snapshot->entries_) {
+
+        const TocSnapshot::SubToc* sub = (e.subToc_ < 0) ? nullptr : &snapshot->subTocs_[e.subToc_];
+
+        if (subTocs && sub) {
+            subTocs->insert(sub->tocPath_);
+        }
+        if (indexInSubtoc) {
+            indexInSubtoc->push_back(!!sub);
+        }
+        if (remapKeys) {
+            remapKeys->push_back(sub ? sub->remapKey_ : remapKey_);
+        }
     }
 
-    openForRead();
-    TocHandlerCloser close(*this);
+    // For some purposes, it is useful to have the indexes sorted by their location, as this is is faster for
+    // iterating through the data.
 
-    auto r = std::make_unique<TocRecord>(
-        serialisationVersion_.used());  // allocate (large) TocRecord on heap not stack (MARS-779)
-    count_ = 0;
+    if (sorted) {
+
+        ASSERT(!indexInSubtoc);
+        ASSERT(!remapKeys);
+        std::sort(indexes.begin(), indexes.end(), TocIndexFileSort());
+    }
+    else {
+
+        // In the normal case, the entries are sorted into reverse order. The last index takes precedence
+        std::reverse(indexes.begin(), indexes.end());
+
+        if (indexInSubtoc) {
+            std::reverse(indexInSubtoc->begin(), indexInSubtoc->end());
+        }
+        if (remapKeys) {
+            std::reverse(remapKeys->begin(), remapKeys->end());
+        }
+    }
+
+    return indexes;
+}
+
+bool TocHandler::refreshIndexes(std::vector<Index>& indexes, std::vector<Key>& remapKeys) const {
+
+    // The indexes already deserialised, by record. The records of the state are kept until it is discarded.
+    std::map<const TocRecord*, Index> known;
+
+    if (refreshState_) {
+
+        ASSERT(refreshIndexes_.size() == refreshState_->entries_.size());
+        for (size_t i = 0; i < refreshIndexes_.size(); ++i) {
+            known.emplace(refreshState_->entries_[i].record_, refreshIndexes_[i]);
+        }
+
+        bool changed = false;
+        if (!updateSnapshot(*refreshState_, changed)) {
+            LOG_DEBUG_LIB(LibFdb5) << "Cannot follow TOC " << tocPath_ << ", reloading all indexes" << std::endl;
+            known.clear();
+            refreshState_.reset();
+        }
+        else if (!changed) {
+            return false;
+        }
+        else if (useTocSnapshot()) {
+            refreshState_->save(snapshotPath());
+        }
+    }
+
+    if (!refreshState_) {
+        if (!tocPath_.exists()) {
+            // The indexes returned before, if any, are gone with the TOC
+            if (refreshIndexes_.empty()) {
+                return false;
+            }
+            refreshIndexes_.clear();
+            indexes.clear();
+            remapKeys.clear();
+            return true;
+        }
+        refreshState_ = indexSnapshot(true);
+        refreshState_->detach();
+    }
+
+    refreshIndexes_ = deserialiseIndexes(*refreshState_, known);
+
+    LOG_DEBUG_LIB(LibFdb5) << "Loaded " << refreshIndexes_.size() << " indexes of TOC " << tocPath_ << ", reusing "
+                           << known.size() << std::endl;
+
+    // As in loadIndexes, the entries are returned in reverse order. The last index takes precedence.
+
+    indexes.assign(refreshIndexes_.rbegin(), refreshIndexes_.rend());
+
+    remapKeys.clear();
+    remapKeys.reserve(refreshState_->entries_.size());
+    for (auto e = refreshState_->entries_.rbegin(); e != refreshState_->entries_.rend(); ++e) {
+        remapKeys.push_back(e->subToc_ < 0 ? remapKey_ : refreshState_->subTocs_[e->subToc_].remapKey_);
+    }
+
+    return true;
+}
+
+std::unique_ptr<TocSnapshot> TocHandler::indexSnapshot(bool needParentKey) const {
+
+    // A snapshot of the resolved index records may save walking the TOC and all of its sub-TOCs
+
+    bool useSnapshot = useTocSnapshot() && !isSubToc_;
+
+    std::unique_ptr<TocSnapshot> snapshot;
+    if (useSnapshot) {
+        snapshot = TocSnapshot::load(snapshotPath());
+        if (snapshot) {
+            if (parentKey_.empty()) {
+                parentKey_ = snapshot->dbKey_;
+            }
+            bool changed = false;
+            if (!updateSnapshot(*snapshot, changed)) {
+                LOG_DEBUG_LIB(LibFdb5) << "TOC snapshot out of date, replaying " << tocPath_ << std::endl;
+                snapshot.reset();
+            }
+            else if (changed) {
+                snapshot->save(snapshotPath());
+            }
+        }
+    }
+
+    if (!snapshot) {
+
+        // If we haven't yet read the TOC_INIT record to extract the parentKey, it may be needed for
+        // subtoc handling...
+        // We've got a bit mangled with our constness here...
+        if (parentKey_.empty() && needParentKey && !isSubToc_) {
+            const auto& k = const_cast<TocHandler&>(*this).databaseKey();
+            parentKey_ = k;
+        }
+
+        snapshot = replayToc();
+        if (useSnapshot && snapshot->tocSize_ > 0) {
+            snapshot->save(snapshotPath());
+        }
+    }
+    else {
+        dbUID_ = snapshot->dbUID_;
+    }
+
+    count_ = snapshot->entries_.size() + 1;
+
+    return snapshot;
+}
+
+std::vector<Index> TocHandler::deserialiseIndexes(const TocSnapshot& snapshot,
+                                                  const std::map<const TocRecord*, Index>& known) const {
+
+    std::vector<Index> indexes(snapshot.entries_.size());
 
     // A record of all the index entries found (to process later)
     struct IndexEntry {
@@ -1332,10 +1478,88 @@ std::vector<Index> TocHandler::loadIndexes(bool sorted, std::set<std::string>* s
         LocalPathName tocDirectoryName;  // May differ if using the overlay
     };
     std::vector<IndexEntry> indexEntries;
+    indexEntries.reserve(snapshot.entries_.size());
+
+    for (size_t i = 0; i < snapshot.entries_.size(); ++i) {
+
+        const TocSnapshot::Entry& e = snapshot.entries_[i];
+
+        auto it = known.find(e.record_);
+        if (it != known.end()) {
+            indexes[i] = it->second;
+            continue;
+        }
+
+        LocalPathName directory = (e.subToc_ < 0) ? directory_ : LocalPathName(snapshot.subTocs_[e.subToc_].directory_);
+        indexEntries.emplace_back(IndexEntry{i, e.record_, e.length_, directory});
+    }
+
+    // Now construct the index objects (we can parallelise this...)
+    // n.b. would be nicer to use std::for_each with a policy ... but that doesn't work for now.
+
+    static const int nthreads = eckit::Resource<long>("fdbLoadIndexThreads;$FDB_LOAD_INDEX_THREADS", 1);
+
+    bool debug = LibFdb5::instance().debug();
+
+    {
+        std::vector<std::future<void>> threads;
+        std::vector<TocIndex*> tocindexes(indexEntries.size(), nullptr);
+
+        for (int i = 0; i < nthreads; ++i) {
+            threads.emplace_back(std::async(std::launch::async, [i, &indexEntries, &tocindexes, debug, this] {
+                for (int idx = i; idx < indexEntries.size(); idx += nthreads) {
+
+                    const IndexEntry& entry = indexEntries[idx];
+                    eckit::MemoryStream s(entry.datap->payload_, entry.dataLen - sizeof(TocRecord::Header));
+                    LocalPathName path;
+                    off_t offset;
+                    std::string type;
+                    s >> path;
+                    s >> offset;
+                    s >> type;
+                    LOG_DEBUG(debug, LibFdb5) << "TocRecord TOC_INDEX " << path << " - " << offset << std::endl;
+                    tocindexes[idx] = new TocIndex(s, entry.datap->header_.serialisationVersion_,
+                                                   entry.tocDirectoryName, entry.tocDirectoryName / path, offset,
+                                                   preloadBTree_);
+
+                    // Anything after the index, rather than the zero padding, is its Bloom filter
+                    size_t pos = s.position();
+                    if (pos < entry.dataLen - sizeof(TocRecord::Header) && entry.datap->payload_[pos] != 0) {
+                        tocindexes[idx]->decodeFilter(s);
+                    }
+                }
+            }));
+        }
+
+        for (auto& thread : threads) {
+            thread.get();
+        }
+
+        for (size_t idx = 0; idx < indexEntries.size(); ++idx) {
+            indexes[indexEntries[idx].seqNo] = Index(tocindexes[idx]);
+        }
+    }
+
+    return indexes;
+}
+
+std::unique_ptr<TocSnapshot> TocHandler::replayToc() const {
+
+    openForRead();
+    TocHandlerCloser close(*this);
+
+    auto snapshot = std::make_unique<TocSnapshot>();
+
+    auto r = std::make_unique<TocRecord>(
+        serialisationVersion_.used());  // allocate (large) TocRecord on heap not stack (MARS-779)
+
+    // The sub-TOC records are not hidden, so that the index records that follow can be attributed to their sub-TOC
+    std::map<const TocHandler*, long> subTocIds;
+    bool complete = true;
 
     bool debug = LibFdb5::instance().debug();
     bool walkSubTocs = true;
-    bool hideSubTocEntries = true;
+    bool hideSubTocEntries = false;
     bool hideClearEntries = true;
     bool readMasked = false;
     const TocRecord* pdata;
@@ -1343,44 +1567,53 @@ std::vector<Index> TocHandler::loadIndexes(bool sorted, std::set<std::string>* s
     while (readNext(*r, walkSubTocs, hideSubTocEntries, hideClearEntries, readMasked, &pdata, &dataLength)) {
 
         eckit::MemoryStream s(&r->payload_[0], r->maxPayloadSize);
-        std::string path;
-        std::string type;
-
+        LocalPathName path;
         off_t offset;
-        std::vector<Index>::iterator j;
-
-        count_++;
-
 
         switch (r->header_.tag_) {
 
             case TocRecord::TOC_INIT:
-                dbUID_ = r->header_.uid_;
-                LOG_DEBUG(debug, LibFdb5) << "TocRecord TOC_INIT key is " << Key(s) << std::endl;
+                if (!subTocRead_) {
+                    dbUID_ = r->header_.uid_;
+                    snapshot->dbUID_ = dbUID_;
+                    snapshot->dbKey_ = Key(s);
+                    LOG_DEBUG(debug, LibFdb5) << "TocRecord TOC_INIT key is " << snapshot->dbKey_ << std::endl;
+                }
                 break;
 
-            case TocRecord::TOC_INDEX:
-                indexEntries.emplace_back(IndexEntry{indexEntries.size(), pdata, dataLength, currentDirectory()});
-
-                if (subTocs && subTocRead_) {
-                    subTocs->insert(subTocRead_->tocPath());
+            case TocRecord::TOC_SUB_TOC: {
+                ASSERT(subTocRead_);
+                auto [it, inserted] = subTocIds.emplace(subTocRead_, snapshot->subTocs_.size());
+                if (inserted) {
+                    snapshot->subTocs_.emplace_back(TocSnapshot::SubToc{currentTocPath(), currentDirectory(),
+                                                                        currentRemapKey(), 0, false,
+                                                                        snapshot->entries_.size()});
                 }
-                if (indexInSubtoc) {
-                    indexInSubtoc->push_back(!!subTocRead_);
+                else {
+                    // A sub-TOC referenced more than once is walked each time, which a snapshot cannot describe
+                    complete = false;
                 }
-                if (remapKeys) {
-                    remapKeys->push_back(currentRemapKey());
+                break;
+            }
+
+            case TocRecord::TOC_INDEX: {
+                s >> path;
+                s >> offset;
+                long subToc = -1;
+                if (subTocRead_) {
+                    auto it = subTocIds.find(subTocRead_);
+                    ASSERT(it != subTocIds.end());
+                    subToc = it->second;
                 }
+                snapshot->entries_.emplace_back(TocSnapshot::Entry{pdata, dataLength, path.baseName(), offset, subToc});
                 break;
+            }
 
             case TocRecord::TOC_CLEAR:
                 ASSERT_MSG(r->header_.tag_ != TocRecord::TOC_CLEAR,
                            "The TOC_CLEAR records should have been pre-filtered on the first pass");
                 break;
 
-            case TocRecord::TOC_SUB_TOC:
-                throw eckit::SeriousBug("TOC_SUB_TOC entry should be handled inside readNext");
-
             default:
                 std::ostringstream oss;
                 oss << "Unknown tag in TocRecord " << *r;
@@ -1388,68 +1621,321 @@ std::vector<Index> TocHandler::loadIndexes(bool sorted, std::set<std::string>* s
         }
     }
 
-    // Now construct the index objects (we can parallelise this...)
-    // n.b. would be nicer to use std::for_each with a policy ... but that doesn't work for now.
+    // Record how much of each file has been read, so that a saved snapshot can be brought up to date later
 
-    static const int nthreads = eckit::Resource<long>("fdbLoadIndexThreads;$FDB_LOAD_INDEX_THREADS", 1);
+    ASSERT(cachedToc_);
+    snapshot->tocSize_ = cachedToc_->position();
+    snapshot->masked_ = maskedEntries_;
 
-    {
-        std::vector<std::future<void>> threads;
-        std::vector<TocIndex*> tocindexes(indexEntries.size(), nullptr);
+    for (const auto& [handler, id] : subTocIds) {
+        TocSnapshot::SubToc& sub = snapshot->subTocs_[id];
+        sub.size_ = handler->cachedToc_ ? uint64_t(handler->cachedToc_->position()) : 0;
+        sub.masks_ = !handler->maskedEntries_.empty();
+        complete = complete && sub.size_ > 0;
+    }
 
-        for (int i = 0; i < nthreads; ++i) {
-            threads.emplace_back(std::async(std::launch::async, [i, &indexEntries, &tocindexes, debug, this] {
-                for (int idx = i; idx < indexEntries.size(); idx += nthreads) {
+    struct stat st;
+    SYSCALL2(::stat(tocPath_.localPath(), &st), tocPath_);
+    snapshot->tocDevice_ = st.st_dev;
+    snapshot->tocInode_ = st.st_ino;
+    snapshot->tocMTime_ = (uint64_t(st.st_size) == snapshot->tocSize_) ? st.st_mtime : 0;
 
-                    const IndexEntry& entry = indexEntries[idx];
-                    eckit::MemoryStream s(entry.datap->payload_, entry.dataLen - sizeof(TocRecord::Header));
-                    LocalPathName path;
-                    off_t offset;
-                    std::string type;
+    if (!complete) {
+        snapshot->tocSize_ = 0;  // not to be saved
+    }
+
+    return snapshot;
+}
+
+bool TocHandler::updateSnapshot(TocSnapshot& snapshot, bool& changed) const {
+
+    // The TOC is only ever appended to. If it has been replaced, or has not grown but was modified, start again.
+
+    struct stat st;
+    if (::stat(tocPath_.localPath(), &st) != 0 || uint64_t(st.st_dev) != snapshot.tocDevice_ ||
+        uint64_t(st.st_ino) != snapshot.tocInode_ || uint64_t(st.st_size) < snapshot.tocSize_) {
+        return false;
+    }
+    if (uint64_t(st.st_size) == snapshot.tocSize_ && int64_t(st.st_mtime) != snapshot.tocMTime_) {
+        return false;
+    }
+
+    changed = false;
+
+    // Records appended to the TOC. As in populateMaskedEntriesList, the masks of the TOC_CLEAR records are gathered
+    // first, as they also apply to the records that follow them.
+
+    struct TailRecord {
+        const TocRecord* record_;
+        size_t length_;
+        LocalPathName path_;
+        Offset offset_;
+        bool subToc_;
+    };
+    std::vector<TailRecord> tail;
+
+    TocSnapshot::MaskedEntries masked = snapshot.masked_;
+
+    if (uint64_t(st.st_size) > snapshot.tocSize_) {
+
+        std::vector<char> buffer;
+        size_t length = readTocRecords(tocPath_, snapshot.tocSize_, buffer);
+        snapshot.buffers_.emplace_back(std::move(buffer));
+        const char* records = snapshot.buffers_.back().data();
+
+        for (size_t pos = 0; pos < length;) {
+
+            const TocRecord* r = reinterpret_cast<const TocRecord*>(records + pos);
+            size_t len = r->header_.size_;
+            pos += len;
+
+            eckit::MemoryStream s(r->payload_, len - sizeof(TocRecord::Header));
+            LocalPathName path;
+            off_t offset;
+
+            switch (r->header_.tag_) {
+
+                case TocRecord::TOC_INDEX:
                     s >> path;
                     s >> offset;
-                    s >> type;
-                    LOG_DEBUG(debug, LibFdb5) << "TocRecord TOC_INDEX " << path << " - " << offset << std::endl;
-                    tocindexes[entry.seqNo] =
-                        new TocIndex(s, entry.datap->header_.serialisationVersion_, entry.tocDirectoryName,
-                                     entry.tocDirectoryName / path, offset, preloadBTree_);
+                    tail.emplace_back(TailRecord{r, len, path.baseName(), offset, false});
+                    break;
+
+                case TocRecord::TOC_SUB_TOC:
+                    s >> path;
+                    tail.emplace_back(TailRecord{r, len, path.baseName(), 0, true});
+                    break;
+
+                case TocRecord::TOC_CLEAR: {
+                    std::string clearPath;
+                    s >> clearPath;
+                    s >> offset;
+                    if (clearPath == "*") {  // mask everything already seen, as allMaskableEntries does
+                        for (const TocSnapshot::Entry& e : snapshot.entries_) {
+                            if (e.subToc_ < 0) {
+                                masked.emplace(e.path_, e.offset_);
+                            }
+                        }
+                        for (const TocSnapshot::SubToc& sub : snapshot.subTocs_) {
+                            masked.emplace(LocalPathName(sub.tocPath_).baseName(), 0);
+                        }
+                        for (const TailRecord& t : tail) {
+                            masked.emplace(t.path_, t.offset_);
+                        }
+                    }
+                    else {
+                        masked.emplace(LocalPathName(clearPath).baseName(), offset);
+                    }
+                    break;
                 }
-            }));
+
+                default:
+                    // A new TOC_INIT, or a record we do not know about. Leave that to a full replay.
+                    return false;
+            }
         }
 
-        for (auto& thread : threads) {
-            thread.get();
+        snapshot.tocSize_ += length;
+        changed = changed || (length > 0);
+    }
+
+    // Index records appended to the sub-TOCs already known. Their entries go after those already in the snapshot.
+
+    size_t nsubtocs = snapshot.subTocs_.size();
+    for (size_t i = 0; i < nsubtocs; ++i) {
+
+        TocSnapshot::SubToc& sub = snapshot.subTocs_[i];
+        LocalPathName subTocPath(sub.tocPath_);
+
+        if (masked.find(std::make_pair(subTocPath.baseName(), Offset(0))) != masked.end()) {
+            continue;
+        }
+
+        struct stat subst;
+        if (::stat(subTocPath.localPath(), &subst) != 0 || uint64_t(subst.st_size) < sub.size_) {
+            return false;
+        }
+        if (uint64_t(subst.st_size) == sub.size_) {
+            continue;
+        }
+        if (sub.masks_) {
+            return false;
+        }
+
+        std::vector<char> buffer;
+        size_t length = readTocRecords(subTocPath, sub.size_, buffer);
+        snapshot.buffers_.emplace_back(std::move(buffer));
+        const char* records = snapshot.buffers_.back().data();
+
+        std::vector<TocSnapshot::Entry> added;
+        for (size_t pos = 0; pos < length;) {
+
+            const TocRecord* r = reinterpret_cast<const TocRecord*>(records + pos);
+            size_t len = r->header_.size_;
+            pos += len;
+
+            if (r->header_.tag_ != TocRecord::TOC_INDEX) {
+                return false;
+            }
+
+            eckit::MemoryStream s(r->payload_, len - sizeof(TocRecord::Header));
+            LocalPathName path;
+            off_t offset;
+            s >> path;
+            s >> offset;
+            added.emplace_back(TocSnapshot::Entry{r, len, path.baseName(), offset, long(i)});
         }
 
-        indexes.reserve(indexEntries.size());
-        for (TocIndex* ti : tocindexes) {
-            indexes.emplace_back(ti);
+        size_t position = sub.position_;
+        while (position < snapshot.entries_.size() && snapshot.entries_[position].subToc_ == long(i)) {
+            ++position;
+        }
+        snapshot.entries_.insert(snapshot.entries_.begin() + position, added.begin(), added.end());
+        for (size_t j = i + 1; j < nsubtocs; ++j) {
+            snapshot.subTocs_[j].position_ += added.size();
         }
+
+        sub.size_ += length;
+        changed = changed || (length > 0);
     }
 
-    // For some purposes, it is useful to have the indexes sorted by their location, as this is is faster for
-    // iterating through the data.
+    // Then the records appended to the TOC, walking any new sub-TOCs
 
-    if (sorted) {
+    maskedEntries_ = masked;  // n.b. used by parseSubTocRecord
 
-        ASSERT(!indexInSubtoc);
-        ASSERT(!remapKeys);
-        std::sort(indexes.begin(), indexes.end(), TocIndexFileSort());
+    for (const TailRecord& t : tail) {
+
+        if (!t.subToc_) {
+            snapshot.entries_.emplace_back(TocSnapshot::Entry{t.record_, t.length_, t.path_, t.offset_, -1});
+            continue;
+        }
+
+        bool readMasked = false;
+        LocalPathName absPath = parseSubTocRecord(*t.record_, readMasked);
+        if (absPath == "") {
+            continue;
+        }
+        for (const TocSnapshot::SubToc& sub : snapshot.subTocs_) {
+            if (sub.tocPath_ == absPath.asString()) {
+                return false;
+            }
+        }
+
+        TocHandler subToc(absPath, parentKey_);
+
+        std::vector<char> buffer;
+        size_t length = readTocRecords(absPath, 0, buffer);
+        snapshot.buffers_.emplace_back(std::move(buffer));
+        const char* records = snapshot.buffers_.back().data();
+
+        long id = snapshot.subTocs_.size();
+        snapshot.subTocs_.emplace_back(TocSnapshot::SubToc{absPath, subToc.directory_, subToc.remapKey_, length, false,
+                                                           snapshot.entries_.size()});
+
+        for (size_t pos = 0; pos < length;) {
+
+            const TocRecord* r = reinterpret_cast<const TocRecord*>(records + pos);
+            size_t len = r->header_.size_;
+            pos += len;
+
+            if (r->header_.tag_ == TocRecord::TOC_INIT) {
+                continue;
+            }
+            if (r->header_.tag_ != TocRecord::TOC_INDEX) {
+                return false;
+            }
+
+            eckit::MemoryStream s(r->payload_, len - sizeof(TocRecord::Header));
+            LocalPathName path;
+            off_t offset;
+            s >> path;
+            s >> offset;
+            snapshot.entries_.emplace_back(TocSnapshot::Entry{r, len, path.baseName(), offset, id});
+        }
     }
-    else {
 
-        // In the normal case, the entries are sorted into reverse order. The last index takes precedence
-        std::reverse(indexes.begin(), indexes.end());
+    if (!changed) {
+        return true;
+    }
 
-        if (indexInSubtoc) {
-            std::reverse(indexInSubtoc->begin(), indexInSubtoc->end());
+    // Apply the masks of the new TOC_CLEAR records to all the entries, moving the sub-TOC positions to match
+
+    if (masked.size() != snapshot.masked_.size()) {
+
+        auto isMasked = [&](const TocSnapshot::Entry& e) {
+            if (masked.find(std::make_pair(e.path_, e.offset_)) != masked.end()) {
+                return true;
+            }
+            return e.subToc_ >= 0 &&
+                   masked.find(std::make_pair(LocalPathName(snapshot.subTocs_[e.subToc_].tocPath_).baseName(),
+                                              Offset(0))) != masked.end();
+        };
+
+        std::vector<TocSnapshot::Entry> entries;
+        entries.reserve(snapshot.entries_.size());
+
+        size_t k = 0;
+        for (size_t i = 0; i < snapshot.entries_.size(); ++i) {
+            for (; k < snapshot.subTocs_.size() && snapshot.subTocs_[k].position_ <= i; ++k) {
+                snapshot.subTocs_[k].position_ = entries.size();
+            }
+            if (!isMasked(snapshot.entries_[i])) {
+                entries.push_back(snapshot.entries_[i]);
+            }
         }
-        if (remapKeys) {
-            std::reverse(remapKeys->begin(), remapKeys->end());
+        for (; k < snapshot.subTocs_.size(); ++k) {
+            snapshot.subTocs_[k].position_ = entries.size();
         }
+
+        snapshot.entries_ = std::move(entries);
+        snapshot.masked_ = std::move(masked);
     }
 
-    return indexes;
+    snapshot.tocMTime_ = (uint64_t(st.st_size) == snapshot.tocSize_) ? st.st_mtime : 0;
+
+    return true;
+}
+
+size_t TocHandler::readTocRecords(const eckit::LocalPathName& path, uint64_t offset, std::vector<char>& buffer) const {
+
+    eckit::FileHandle file(path);
+    uint64_t size = file.openForRead();
+    AutoClose closer(file);
+
+    buffer.clear();
+    if (size <= offset) {
+        return 0;
+    }
+
+    buffer.resize(size - offset);
+    file.seek(offset);
+
+    size_t got = 0;
+    while (got < buffer.size()) {
+        long n = file.read(buffer.data() + got, buffer.size() - got);
+        if (n <= 0) {
+            break;
+        }
+        got += n;
+    }
+
+    // Only whole records are returned. One still being written is left for later.
+
+    size_t pos = 0;
+    while (pos + sizeof(TocRecord::Header) <= got) {
+        const auto* header = reinterpret_cast<const TocRecord::Header*>(buffer.data() + pos);
+        if (header->size_ < sizeof(TocRecord::Header) || header->size_ > got - pos) {
+            break;
+        }
+        serialisationVersion_.check(header->serialisationVersion_, true);
+        pos += header->size_;
+    }
+
+    return pos;
+}
+
+eckit::LocalPathName TocHandler::snapshotPath() const {
+    return directory_ / "toc-snapshot";
 }
 
 const eckit::LocalPathName& TocHandler::tocPath() const {
@@ -1788,6 +2274,11 @@ size_t TocHandler::buildIndexRecord(TocRecord& r, const Index& index) {
     s << index.type();
     index.encode(s, r.header_.serialisationVersion_);
 
+    // Optional, and ignored by readers that predate it. The padding that follows a record is zeroed.
+    if (const auto* tocIndex = dynamic_cast<const TocIndex*>(index.content())) {
+        tocIndex->encodeFilter(s, r.maxPayloadSize - s.position());
+    }
+
     return s.position();
 }
 
@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "eckit/filesystem/LocalPathName.h"
 #include "eckit/filesystem/PathName.h"
@@ -27,9 +28,11 @@
 
 #include "fdb5/config/Config.h"
 #include "fdb5/database/DbStats.h"
+#include "fdb5/database/Index.h"
 #include "fdb5/toc/TocCommon.h"
 #include "fdb5/toc/TocRecord.h"
 #include "fdb5/toc/TocSerialisationVersion.h"
+#include "fdb5/toc/TocSnapshot.h"
 
 
 namespace eckit {
@@ -40,7 +43,6 @@ class MemoryHandle;
 namespace fdb5 {
 
 class Key;
-class Index;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -134,6 +136,12 @@ public:  // methods
                                    std::vector<bool>* indexInSubtoc = nullptr,
                                    std::vector<Key>* remapKeys = nullptr) const;
 
+    /// Return the indexes, and their remapping keys, as loadIndexes does. The records read are remembered, so that
+    /// later calls only read those appended to the TOC and its sub-TOCs since, and reuse the indexes already loaded.
+    /// Returns false, leaving the arguments untouched, if there is nothing new. If the TOC has gone, returns true with
+    /// the arguments cleared if indexes were returned before, as they are gone with it, and false otherwise.
+    bool refreshIndexes(std::vector<Index>& indexes, std::vector<Key>& remapKeys) const;
+
     Key databaseKey();
     size_t numberOfRecords() const;
 
@@ -141,6 +149,9 @@ public:  // methods
     const eckit::LocalPathName& tocPath() const;
     const eckit::LocalPathName& schemaPath() const;
 
+    /// Where the resolved index list of the TOC is cached between openings (see loadIndexes)
+    eckit::LocalPathName snapshotPath() const;
+
     void dump(std::ostream& out, bool simple = false, bool walkSubTocs = true, bool dumpStructure = false) const;
     void dumpIndexFile(std::ostream& out, const eckit::PathName& indexFile) const;
     std::string dbOwner() const;
@@ -221,6 +232,23 @@ private:  // methods
     void populateMaskedEntriesList() const;
     void preloadSubTocs(bool readMasked) const;
 
+    /// The index records to load: from the saved snapshot if there is a usable one, or else from a replay of the TOC
+    std::unique_ptr<TocSnapshot> indexSnapshot(bool needParentKey) const;
+
+    /// Walk the TOC and its sub-TOCs, and return the index records found. The records point into the cached TOCs.
+    std::unique_ptr<TocSnapshot> replayToc() const;
+
+    /// Bring a snapshot up to date with the records appended since it was taken. Returns false if that is not
+    /// possible, and the TOC must be replayed in full.
+    bool updateSnapshot(TocSnapshot& snapshot, bool& changed) const;
+
+    /// Construct the indexes of the snapshot entries, in order, except those of records found in known
+    std::vector<Index> deserialiseIndexes(const TocSnapshot& snapshot,
+                                          const std::map<const TocRecord*, Index>& known) const;
+
+    /// Read the complete records of a TOC file from offset onwards. Returns the number of bytes read.
+    size_t readTocRecords(const eckit::LocalPathName& path, uint64_t offset, std::vector<char>& buffer) const;
+
     void append(TocRecord& r, size_t payloadSize);
 
     // Check if the Index record should be skipped
@@ -277,6 +305,10 @@ private:  // members
     mutable bool writeMode_;
 
     mutable bool dirty_;
+
+    /// The records and indexes returned by refreshIndexes, in TOC order
+    mutable std::unique_ptr<TocSnapshot> refreshState_;
+    mutable std::vector<Index> refreshIndexes_;
 };
 
 
@@ -9,6 +9,10 @@
  */
 
 #include "fdb5/toc/TocIndex.h"
+
+#include "eckit/config/Resource.h"
+#include "eckit/utils/StringTools.h"
+
 #include "fdb5/LibFdb5.h"
 #include "fdb5/toc/BTreeIndex.h"
 #include "fdb5/toc/FieldRef.h"
@@ -40,6 +44,24 @@ public:
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+bool sortedIndexWrite() {
+    static bool fdbSortedIndexWrite = eckit::Resource<bool>("fdbSortedIndexWrite;$FDB_SORTED_INDEX_WRITE", false);
+    return fdbSortedIndexWrite;
+}
+
+size_t bloomBitsPerKey() {
+    static size_t fdbIndexBloomBits = eckit::Resource<size_t>("fdbIndexBloomBits;$FDB_INDEX_BLOOM_BITS", 0);
+    return fdbIndexBloomBits;
+}
+
+const std::string bloomFilterTag = "bloom";
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 /// @note We use a FileStoreWrapper base that only exists to initialise the uris_ member function
 ///       before the Index constructor is called. This is necessary as due to (preexisting)
 ///       serialisation ordering, the uris_ member needs to be initialised from a Stream
@@ -54,6 +76,7 @@ TocIndex::TocIndex(const Key& key, const eckit::PathName& path, off_t offset, Mo
     IndexBase(key, type),
     btree_(nullptr),
     dirty_(false),
+    sortedWrite_(mode == TocIndex::WRITE && sortedIndexWrite()),
     mode_(mode),
     location_(path, offset),
     preloadBTree_(false) {}
@@ -64,6 +87,7 @@ TocIndex::TocIndex(eckit::Stream& s, const int version, const eckit::PathName& d
     IndexBase(s, version),
     btree_(nullptr),
     dirty_(false),
+    sortedWrite_(false),
     mode_(TocIndex::READ),
     location_(path, offset),
     preloadBTree_(preloadBTree) {}
@@ -77,12 +101,48 @@ void TocIndex::encode(eckit::Stream& s, const int version) const {
     IndexBase::encode(s, version);
 }
 
+void TocIndex::encodeFilter(eckit::Stream& s, size_t available) const {
+    if (filter_.empty()) {
+        return;
+    }
+    if (filter_.encodedSize() + bloomFilterTag.size() + 16 > available) {
+        LOG_DEBUG_LIB(LibFdb5) << "No room for " << filter_ << " of " << *this << std::endl;
+        return;
+    }
+    s << bloomFilterTag;
+    filter_.encode(s);
+}
+
+void TocIndex::decodeFilter(eckit::Stream& s) {
+    std::string tag;
+    s >> tag;
+    if (tag == bloomFilterTag) {
+        filter_ = BloomFilter(s);
+    }
+}
+
+bool TocIndex::mayContain(const Key& key) const {
+    return IndexBase::mayContain(key) && filter_.mayContain(key);
+}
+
 
 bool TocIndex::get(const Key& key, const Key& remapKey, Field& field) const {
     ASSERT(btree_);
     FieldRef ref;
 
-    bool found = btree_->get(key.valuesToString(), ref);
+    // Reused, so that binary fingerprints are written without allocating once the buffer has grown
+    thread_local std::string fingerprint;
+    btree_->fingerprint(key, fingerprint);
+
+    // Entries buffered in sorted write mode are newer than those in the btree
+    bool found = false;
+    if (auto it = pending_.find(fingerprint); it != pending_.end()) {
+        ref = it->second;
+        found = true;
+    }
+    else {
+        found = btree_->get(fingerprint, ref);
+    }
     if (found) {
         const eckit::URI& uri = uris_.get(ref.uriId());
         FieldLocation* loc =
@@ -116,12 +176,15 @@ void TocIndex::reopen() {
     // at the second level of the schema, but is a NEW index).
 
     axes_.wipe();
+    keyHashes_.clear();
+    filter_ = BloomFilter();
 
     open();
 }
 
 void TocIndex::close() {
     if (btree_) {
+        writePending();
         LOG_DEBUG_LIB(LibFdb5) << "Closing " << *this << std::endl;
         btree_.reset();
     }
@@ -133,20 +196,51 @@ void TocIndex::add(const Key& key, const Field& field) {
 
     FieldRef ref(uris_, field);
 
-    //  bool replace =
-    btree_->set(key.valuesToString(), ref);  // returns true if replace, false if new insert
+    if (bloomBitsPerKey() > 0) {
+        keyHashes_.push_back(BloomFilter::hash(key));
+    }
+
+    thread_local std::string fingerprint;
+    btree_->fingerprint(key, fingerprint);
+
+    if (sortedWrite_) {
+        // the last entry for a key wins, as it would in the btree
+        pending_[fingerprint] = ref;
+    }
+    else {
+        //  bool replace =
+        btree_->set(fingerprint, ref);  // returns true if replace, false if new insert
+    }
 
     dirty_ = true;
 }
 
+void TocIndex::writePending() {
+    if (pending_.empty()) {
+        return;
+    }
+
+    ASSERT(btree_);
+    LOG_DEBUG_LIB(LibFdb5) << "Writing " << pending_.size() << " sorted entries to " << *this << std::endl;
+
+    for (const auto& [fingerprint, ref] : pending_) {
+        btree_->set(fingerprint, ref);
+    }
+    pending_.clear();
+}
+
 void TocIndex::flush() {
     ASSERT(mode_ == TocIndex::WRITE);
 
     if (dirty_) {
         axes_.sort();
         ASSERT(btree_);
+        writePending();
         btree_->flush();
         btree_->sync();
+        if (!keyHashes_.empty()) {
+            filter_ = BloomFilter(keyHashes_, bloomBitsPerKey());
+        }
         takeTimestamp();
         dirty_ = false;
     }
@@ -166,6 +260,45 @@ void TocIndex::funlock() const {
     btree_->funlock();
 }
 
+/// Visits the entries of the btree merged, in key order, with those buffered in sorted write mode, which replace the
+/// btree entries with the same key. This is what the btree would hold once the buffered entries are written to it.
+class PendingEntriesVisitor : public BTreeIndexVisitor {
+    const std::map<std::string, FieldRef>& pending_;
+    std::map<std::string, FieldRef>::const_iterator next_;
+    BTreeIndexVisitor& visitor_;
+
+public:
+
+    PendingEntriesVisitor(const std::map<std::string, FieldRef>& pending, BTreeIndexVisitor& visitor) :
+        pending_(pending), next_(pending.begin()), visitor_(visitor) {}
+
+    void visit(const std::string& keyFingerprint, const FieldRef& ref) override {
+        for (; next_ != pending_.end() && next_->first < keyFingerprint; ++next_) {
+            visitor_.visit(next_->first, next_->second);
+        }
+        if (pending_.find(keyFingerprint) == pending_.end()) {
+            visitor_.visit(keyFingerprint, ref);
+        }
+    }
+
+    void finish() {
+        for (; next_ != pending_.end(); ++next_) {
+            visitor_.visit(next_->first, next_->second);
+        }
+    }
+};
+
+void TocIndex::visitBTree(BTreeIndexVisitor& visitor) const {
+    ASSERT(btree_);
+    if (pending_.empty()) {
+        btree_->visit(visitor);
+        return;
+    }
+    PendingEntriesVisitor merged(pending_, visitor);
+    btree_->visit(merged);
+    merged.finish();
+}
+
 class TocIndexVisitor : public BTreeIndexVisitor {
     const UriStore& uris_;
     EntryVisitor& visitor_;
@@ -189,7 +322,7 @@ void TocIndex::entries(EntryVisitor& visitor) const {
     if (visitor.visitIndex(instantIndex)) {
         TocIndexCloser closer(*this);
         TocIndexVisitor v(uris_, visitor);
-        btree_->visit(v);
+        visitBTree(v);
     }
 }
 
@@ -221,6 +354,13 @@ public:
 
     void visit(const std::string& key, const FieldRef& ref) {
 
+        eckit::StringList values;
+        if (Key::fingerprintToValues(key, values)) {
+            out_ << indent_ << "Fingerprint: " << eckit::StringTools::join(":", values) << ", location: " << ref
+                 << std::endl;
+            return;
+        }
+
         out_ << indent_ << "Fingerprint: " << key << ", location: " << ref << std::endl;
     }
 };
@@ -233,6 +373,9 @@ void TocIndex::dump(std::ostream& out, const char* indent, bool simple, bool dum
         out << std::endl;
         uris_.dump(out, indent);
         axes_.dump(out, indent);
+        if (!filter_.empty()) {
+            out << indent << filter_ << std::endl;
+        }
     }
 
     if (dumpFields) {
@@ -242,7 +385,7 @@ void TocIndex::dump(std::ostream& out, const char* indent, bool simple, bool dum
         out << indent << "Contents of index: " << std::endl;
 
         TocIndexCloser closer(*this);
-        btree_->visit(v);
+        visitBTree(v);
     }
 }
 
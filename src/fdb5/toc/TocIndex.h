@@ -15,6 +15,9 @@
 #ifndef fdb5_TocIndex_H
 #define fdb5_TocIndex_H
 
+#include <map>
+#include <string>
+
 #include "eckit/eckit.h"
 
 #include "eckit/container/BTree.h"
@@ -23,8 +26,10 @@
 
 #include "eckit/types/FixedString.h"
 
+#include "fdb5/database/BloomFilter.h"
 #include "fdb5/database/Index.h"
 #include "fdb5/database/UriStore.h"
+#include "fdb5/toc/FieldRef.h"
 #include "fdb5/toc/TocIndexLocation.h"
 
 namespace fdb5 {
@@ -32,6 +37,7 @@ namespace fdb5 {
 //----------------------------------------------------------------------------------------------------------------------
 
 class BTreeIndex;
+class BTreeIndexVisitor;
 
 
 /// FileStoreWrapper exists _only_ so that the uris_ member can be initialised from the stream
@@ -77,6 +83,13 @@ public:  // methods
     void flock() const override;
     void funlock() const override;
 
+    bool mayContain(const Key& key) const override;
+
+    /// The Bloom filter of the index is stored after the index in its TOC record, where readers that do not know
+    /// about it ignore it. @p available is the space left in the record, and the filter is dropped if it does not fit.
+    void encodeFilter(eckit::Stream& s, size_t available) const;
+    void decodeFilter(eckit::Stream& s);
+
 private:  // methods
 
     const IndexLocation& location() const override { return location_; }
@@ -102,12 +115,27 @@ private:  // methods
 
     IndexStats statistics() const override;
 
+    /// Inserts the entries buffered by add() into the btree, in key order
+    void writePending();
+
+    /// Visits the btree as it will be once the buffered entries are written, without writing them
+    void visitBTree(BTreeIndexVisitor& visitor) const;
+
 private:  // members
 
     std::unique_ptr<BTreeIndex> btree_;
 
     bool dirty_;
 
+    /// In sorted write mode, entries are buffered here and only inserted into the btree (in key order) when the
+    /// index is flushed, so that the btree pages are filled sequentially rather than in arrival order.
+    bool sortedWrite_;
+    std::map<std::string, FieldRef> pending_;
+
+    /// Hashes of the keys added since the index was last reopened, from which the filter is built when flushed
+    std::vector<uint64_t> keyHashes_;
+    BloomFilter filter_;
+
     friend class TocIndexCloser;
 
     const TocIndex::Mode mode_;
@@ -14,6 +14,7 @@
 
 #include "eckit/config/Resource.h"
 #include "eckit/distributed/Message.h"
+#include "eckit/log/Log.h"
 #include "eckit/os/Stat.h"
 
 #include "fdb5/api/helpers/ControlIterator.h"
@@ -51,14 +52,13 @@ bool TocMoveVisitor::visitDatabase(const Catalogue& catalogue) {
 
     MoveVisitor::visitDatabase(catalogue_);
 
-    // TOC specific checks: index files not locked
+    // TOC specific checks: index files not locked. The locks are held until the source is cleaned up after the move
     DIR* dirp = ::opendir(catalogue_.basePath().c_str());
     struct dirent* dp;
     while ((dp = readdir(dirp)) != NULL) {
         if (strstr(dp->d_name, ".index")) {
-            eckit::PathName src_ = PathName(catalogue_.basePath()) / dp->d_name;
-            int fd = ::open(src_.asString().c_str(), O_RDWR);
-            if (::flock(fd, LOCK_EX)) {
+            if (!MoveLocks::lock(catalogue_.basePath(), dp->d_name)) {
+                closedir(dirp);
                 std::ostringstream ss;
                 ss << "Index file " << dp->d_name << " is locked";
                 throw eckit::UserError(ss.str(), Here());
@@ -79,9 +79,13 @@ bool TocMoveVisitor::visitDatabase(const Catalogue& catalogue) {
                 eckit::PathName dest_db = destPath / catalogue_.basePath().baseName(true);
 
                 if (dest_db.exists()) {
-                    std::ostringstream ss;
-                    ss << "Target folder already exist!" << std::endl;
-                    throw UserError(ss.str(), Here());
+                    if (!MoveJournal::exists(dest_db)) {
+                        std::ostringstream ss;
+                        ss << "Target folder already exist!" << std::endl;
+                        throw UserError(ss.str(), Here());
+                    }
+                    eckit::Log::info() << "Resuming the interrupted move of " << catalogue_.key() << " to " << dest_db
+                                       << std::endl;
                 }
                 found = true;
                 break;
@@ -109,9 +113,17 @@ bool TocMoveVisitor::visitDatabase(const Catalogue& catalogue) {
 
 void TocMoveVisitor::move() {
 
+    eckit::PathName destPath = dest_.path();
+
+    // Before any file is copied, so that the move can be resumed if it is interrupted
+    for (const eckit::PathName& root : CatalogueRootManager(catalogue_.config()).canMoveToRoots(catalogue_.key())) {
+        if (root.sameAs(destPath)) {
+            MoveJournal::begin(destPath / catalogue_.basePath().baseName(true));
+        }
+    }
+
     store_.moveTo(catalogue_.key(), catalogue_.config(), dest_, queue_);
 
-    eckit::PathName destPath = dest_.path();
     for (const eckit::PathName& root : CatalogueRootManager(catalogue_.config()).canMoveToRoots(catalogue_.key())) {
         if (root.sameAs(destPath)) {
             eckit::PathName dest_db = destPath / catalogue_.basePath().baseName(true);
@@ -0,0 +1,311 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/log/Log.h"
+#include "eckit/maths/Functions.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+#include "eckit/utils/Literals.h"
+
+#include "fdb5/LibFdb5.h"
+#include "fdb5/toc/TocSnapshot.h"
+
+using namespace eckit::literals;
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+struct TocSnapshotHeader {
+    char magic_[8];
+    uint32_t version_;
+    uint32_t spare_;
+    uint64_t length_;             ///< size of the whole file
+    uint64_t descriptionLength_;  ///< size of the serialised description, following the header
+    uint64_t recordsOffset_;      ///< position of the first index record
+};
+
+const char tocSnapshotMagic[8] = {'F', 'D', 'B', 'T', 'S', 'N', 'P', '\0'};
+const uint32_t tocSnapshotVersion = 1;
+
+/// The records are page-aligned, so the whole file can be mapped and read in place
+const size_t tocSnapshotAlignment = 4096;
+
+void writeAll(int fd, const void* data, size_t len, const eckit::PathName& path) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n;
+        SYSCALL2(n = ::write(fd, p, len), path);
+        p += n;
+        len -= n;
+    }
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TocSnapshot::TocSnapshot() :
+    dbUID_(static_cast<uid_t>(-1)),
+    tocDevice_(0),
+    tocInode_(0),
+    tocSize_(0),
+    tocMTime_(0),
+    mapped_(nullptr),
+    mappedLength_(0) {}
+
+TocSnapshot::~TocSnapshot() {
+    if (mapped_) {
+        ::munmap(mapped_, mappedLength_);
+    }
+}
+
+std::unique_ptr<TocSnapshot> TocSnapshot::load(const eckit::LocalPathName& path) {
+
+    int fd = ::open(path.localPath(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    bool ok = (::fstat(fd, &st) == 0) && (size_t(st.st_size) >= sizeof(TocSnapshotHeader));
+
+    void* mapped = ok ? ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto snapshot = std::make_unique<TocSnapshot>();
+    snapshot->mapped_ = mapped;
+    snapshot->mappedLength_ = st.st_size;
+
+    const char* base = static_cast<const char*>(mapped);
+    TocSnapshotHeader header;
+    ::memcpy(&header, base, sizeof(header));
+
+    if (::memcmp(header.magic_, tocSnapshotMagic, sizeof(tocSnapshotMagic)) != 0 ||
+        header.version_ != tocSnapshotVersion || header.length_ != uint64_t(st.st_size) ||
+        sizeof(TocSnapshotHeader) + header.descriptionLength_ > header.recordsOffset_ ||
+        header.recordsOffset_ > header.length_) {
+        LOG_DEBUG_LIB(LibFdb5) << "Ignoring invalid TOC snapshot " << path << std::endl;
+        return nullptr;
+    }
+
+    const char* records = base + header.recordsOffset_;
+    const uint64_t recordsLength = header.length_ - header.recordsOffset_;
+
+    try {
+        eckit::MemoryStream s(base + sizeof(TocSnapshotHeader), header.descriptionLength_);
+
+        unsigned long long u;
+        long long l;
+        std::string str;
+
+        snapshot->dbKey_ = Key(s);
+        s >> u;
+        snapshot->dbUID_ = u;
+        s >> u;
+        snapshot->tocDevice_ = u;
+        s >> u;
+        snapshot->tocInode_ = u;
+        s >> u;
+        snapshot->tocSize_ = u;
+        s >> l;
+        snapshot->tocMTime_ = l;
+
+        unsigned long long count;
+        s >> count;
+        for (unsigned long long i = 0; i < count; ++i) {
+            s >> str;
+            s >> l;
+            snapshot->masked_.emplace(eckit::LocalPathName(str), eckit::Offset(l));
+        }
+
+        s >> count;
+        snapshot->subTocs_.reserve(count);
+        for (unsigned long long i = 0; i < count; ++i) {
+            SubToc sub;
+            s >> sub.tocPath_;
+            s >> sub.directory_;
+            sub.remapKey_ = Key(s);
+            s >> u;
+            sub.size_ = u;
+            s >> sub.masks_;
+            s >> u;
+            sub.position_ = u;
+            snapshot->subTocs_.emplace_back(std::move(sub));
+        }
+
+        s >> count;
+        snapshot->entries_.reserve(count);
+        for (unsigned long long i = 0; i < count; ++i) {
+            Entry e;
+            unsigned long long position;
+            s >> position;
+            s >> u;
+            e.length_ = u;
+            s >> str;
+            e.path_ = str;
+            s >> l;
+            e.offset_ = l;
+            s >> l;
+            e.subToc_ = l;
+
+            if (position + e.length_ > recordsLength || e.length_ < sizeof(TocRecord::Header) ||
+                e.subToc_ >= long(snapshot->subTocs_.size())) {
+                throw eckit::SeriousBug("Index record out of range in TOC snapshot", Here());
+            }
+            e.record_ = reinterpret_cast<const TocRecord*>(records + position);
+            if (e.record_->header_.tag_ != TocRecord::TOC_INDEX || e.record_->header_.size_ != e.length_) {
+                throw eckit::SeriousBug("Unexpected record in TOC snapshot", Here());
+            }
+            snapshot->entries_.emplace_back(std::move(e));
+        }
+
+        for (const SubToc& sub : snapshot->subTocs_) {
+            if (sub.position_ > snapshot->entries_.size()) {
+                throw eckit::SeriousBug("Sub-TOC out of range in TOC snapshot", Here());
+            }
+        }
+    }
+    catch (eckit::Exception& e) {
+        eckit::Log::warning() << "Ignoring corrupt TOC snapshot " << path << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    return snapshot;
+}
+
+void TocSnapshot::save(const eckit::LocalPathName& path) const {
+
+    eckit::LocalPathName tmp{eckit::PathName::unique(path)};
+
+    try {
+        eckit::Buffer buffer(64_KiB);
+        eckit::ResizableMemoryStream s(buffer);
+
+        s << dbKey_;
+        s << static_cast<unsigned long long>(dbUID_);
+        s << static_cast<unsigned long long>(tocDevice_);
+        s << static_cast<unsigned long long>(tocInode_);
+        s << static_cast<unsigned long long>(tocSize_);
+        s << static_cast<long long>(tocMTime_);
+
+        s << static_cast<unsigned long long>(masked_.size());
+        for (const auto& [p, offset] : masked_) {
+            s << p.asString();
+            s << static_cast<long long>(offset);
+        }
+
+        s << static_cast<unsigned long long>(subTocs_.size());
+        for (const SubToc& sub : subTocs_) {
+            s << sub.tocPath_;
+            s << sub.directory_;
+            s << sub.remapKey_;
+            s << static_cast<unsigned long long>(sub.size_);
+            s << sub.masks_;
+            s << static_cast<unsigned long long>(sub.position_);
+        }
+
+        s << static_cast<unsigned long long>(entries_.size());
+        unsigned long long position = 0;
+        for (const Entry& e : entries_) {
+            s << position;
+            s << static_cast<unsigned long long>(e.length_);
+            s << e.path_.asString();
+            s << static_cast<long long>(e.offset_);
+            s << static_cast<long long>(e.subToc_);
+            position += e.length_;
+        }
+
+        TocSnapshotHeader header;
+        ::memset(&header, 0, sizeof(header));
+        ::memcpy(header.magic_, tocSnapshotMagic, sizeof(tocSnapshotMagic));
+        header.version_ = tocSnapshotVersion;
+        header.descriptionLength_ = s.position();
+        header.recordsOffset_ = eckit::round(sizeof(header) + header.descriptionLength_, tocSnapshotAlignment);
+        header.length_ = header.recordsOffset_ + position;
+
+        int fd;
+        SYSCALL2(fd = ::open(tmp.localPath(), O_WRONLY | O_CREAT | O_EXCL, (mode_t)0777), tmp);
+        try {
+            std::vector<char> padding(header.recordsOffset_ - sizeof(header) - header.descriptionLength_, 0);
+            writeAll(fd, &header, sizeof(header), tmp);
+            writeAll(fd, buffer.data(), header.descriptionLength_, tmp);
+            writeAll(fd, padding.data(), padding.size(), tmp);
+            for (const Entry& e : entries_) {
+                writeAll(fd, e.record_, e.length_, tmp);
+            }
+        }
+        catch (...) {
+            ::close(fd);
+            throw;
+        }
+        SYSCALL2(::close(fd), tmp);
+
+        eckit::LocalPathName::rename(tmp, path);
+
+        LOG_DEBUG_LIB(LibFdb5) << "Written TOC snapshot " << path << " with " << entries_.size() << " indexes"
+                               << std::endl;
+    }
+    catch (eckit::Exception& e) {
+        LOG_DEBUG_LIB(LibFdb5) << "Could not write TOC snapshot " << path << ": " << e.what() << std::endl;
+        if (tmp.exists()) {
+            tmp.unlink(false);
+        }
+    }
+}
+
+void TocSnapshot::detach() {
+
+    size_t total = 0;
+    for (const Entry& e : entries_) {
+        total += e.length_;
+    }
+
+    std::vector<char> buffer(total);
+    size_t position = 0;
+    for (Entry& e : entries_) {
+        ::memcpy(buffer.data() + position, e.record_, e.length_);
+        e.record_ = reinterpret_cast<const TocRecord*>(buffer.data() + position);
+        position += e.length_;
+    }
+
+    buffers_.clear();
+    buffers_.emplace_back(std::move(buffer));
+
+    if (mapped_) {
+        ::munmap(mapped_, mappedLength_);
+        mapped_ = nullptr;
+        mappedLength_ = 0;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
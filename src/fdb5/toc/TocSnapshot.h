@@ -0,0 +1,114 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   TocSnapshot.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/io/Offset.h"
+
+#include "fdb5/database/Key.h"
+#include "fdb5/toc/TocRecord.h"
+
+namespace fdb5 {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The resolved list of index records of a TOC and its sub-TOCs, as of given sizes of those files.
+///
+/// The records are those that TocHandler::loadIndexes would visit, in the same order, with the masks of the TOC_CLEAR
+/// records already applied. The masks are kept too, as they also apply to records appended later.
+///
+/// On disk, the snapshot is a header and the serialised description, followed by the raw index records back to back,
+/// so that it can be memory-mapped and the indexes deserialised in place.
+class TocSnapshot {
+
+public:  // types
+
+    using MaskedEntries = std::set<std::pair<eckit::LocalPathName, eckit::Offset>>;
+
+    struct SubToc {
+        std::string tocPath_;
+        std::string directory_;
+        Key remapKey_;
+        uint64_t size_;    ///< bytes of the sub-TOC already read
+        bool masks_;       ///< the sub-TOC contains TOC_CLEAR records of its own
+        size_t position_;  ///< position in entries_ of the first index of the sub-TOC
+    };
+
+    struct Entry {
+        const TocRecord* record_;  ///< n.b. non-owning
+        size_t length_;
+        eckit::LocalPathName path_;  ///< base name of the index file, as used for masking
+        eckit::Offset offset_;
+        long subToc_;  ///< position in subTocs_, or -1 if the record is in the TOC itself
+    };
+
+public:  // methods
+
+    TocSnapshot();
+    ~TocSnapshot();
+
+    TocSnapshot(const TocSnapshot&) = delete;
+    TocSnapshot& operator=(const TocSnapshot&) = delete;
+
+    /// Maps and decodes a snapshot. Returns nullptr if there is none, or it cannot be used.
+    static std::unique_ptr<TocSnapshot> load(const eckit::LocalPathName& path);
+
+    /// Writes the snapshot, replacing any existing one atomically. Failures are not errors, as readers may not have
+    /// write access to the database.
+    void save(const eckit::LocalPathName& path) const;
+
+    /// Copies the records into memory owned by the snapshot, so that they outlive the files or caches they were read
+    /// from
+    void detach();
+
+    bool masked(const eckit::LocalPathName& path, const eckit::Offset& offset) const {
+        return masked_.find(std::make_pair(path, offset)) != masked_.end();
+    }
+
+public:  // members
+
+    Key dbKey_;
+    uid_t dbUID_;
+
+    // The TOC the snapshot was taken from, and how much of it was read
+    uint64_t tocDevice_;
+    uint64_t tocInode_;
+    uint64_t tocSize_;
+    int64_t tocMTime_;
+
+    MaskedEntries masked_;
+    std::vector<SubToc> subTocs_;
+    std::vector<Entry> entries_;
+
+    /// Records read after the snapshot was loaded, referenced by entries_
+    std::vector<std::vector<char>> buffers_;
+
+private:  // members
+
+    void* mapped_;
+    size_t mappedLength_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5
@@ -10,12 +10,15 @@
 
 #include <dirent.h>
 #include <fcntl.h>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include "eckit/config/Resource.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/filesystem/URI.h"
 #include "eckit/io/AIOHandle.h"
+#include "eckit/io/Buffer.h"
 #include "eckit/io/EmptyHandle.h"
 
 #include "fdb5/LibFdb5.h"
@@ -155,6 +158,71 @@ std::unique_ptr<const FieldLocation> TocStore::archive(const Key& idxKey, const
     return std::make_unique<TocFieldLocation>(dataPath, position, length, Key());
 }
 
+void TocStore::archiveBatch(
+    const Key& idxKey, const std::vector<const ArchiveItem*>& fields,
+    std::function<void(size_t, std::unique_ptr<const FieldLocation> fieldLocation)> catalogue_archive) {
+
+    if (fields.size() == 1) {
+        catalogue_archive(0, archive(idxKey, fields.front()->data, fields.front()->length));
+        return;
+    }
+
+    // The fields of a batch are laid out contiguously, from a single base offset. They are gathered into a staging
+    // buffer, bounded by fdbArchiveBatchBufferSize, so that a batch that fits is written with a single call
+    static size_t bufferSize =
+        eckit::Resource<size_t>("fdbArchiveBatchBufferSize;$FDB_ARCHIVE_BATCH_BUFFER_SIZE", 64_MiB);
+
+    size_t total = 0;
+    for (const auto* field : fields) {
+        total += field->length;
+    }
+
+    eckit::PathName dataPath = getDataPath(idxKey);
+
+    eckit::DataHandle& dh = getDataHandle(dataPath);
+
+    const eckit::Offset base = dh.position();
+
+    eckit::Buffer staging(std::min(total, bufferSize));
+    char* start = static_cast<char*>(staging.data());
+    size_t staged = 0;
+
+    auto write = [&dh](const void* data, size_t length) {
+        long len = dh.write(data, length);
+        ASSERT(len == static_cast<long>(length));
+    };
+
+    for (const auto* field : fields) {
+        if (field->length == 0) {
+            continue;
+        }
+        if (staged + field->length > staging.size()) {
+            if (staged > 0) {
+                write(start, staged);
+                staged = 0;
+            }
+            // Larger than the staging buffer: written as it is
+            if (field->length > staging.size()) {
+                write(field->data, field->length);
+                continue;
+            }
+        }
+        ::memcpy(start + staged, field->data, field->length);
+        staged += field->length;
+    }
+    if (staged > 0) {
+        write(start, staged);
+    }
+
+    archivedFields_ += fields.size();
+
+    eckit::Offset position = base;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        catalogue_archive(i, std::make_unique<TocFieldLocation>(dataPath, position, fields[i]->length, Key()));
+        position += fields[i]->length;
+    }
+}
+
 size_t TocStore::flush() {
     if (archivedFields_ == 0) {
         return 0;
@@ -76,6 +76,9 @@ protected:  // methods
 
     eckit::DataHandle* retrieve(Field& field) const override;
     std::unique_ptr<const FieldLocation> archive(const Key& idxKey, const void* data, eckit::Length length) override;
+    void archiveBatch(
+        const Key& idxKey, const std::vector<const ArchiveItem*>& fields,
+        std::function<void(size_t, std::unique_ptr<const FieldLocation> fieldLocation)> catalogue_archive) override;
 
     void remove(const eckit::URI& uri, std::ostream& logAlways, std::ostream& logVerbose, bool doit) const override;
 
@@ -31,12 +31,15 @@
 #include "eckit/option/CmdArgs.h"
 #include "eckit/option/SimpleOption.h"
 #include "eckit/serialisation/HandleStream.h"
+#include "eckit/types/Date.h"
 #include "eckit/utils/Literals.h"
 #include "eckit/utils/MD5.h"
 
 #include "eccodes.h"
 
 #include <algorithm>
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <memory>
@@ -149,6 +152,8 @@ struct HammerConfig {
         bool itt;
         std::string uriFile;
         long checkQueueSize;
+        long threads;  // 0 = single writer through MessageArchiver; >0 = threads sharing one FDB
+        bool concurrentArchive;
     };
 
     struct TimingConfig {
@@ -526,6 +531,13 @@ void HammerConfig::constructOptions(std::vector<eckit::option::Option*>& options
         "Disable randomisation of field data written. Written field data is randomised by default unless "
         " --full-check is supplied."));
     options.push_back(new eckit::option::SimpleOption<bool>("itt", "Run the benchmark in ITT mode"));
+    options.push_back(new eckit::option::SimpleOption<long>(
+        "threads",
+        "Number of writer threads sharing a single FDB object. Each thread archives the full set of fields into "
+        "its own database (the date is offset by the thread index). Write mode only."));
+    options.push_back(new eckit::option::SimpleOption<bool>(
+        "no-concurrent-archive",
+        "With --threads, serialise all archive calls in the shared FDB (disables the concurrentArchive option)"));
     options.push_back(new eckit::option::SimpleOption<long>(
         "check-queue-size",
         "How many messages should be stored in the message queue for asynchronous processing of checks. "
@@ -612,6 +624,8 @@ HammerConfig HammerConfig::parse(const eckit::option::CmdArgs& args) {
         itt,
         args.getString("uri-file", ""),
         args.getLong("check-queue-size", 11),
+        args.getLong("threads", 0),
+        !args.getBool("no-concurrent-archive", false),
     };
 
     config.timing = {
@@ -643,6 +657,15 @@ HammerConfig HammerConfig::parse(const eckit::option::CmdArgs& args) {
 
     // post-Validation
 
+    if (config.execution.threads > 0) {
+        if (config.execution.mode != Mode::Write || itt) {
+            throw UserError("--threads is only supported in (non-ITT) write mode", Here());
+        }
+        if (config.execution.mdCheck || config.execution.fullCheck) {
+            throw UserError("--threads cannot be combined with --md-check or --full-check", Here());
+        }
+    }
+
     // if (config.execution.mode == Mode::Write && config.execution.randomiseData && config.execution.fullCheck) {
     //     throw UserError("Cannot enable full consistency checks with data randomisation enabled", Here());
     // }
@@ -788,6 +811,7 @@ private:  // methods
     void execute(const eckit::option::CmdArgs& args) override;
     void executeRead();
     void executeWrite();
+    void executeWriteThreaded();
     void executeList();
 
     std::pair<std::unique_ptr<DataHandle>, std::deque<Key>> constructReadData(std::optional<FDB>& fdb,
@@ -815,6 +839,7 @@ void FDBHammer::usage(const std::string& tool) const {
                        << "Usage: " << tool
                        << " [--read] [--list] [--no-randomise-data] [--md-check|--full-check] [--statistics] "
                           "[--itt] [--step-window] [--random-delay] [--poll-period=<period>] [--uri-file=<path>] "
+                          "[--threads=<nthreads> [--no-concurrent-archive]] "
                           "[--poll-max-attempts=<attempts>] [--ppn=<ppn>] "
                           "[--nodes=<hostname1,hostname2,...>] [--barrier-port=<port>] [--barrier-max-wait=<seconds>] "
                           "--expver=<expver> --nparams=<nparams> "
@@ -1119,6 +1144,9 @@ void FDBHammer::execute(const eckit::option::CmdArgs&) {
     else if (config_.execution.mode == HammerConfig::Mode::List) {
         executeList();
     }
+    else if (config_.execution.threads > 0) {
+        executeWriteThreaded();
+    }
     else {
         executeWrite();
     }
@@ -1349,6 +1377,118 @@ void FDBHammer::executeWrite() {
     }
 }
 
+void FDBHammer::executeWriteThreaded() {
+
+    // Models a multi-threaded I/O server: all the threads archive through one shared FDB object, each into its own
+    // database. With concurrentArchive enabled the total rate should grow with the number of threads.
+
+    const long nthreads = config_.execution.threads;
+
+    Config fdbConfig = config_.fdbConfig.expandConfig();
+    fdbConfig.set("concurrentArchive", config_.execution.concurrentArchive);
+
+    fdb5::FDB fdb(fdbConfig);
+
+    eckit::AutoStdFile fin(config_.execution.templateGrib);
+
+    int err;
+    codes_handle* templateHandle = codes_handle_new_from_file(nullptr, fin, PRODUCT_GRIB, &err);
+    ASSERT(templateHandle);
+
+    {
+        size_t size = config_.request.expver.length();
+        CODES_CHECK(codes_set_string(templateHandle, "expver", config_.request.expver.c_str(), &size), 0);
+        size = config_.request.class_.length();
+        CODES_CHECK(codes_set_string(templateHandle, "class", config_.request.class_.c_str(), &size), 0);
+    }
+
+    long baseDate = 0;
+    CODES_CHECK(codes_get_long(templateHandle, "dataDate", &baseDate), 0);
+
+    std::atomic<size_t> writeCount{0};
+    std::atomic<size_t> bytesWritten{0};
+    std::vector<std::exception_ptr> errors(nthreads);
+
+    auto worker = [&](long ithread) {
+        codes_handle* handle = codes_handle_clone(templateHandle);
+        ASSERT(handle);
+
+        try {
+            // one database per thread
+            CODES_CHECK(codes_set_long(handle, "dataDate", (eckit::Date(baseDate) + ithread).yyyymmdd()), 0);
+
+            for (const auto& istep : config_.request.steplist) {
+                CODES_CHECK(codes_set_long(handle, "step", istep), 0);
+                for (const auto& imember : config_.request.ensemblelist) {
+                    if (config_.iteration.hasEnsembles) {
+                        CODES_CHECK(codes_set_long(handle, "number", imember), 0);
+                    }
+                    long iter_count = 0;
+                    for (const auto& ilevel : config_.request.levelist) {
+                        CODES_CHECK(codes_set_long(handle, "level", ilevel), 0);
+                        for (const auto& iparam : config_.request.paramlist) {
+                            if (iter_count > config_.iteration.stopAtChunk) {
+                                break;
+                            }
+                            if (iter_count++ < config_.iteration.startAtChunk) {
+                                continue;
+                            }
+
+                            CODES_CHECK(codes_set_long(handle, "paramId", iparam), 0);
+
+                            size_t messageSize = 0;
+                            const void* buffer = nullptr;
+                            CODES_CHECK(codes_get_message(handle, &buffer, &messageSize), 0);
+
+                            fdb.archive(buffer, messageSize);
+                            writeCount++;
+                            bytesWritten += messageSize;
+                        }
+                    }
+                }
+                fdb.flush();
+            }
+        }
+        catch (...) {
+            errors[ithread] = std::current_exception();
+        }
+
+        codes_handle_delete(handle);
+    };
+
+    eckit::Timer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+    threads.reserve(nthreads);
+    for (long ithread = 0; ithread < nthreads; ++ithread) {
+        threads.emplace_back(worker, ithread);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    timer.stop();
+
+    codes_handle_delete(templateHandle);
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    Log::info() << "Writer threads: " << nthreads << (config_.execution.concurrentArchive ? "" : " (serialised)")
+                << std::endl;
+    Log::info() << "Fields written: " << writeCount << std::endl;
+    Log::info() << "Bytes written: " << bytesWritten << std::endl;
+    Log::info() << "Total duration: " << timer.elapsed() << std::endl;
+    Log::info() << "Total rate: " << double(writeCount) / timer.elapsed() << " fields / s" << std::endl;
+    Log::info() << "Total rate: " << double(bytesWritten) / (timer.elapsed() * 1_MiB) << " MB / s" << std::endl;
+    Log::info() << "Rate per thread: " << double(bytesWritten) / (timer.elapsed() * 1_MiB * nthreads) << " MB / s"
+                << std::endl;
+}
+
 std::pair<std::unique_ptr<DataHandle>, std::deque<Key>> FDBHammer::constructReadData(std::optional<FDB>& fdb,
                                                                                      FDBHammer::ReadStats& stats) {
 
@@ -10,6 +10,7 @@
 
 #include <cstddef>
 #include <memory>
+#include <set>
 #include <utility>
 
 #include "eckit/exception/Exceptions.h"
@@ -50,6 +51,9 @@ void TypesRegistry::decode(eckit::Stream& stream) {
 
         types_[keyword] = type;
     }
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    reset();
 }
 
 void TypesRegistry::encode(eckit::Stream& out) const {
@@ -76,28 +80,82 @@ bool TypesRegistry::operator==(const TypesRegistry& other) const {
 }
 
 void TypesRegistry::updateParent(const TypesRegistry& parent) {
-    parent_ = &parent;
+    {
+        // The types looked up through the previous parent no longer apply
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        parent_ = &parent;
+        reset();
+    }
+    // The rules are given their parents from the top down, so the parents of @p parent are known by now
+    resolveTypes();
 }
 
 void TypesRegistry::addType(const std::string& keyword, const std::string& type) {
     ASSERT(types_.find(keyword) == types_.end());
+    std::lock_guard<std::mutex> lock(cacheMutex_);
     types_[keyword] = type;
+    reset();
 }
 
 const Type& TypesRegistry::lookupType(const std::string& keyword) const {
+
+    if (const auto* table = table_.load(std::memory_order_acquire)) {
+        if (const Type* type = table->find(keyword)) {
+            return *type;
+        }
+    }
+
     std::lock_guard<std::mutex> lock(cacheMutex_);
 
-    if (auto iter = cache_.find(keyword); iter != cache_.end()) {
+    // Another thread may have looked it up in the meantime
+    if (const auto* table = table_.load(std::memory_order_relaxed)) {
+        if (const Type* type = table->find(keyword)) {
+            return *type;
+        }
+    }
+    if (auto iter = overflow_.find(keyword); iter != overflow_.end()) {
         return *iter->second;
     }
 
+    const Type* type = resolve(keyword);
+    remember(keyword, type);
+
+    return *type;
+}
+
+void TypesRegistry::resolveTypes() const {
+
+    std::set<std::string> keywords;
+    for (const TypesRegistry* registry = this; registry != nullptr; registry = registry->parent_) {
+        for (const auto& [keyword, type] : registry->types_) {
+            keywords.insert(keyword);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+
+    const auto* table = table_.load(std::memory_order_relaxed);
+    for (const auto& keyword : keywords) {
+        if ((!table || !table->find(keyword)) && overflow_.find(keyword) == overflow_.end()) {
+            remember(keyword, resolve(keyword));
+            table = table_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+const Type* TypesRegistry::resolve(const std::string& keyword) const {
+
+    if (auto iter = cache_.find(keyword); iter != cache_.end()) {
+        return iter->second.get();
+    }
+
     std::string type = "Default";
 
     if (auto iter = types_.find(keyword); iter != types_.end()) {
         type = iter->second;
     }
     else if (parent_) {
-        return parent_->lookupType(keyword);
+        return &parent_->lookupType(keyword);
     }
 
     auto* newType = TypesFactory::build(type, keyword);
@@ -106,7 +164,62 @@ const Type& TypesRegistry::lookupType(const std::string& keyword) const {
         LOG_DEBUG_LIB(LibFdb5) << "Failed to insert new type into cache" << std::endl;
     }
 
-    return *newType;
+    return newType;
+}
+
+void TypesRegistry::remember(const std::string& keyword, const Type* type) const {
+
+    auto* table = table_.load(std::memory_order_relaxed);
+    if (!table) {
+        tables_.push_back(std::make_unique<TypeTable>());
+        table = tables_.back().get();
+        table_.store(table, std::memory_order_release);
+    }
+
+    if (!table->insert(keyword, type)) {
+        overflow_.emplace(keyword, type);
+    }
+}
+
+void TypesRegistry::reset() const {
+    // An empty table can be kept, which spares one for each type added while the schema is loaded
+    if (const auto* table = table_.load(std::memory_order_relaxed); table && table->size > 0) {
+        table_.store(nullptr, std::memory_order_release);
+    }
+    overflow_.clear();
+}
+
+const Type* TypesRegistry::TypeTable::find(const std::string& keyword) const {
+    const size_t start = std::hash<std::string>{}(keyword) % capacity;
+    for (size_t i = 0; i < capacity; ++i) {
+        const Slot& slot = slots[(start + i) % capacity];
+        const Type* type = slot.type.load(std::memory_order_acquire);
+        if (!type) {
+            return nullptr;
+        }
+        if (slot.keyword == keyword) {
+            return type;
+        }
+    }
+    return nullptr;
+}
+
+bool TypesRegistry::TypeTable::insert(const std::string& keyword, const Type* type) {
+    // Up to three quarters full, so that misses stop at an empty slot early
+    if (4 * (size + 1) > 3 * capacity) {
+        return false;
+    }
+    const size_t start = std::hash<std::string>{}(keyword) % capacity;
+    for (size_t i = 0; i < capacity; ++i) {
+        Slot& slot = slots[(start + i) % capacity];
+        if (!slot.type.load(std::memory_order_relaxed)) {
+            slot.keyword = keyword;
+            slot.type.store(type, std::memory_order_release);
+            ++size;
+            return true;
+        }
+    }
+    return false;
 }
 
 metkit::mars::MarsRequest TypesRegistry::canonicalise(const metkit::mars::MarsRequest& request) const {
@@ -16,11 +16,15 @@
 #ifndef fdb5_TypesRegistry_H
 #define fdb5_TypesRegistry_H
 
+#include <array>
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "eckit/serialisation/Streamable.h"
 
@@ -45,8 +49,13 @@ public:  // methods
     void decode(eckit::Stream& stream);
     void encode(eckit::Stream& out) const override;
 
+    /// Lock-free once the keyword has been looked up (or resolved by resolveTypes)
     const Type& lookupType(const std::string& keyword) const;
 
+    /// Looks up the types of all the keywords known to this registry and its parents, so that the lookups of the
+    /// keywords of a schema never take the slow path
+    void resolveTypes() const;
+
     void addType(const std::string&, const std::string&);
     void updateParent(const TypesRegistry& parent);
     void dump(std::ostream& out) const;
@@ -68,6 +77,34 @@ private:  // methods
 
     void print(std::ostream& out) const;
 
+    /// The types looked up so far, by keyword. Entries are only added, in place, so readers need no lock: a slot is
+    /// empty until its type is set, after its keyword. The table has a fixed capacity, and is never copied.
+    struct TypeTable {
+        static constexpr size_t capacity = 128;
+
+        struct Slot {
+            std::string keyword;
+            std::atomic<const Type*> type{nullptr};
+        };
+
+        std::array<Slot, capacity> slots;
+        size_t size = 0;
+
+        const Type* find(const std::string& keyword) const;
+
+        /// Caller must hold cacheMutex_. Returns false once the table is full enough to slow down the searches.
+        bool insert(const std::string& keyword, const Type* type);
+    };
+
+    /// Caller must hold cacheMutex_
+    const Type* resolve(const std::string& keyword) const;
+
+    /// Caller must hold cacheMutex_
+    void remember(const std::string& keyword, const Type* type) const;
+
+    /// Forgets the types looked up so far, as the types of the registry changed. Caller must hold cacheMutex_
+    void reset() const;
+
     friend std::ostream& operator<<(std::ostream& s, const TypesRegistry& x);
 
 private:  // members
@@ -78,7 +115,15 @@ private:  // members
 
     using TypeMap = std::map<std::string, std::unique_ptr<const Type>>;
     mutable std::mutex cacheMutex_;
-    mutable TypeMap cache_;
+    mutable TypeMap cache_;  ///< the types built by this registry
+
+    /// The types looked up so far, read without locking. The table is only replaced when the types of the registry
+    /// change (addType, decode, updateParent), which happens while the schema is loaded, so lookups never add one.
+    /// The replaced tables are kept (the current one last), as readers may still be using them. The keywords that do
+    /// not fit in the table are looked up under the lock.
+    mutable std::atomic<TypeTable*> table_{nullptr};
+    mutable std::vector<std::unique_ptr<TypeTable>> tables_;
+    mutable std::unordered_map<std::string, const Type*> overflow_;
 
     // streamable
 
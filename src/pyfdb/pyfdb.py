@@ -222,6 +222,46 @@ class FDB:
         internal_mars_selection = UserInputMapper.map_selection_to_internal(mars_selection)
         return DataHandle(self.FDB.retrieve(internal_mars_selection), _internal=True)
 
+    def retrieve_into(
+        self, mars_selection: MarsSelection, buffers: list[Any] | None = None
+    ) -> list[bytes] | list[int]:
+        """
+        Retrieve the fields which are specified by a MARS selection, without copying them through a `DataHandle`.
+
+        Parameters
+        ----------
+        `mars_selection`
+            MARS selection which describes the data which should be retrieved
+        `buffers` : list of writable buffer objects, *optional*
+            If given, the i-th field is read into the start of the i-th buffer, e.g. a `bytearray` or a numpy array.
+            The sizes of the fields can be obtained with `list`.
+
+        Returns
+        -------
+        list[bytes]
+            If no buffers are given, one `bytes` object per field, in the order `retrieve` would return them.
+        list[int]
+            If buffers are given, the size in bytes of each field read.
+
+        Raises
+        ------
+        `ValueError` if more fields match the selection than buffers are given, or a field doesn't fit in its buffer.
+        No data is read in that case.
+
+        Examples
+        --------
+        >>> mars_selection = {"key-1": "value-1", ...}
+        >>> for field in pyfdb.retrieve_into(mars_selection):
+        >>>     assert field[:4] == b"GRIB"
+        """
+        if len(mars_selection) == 0:
+            raise TypeError("FDB.retrieve_into: Wildcard selection aren't support for retrieving.")
+
+        internal_mars_selection = UserInputMapper.map_selection_to_internal(mars_selection)
+        if buffers is None:
+            return self.FDB.retrieve_into(internal_mars_selection)
+        return self.FDB.retrieve_into(internal_mars_selection, buffers)
+
     def list(
         self,
         mars_selection: MarsSelection,
@@ -526,6 +526,41 @@ PYBIND11_MODULE(pyfdb_bindings, m) {
              [](fdb5::FDB& fdb, const std::map<std::string, std::vector<std::string>>& selection) {
                  return fdb.retrieve(mars_requestfrom_map(selection));
              })
+        .def("retrieve_into",
+             [](fdb5::FDB& fdb, const std::map<std::string, std::vector<std::string>>& selection) {
+                 // The data of each field is read directly into a new bytes object
+                 py::list fields;
+                 fdb.retrieveInto(mars_requestfrom_map(selection), [&](const fdb5::ListElement&, size_t length) {
+                     py::bytes field(nullptr, length);
+                     fields.append(field);
+                     return static_cast<void*>(PyBytes_AS_STRING(field.ptr()));
+                 });
+                 return fields;
+             })
+        .def("retrieve_into",
+             [](fdb5::FDB& fdb, const std::map<std::string, std::vector<std::string>>& selection,
+                std::vector<py::buffer>& buffers) {
+                 std::vector<py::buffer_info> infos;
+                 std::vector<size_t> lengths;
+                 fdb.retrieveInto(mars_requestfrom_map(selection), [&](const fdb5::ListElement&, size_t length) {
+                     if (lengths.size() >= buffers.size()) {
+                         std::ostringstream buf;
+                         buf << "retrieve_into: more than " << buffers.size() << " fields match the selection";
+                         throw py::value_error(buf.str());
+                     }
+                     infos.emplace_back(buffers[lengths.size()].request(/* writable */ true));
+                     const py::buffer_info& info = infos.back();
+                     if (static_cast<size_t>(info.size * info.itemsize) < length) {
+                         std::ostringstream buf;
+                         buf << "retrieve_into: field " << lengths.size() << " of " << length
+                             << " bytes does not fit in its buffer";
+                         throw py::value_error(buf.str());
+                     }
+                     lengths.push_back(length);
+                     return info.ptr;
+                 });
+                 return lengths;
+             })
         .def("inspect",
              [](fdb5::FDB& fdb, const std::map<std::string, std::vector<std::string>>& selection) {
                  return fdb.inspect(mars_requestfrom_map(selection));
@@ -10,6 +10,7 @@
 
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 #include "eckit/filesystem/PathName.h"
@@ -240,6 +241,84 @@ CASE("fdb_c - archive & list") {
     fdb_delete_handle(fdb);
 }
 
+CASE("fdb_c - archive batch & list") {
+    const int depth = 3;
+
+    fdb_handle_t* fdb;
+    fdb_new_handle(&fdb);
+
+    const char* levels[] = {"300", "400"};
+    const char* files[] = {"x138-300.grib", "x138-400.grib"};
+
+    fdb_key_t* keys[2];
+    std::vector<eckit::Buffer> buffers;
+    const char* data[2];
+    size_t lengths[2];
+
+    for (size_t i = 0; i < 2; ++i) {
+        fdb_new_key(&keys[i]);
+        fdb_key_add(keys[i], "domain", "g");
+        fdb_key_add(keys[i], "stream", "oper");
+        fdb_key_add(keys[i], "levtype", "pl");
+        fdb_key_add(keys[i], "levelist", levels[i]);
+        fdb_key_add(keys[i], "date", "20191110");
+        fdb_key_add(keys[i], "time", "0000");
+        fdb_key_add(keys[i], "step", "0");
+        fdb_key_add(keys[i], "param", "138");
+        fdb_key_add(keys[i], "class", "rd");
+        fdb_key_add(keys[i], "type", "an");
+        fdb_key_add(keys[i], "expver", "xxxz");
+
+        eckit::PathName grib(files[i]);
+        lengths[i] = grib.size();
+        buffers.emplace_back(lengths[i]);
+        std::unique_ptr<DataHandle> dh(grib.fileHandle());
+        dh->openForRead();
+        dh->read(buffers.back(), lengths[i]);
+        dh->close();
+    }
+    for (size_t i = 0; i < 2; ++i) {
+        data[i] = buffers[i];
+    }
+
+    EXPECT_EQUAL(FDB_SUCCESS, fdb_archive_batch(fdb, keys, data, lengths, 2));
+    EXPECT_EQUAL(FDB_SUCCESS, fdb_flush(fdb));
+
+    fdb_request_t* request;
+    fdb_new_request(&request);
+    fdb_request_add1(request, "domain", "g");
+    fdb_request_add1(request, "stream", "oper");
+    fdb_request_add1(request, "levtype", "pl");
+    fdb_request_add(request, "levelist", levels, 2);
+    fdb_request_add1(request, "date", "20191110");
+    fdb_request_add1(request, "time", "0000");
+    fdb_request_add1(request, "step", "0");
+    fdb_request_add1(request, "param", "138");
+    fdb_request_add1(request, "class", "rd");
+    fdb_request_add1(request, "type", "an");
+    fdb_request_add1(request, "expver", "xxxz");
+
+    fdb_listiterator_t* it;
+    fdb_list(fdb, request, &it, true, depth);
+
+    const char* uri;
+    size_t off, attr_len;
+    size_t count = 0;
+    while (fdb_listiterator_next(it) == FDB_SUCCESS) {
+        fdb_listiterator_attrs(it, &uri, &off, &attr_len);
+        EXPECT_EQUAL(attr_len, 3280398);
+        ++count;
+    }
+    EXPECT_EQUAL(count, 2);
+    fdb_delete_listiterator(it);
+
+    fdb_delete_request(request);
+    for (auto* key : keys) {
+        fdb_delete_key(key);
+    }
+    fdb_delete_handle(fdb);
+}
+
 #if fdb5_HAVE_GRIB
 CASE("fdb_c - multiple archive & list") {
     const int depth = 3;
@@ -582,6 +661,62 @@ CASE("fdb_c - retrieve") {
     fdb_delete_handle(fdb);
 }
 
+CASE("fdb_c - retrieve into") {
+
+    fdb_handle_t* fdb;
+    fdb_new_handle(&fdb);
+    fdb_request_t* request;
+    fdb_new_request(&request);
+    fdb_request_add1(request, "domain", "g");
+    fdb_request_add1(request, "stream", "oper");
+    fdb_request_add1(request, "levtype", "pl");
+    fdb_request_add1(request, "date", "20191110");
+    fdb_request_add1(request, "time", "0000");
+    fdb_request_add1(request, "step", "0");
+    fdb_request_add1(request, "param", "138");
+    fdb_request_add1(request, "class", "rd");
+    fdb_request_add1(request, "type", "an");
+    fdb_request_add1(request, "expver", "xxxx");
+    const char* values[] = {"400", "300"};
+    fdb_request_add(request, "levelist", values, 2);
+
+    // reference data, through the data reader
+    long size;
+    fdb_datareader_t* dr;
+    fdb_new_datareader(&dr);
+    EXPECT_EQUAL(fdb_retrieve(fdb, request, dr), FDB_SUCCESS);
+    fdb_datareader_open(dr, &size);
+    std::vector<char> expected(size);
+    long read = 0;
+    fdb_datareader_read(dr, expected.data(), size, &read);
+    EXPECT_EQUAL(size, read);
+    fdb_delete_datareader(dr);
+
+    std::vector<char> field1(size);
+    std::vector<char> field2(size);
+    void* buffers[] = {field1.data(), field2.data()};
+    size_t capacities[] = {field1.size(), field2.size()};
+    size_t lengths[] = {0, 0};
+    size_t nfields = 0;
+
+    EXPECT_EQUAL(fdb_retrieve_into(fdb, request, buffers, capacities, 2, lengths, &nfields), FDB_SUCCESS);
+    EXPECT(nfields == 2);
+    EXPECT(lengths[0] + lengths[1] == size_t(size));
+    EXPECT_EQUAL(0, strncmp(field1.data(), "GRIB", 4));
+    EXPECT_EQUAL(0, memcmp(field1.data(), expected.data(), lengths[0]));
+    EXPECT_EQUAL(0, memcmp(field2.data(), expected.data() + lengths[0], lengths[1]));
+
+    // not enough buffers
+    EXPECT_NOT_EQUAL(fdb_retrieve_into(fdb, request, buffers, capacities, 1, lengths, &nfields), FDB_SUCCESS);
+
+    // buffer too small
+    capacities[1] = 4;
+    EXPECT_NOT_EQUAL(fdb_retrieve_into(fdb, request, buffers, capacities, 2, lengths, &nfields), FDB_SUCCESS);
+
+    fdb_delete_request(request);
+    fdb_delete_handle(fdb);
+}
+
 CASE("fdb_c - expand") {
 
     fdb_handle_t* fdb;
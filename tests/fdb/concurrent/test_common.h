@@ -90,9 +90,10 @@ inline std::string schema_path() {
 }
 
 /// Build an inline FDB configuration (FDB5_CONFIG) pointing at an isolated @p root directory.
-inline std::string make_config_yaml(const std::string& root) {
-    return std::string("---\n") + "type: local\n" + "engine: toc\n" + "schema: " + schema_path() + "\n" + "spaces:\n" +
-           "- handler: Default\n" + "  roots:\n" + "  - path: " + root + "\n";
+/// @p extra is appended verbatim, to set additional top-level options.
+inline std::string make_config_yaml(const std::string& root, const std::string& extra = "") {
+    return std::string("---\n") + "type: local\n" + "engine: toc\n" + "schema: " + schema_path() + "\n" + extra +
+           "spaces:\n" + "- handler: Default\n" + "  roots:\n" + "  - path: " + root + "\n";
 }
 
 /// The fixed part of the key shared by every archived field (includes "param", omits "step").
@@ -353,8 +354,8 @@ inline int child_worker_main(int argc, char** argv) {
 class TestFixture {
 public:
 
-    explicit TestFixture(int count) :
-        config_{"FDB5_CONFIG", make_config_yaml(root_.asString())},
+    explicit TestFixture(int count, const std::string& extra = "") :
+        config_{"FDB5_CONFIG", make_config_yaml(root_.asString(), extra)},
         workers_{"TEST_FDB_WORKER_COUNT", std::to_string(count)} {}
 
     TestFixture(const TestFixture&) = delete;
@@ -133,6 +133,119 @@ CASE("Multi-thread: archive (shared FDB)") {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+CASE("Multi-thread: concurrent archive (shared FDB, one database per thread)") {
+    const auto count = thread_count();
+
+    TestFixture fixture(count, "concurrentArchive: true\n");
+
+    // Each thread writes its own database (distinct date), so only the shared database cache is contended
+    const auto make_db_key = [](size_t id, int seq) {
+        auto key = make_key(id, seq);
+        key.set("date", std::to_string(20101001 + id));
+        return key;
+    };
+
+    fdb5::FDB shared;
+    expect_workers_ok(run_threads(count, [&shared, &make_db_key](auto id) {
+        for (int seq = 0; seq < k_seq_per_worker; ++seq) {
+            const auto key = make_db_key(id, seq);
+            const auto data = make_data(id, seq);
+            shared.archive(key, static_cast<const void*>(data.data()), data.size());
+        }
+        shared.flush();
+        return 0;
+    }));
+
+    shared.flush();
+
+    fdb5::FDB fdb;
+    for (int worker = 0; worker < count; ++worker) {
+        for (int seq = 0; seq < k_seq_per_worker; ++seq) {
+            EXPECT(retrieve_equals(fdb, make_db_key(worker, seq), make_data(worker, seq)));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Multi-thread: parallel list (one database per worker)") {
+    const auto count = thread_count();
+
+    TestFixture fixture(count, "visitThreads: 4\n");
+
+    const auto make_db_key = [](size_t id, int seq) {
+        auto key = make_key(id, seq);
+        key.set("date", std::to_string(20101001 + id));
+        return key;
+    };
+
+    {
+        fdb5::FDB fdb;
+        for (int worker = 0; worker < count; ++worker) {
+            for (int seq = 0; seq < k_seq_per_worker; ++seq) {
+                const auto key = make_db_key(worker, seq);
+                const auto data = make_data(worker, seq);
+                fdb.archive(key, static_cast<const void*>(data.data()), data.size());
+            }
+        }
+        fdb.flush();
+    }
+
+    auto request = make_base_key();
+    request.unset("date");
+
+    fdb5::FDB fdb;
+    fdb5::FDBToolRequest tool_request(request.request("list"));
+    auto iter = fdb.list(tool_request, fdb5::ListMode::Full);
+
+    // the databases are visited concurrently, but (in ordered mode) each one is listed in a single run
+    std::vector<std::string> runs;
+    size_t listed = 0;
+    fdb5::ListElement elem;
+    while (iter.next(elem)) {
+        const auto date = elem.combinedKey().get("date");
+        if (runs.empty() || runs.back() != date) {
+            runs.push_back(date);
+        }
+        ++listed;
+    }
+
+    EXPECT(listed == static_cast<size_t>(count * k_seq_per_worker));
+    EXPECT(runs.size() == static_cast<size_t>(count));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Multi-thread: pipelined archive (shared FDB)") {
+    const auto count = thread_count();
+
+    // A small queue, so that archive() regularly blocks on the workers
+    TestFixture fixture(count, "pipelinedArchive: true\npipelinedArchiveQueueSize: 4\n");
+
+    fdb5::FDB shared;
+    expect_workers_ok(run_threads(count, [&shared](auto id) {
+        for (int seq = 0; seq < k_seq_per_worker; ++seq) {
+            const auto key = make_key(id, seq);
+            const auto data = make_data(id, seq);
+            shared.archive(key, static_cast<const void*>(data.data()), data.size());
+        }
+        return 0;
+    }));
+
+    // flush is the barrier: everything archived before it must be visible afterwards
+    shared.flush();
+
+    fdb5::FDB fdb;
+    EXPECT(list_steps(fdb) == expected_steps(count));
+    for (int worker = 0; worker < count; ++worker) {
+        for (int seq = 0; seq < k_seq_per_worker; ++seq) {
+            EXPECT(retrieve_equals(fdb, make_key(worker, seq), make_data(worker, seq)));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 CASE("Multi-thread: retrieve") {
     const auto count = thread_count();
 
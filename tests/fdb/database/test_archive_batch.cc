@@ -0,0 +1,176 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/ListElement.h"
+#include "fdb5/database/ArchiveItem.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test runs once with the default staging buffer, which holds each batch whole, and once with a staging
+// buffer smaller than some of the fields, so that batches are written in several pieces
+
+/// A field as read back, with its location
+struct Found {
+    std::string uri;
+    size_t offset;
+    size_t length;
+    std::string data;
+};
+
+/// The fields e of the index c, by e
+std::map<std::string, Found> inspect(fdb5::FDB& fdb, const std::vector<std::string>& e, const std::string& c) {
+    std::map<std::string, Found> found;
+    auto it = fdb.inspect(fieldRequest(e, c));
+    fdb5::ListElement elem;
+    while (it.next(elem)) {
+        const auto& location = elem.location();
+        found[elem.keys()[2].get("e")] = Found{location.uri().path().asString(), size_t(location.offset()),
+                                               size_t(location.length()), readAll(location.dataHandle())};
+    }
+    return found;
+}
+
+/// Data of varying sizes, distinct for each field
+std::string fieldData(const std::string& c, size_t e) {
+    std::string out;
+    const size_t size = 1 + (e * 37) % 200;
+    for (size_t i = 0; i < size; ++i) {
+        out += static_cast<char>('a' + (i + e + c[0]) % 26);
+    }
+    return out;
+}
+
+std::vector<std::string> values(size_t count) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(std::to_string(i));
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("The fields of a batch are read back as they were archived, laid out one after the other") {
+
+    TestRoot root;
+    fdb5::FDB fdb(root.config());
+
+    const size_t count = 40;
+
+    // Interleaved between two indexes
+    std::map<std::string, std::vector<std::string>> data;
+    std::vector<fdb5::ArchiveItem> items;
+    for (size_t e = 0; e < count; ++e) {
+        for (const std::string c : {"3", "5"}) {
+            data[c].push_back(fieldData(c, e));
+        }
+    }
+    for (size_t e = 0; e < count; ++e) {
+        for (const std::string c : {"3", "5"}) {
+            const std::string& field = data[c][e];
+            items.push_back(fdb5::ArchiveItem{fieldKey(std::to_string(e), "1", c), field.data(), field.size()});
+        }
+    }
+
+    fdb.archive(items);
+    fdb.flush();
+
+    for (const std::string c : {"3", "5"}) {
+        const std::map<std::string, Found> found = inspect(fdb, values(count), c);
+        EXPECT_EQUAL(found.size(), count);
+
+        const Found& first = found.at("0");
+        size_t offset = first.offset;
+        for (size_t e = 0; e < count; ++e) {
+            const Found& field = found.at(std::to_string(e));
+            EXPECT(field.data == data[c][e]);
+            EXPECT_EQUAL(field.length, data[c][e].size());
+            EXPECT_EQUAL(field.uri, first.uri);
+            EXPECT_EQUAL(field.offset, offset);
+            offset += field.length;
+        }
+    }
+}
+
+CASE("A key repeated within a batch is found with its last data") {
+
+    TestRoot root;
+    fdb5::FDB fdb(root.config());
+
+    const std::string before = "archived before the batch";
+    archive(fdb, fieldKey("1"), before);
+    fdb.flush();
+
+    const std::vector<std::string> data{"first of 1", "only 2", "second of 1", "only 3", "third of 1"};
+    const std::vector<std::string> e{"1", "2", "1", "3", "1"};
+
+    std::vector<fdb5::ArchiveItem> items;
+    for (size_t i = 0; i < data.size(); ++i) {
+        items.push_back(fdb5::ArchiveItem{fieldKey(e[i]), data[i].data(), data[i].size()});
+    }
+    fdb.archive(items);
+    fdb.flush();
+
+    const std::map<std::string, Found> found = inspect(fdb, {"1", "2", "3"}, "3");
+    EXPECT_EQUAL(found.size(), 3);
+    EXPECT_EQUAL(found.at("1").data, "third of 1");
+    EXPECT_EQUAL(found.at("2").data, "only 2");
+    EXPECT_EQUAL(found.at("3").data, "only 3");
+
+    EXPECT_EQUAL(readAll(fdb.retrieve(fieldRequest({"1"}))), "third of 1");
+}
+
+CASE("A field that cannot be archived rejects the whole batch") {
+
+    TestRoot root;
+    fdb5::FDB fdb(root.config());
+
+    archive(fdb, fieldKey("0"), "archived before the batch");
+    fdb.flush();
+
+    const std::string data = "field of the batch";
+
+    // Without the keyword f, which the schema requires
+    fdb5::Key incomplete{{"a", "1"}, {"b", "2"}, {"c", "3"}, {"d", "4"}, {"e", "2"}};
+
+    std::vector<fdb5::ArchiveItem> items{
+        fdb5::ArchiveItem{fieldKey("1"), data.data(), data.size()},
+        fdb5::ArchiveItem{incomplete, data.data(), data.size()},
+        fdb5::ArchiveItem{fieldKey("3", "1", "5"), data.data(), data.size()},
+    };
+    EXPECT_THROWS(fdb.archive(items));
+    fdb.flush();
+
+    const std::map<std::string, Found> found = inspect(fdb, values(4), "3");
+    EXPECT_EQUAL(found.size(), 1);
+    EXPECT_EQUAL(found.at("0").data, "archived before the batch");
+    EXPECT(inspect(fdb, values(4), "5").empty());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,139 @@
+#include <string>
+#include <vector>
+
+#include "fdb5/database/BloomFilter.h"
+#include "fdb5/database/Key.h"
+
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+#include "eckit/testing/Test.h"
+
+namespace {
+
+fdb5::Key datumKey(int step, int param) {
+    return fdb5::Key{{{"step", std::to_string(step)}, {"param", std::to_string(param)}, {"levelist", "1"}}};
+}
+
+std::vector<uint64_t> hashes(int nsteps, int nparams) {
+    std::vector<uint64_t> h;
+    for (int step = 0; step < nsteps; ++step) {
+        for (int param = 0; param < nparams; ++param) {
+            h.push_back(fdb5::BloomFilter::hash(datumKey(step, param)));
+        }
+    }
+    return h;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Empty filter may contain anything") {
+
+    fdb5::BloomFilter filter;
+    EXPECT(filter.empty());
+    EXPECT(filter.mayContain(datumKey(1, 2)));
+
+    fdb5::BloomFilter none({}, 10);
+    EXPECT(none.empty());
+    EXPECT(none.mayContain(datumKey(1, 2)));
+}
+
+CASE("Hash depends on keywords and values") {
+
+    EXPECT_EQUAL(fdb5::BloomFilter::hash(datumKey(1, 2)), fdb5::BloomFilter::hash(datumKey(1, 2)));
+    EXPECT_NOT_EQUAL(fdb5::BloomFilter::hash(datumKey(1, 2)), fdb5::BloomFilter::hash(datumKey(2, 1)));
+
+    fdb5::Key k1{{{"a", "bc"}}};
+    fdb5::Key k2{{{"ab", "c"}}};
+    EXPECT_NOT_EQUAL(fdb5::BloomFilter::hash(k1), fdb5::BloomFilter::hash(k2));
+}
+
+CASE("No false negatives, and few false positives") {
+
+    fdb5::BloomFilter filter(hashes(100, 50), 10);
+    EXPECT(!filter.empty());
+    EXPECT(filter.bits() >= 100 * 50 * 10);
+
+    for (int step = 0; step < 100; ++step) {
+        for (int param = 0; param < 50; ++param) {
+            EXPECT(filter.mayContain(datumKey(step, param)));
+        }
+    }
+
+    // Keys along the same axes, but not stored
+    size_t positives = 0;
+    size_t trials = 0;
+    for (int step = 100; step < 200; ++step) {
+        for (int param = 0; param < 100; ++param) {
+            positives += filter.mayContain(datumKey(step, param));
+            ++trials;
+        }
+    }
+
+    // About 1% is expected with 10 bits per key
+    EXPECT(positives < trials / 20);
+}
+
+CASE("Encode and decode") {
+
+    fdb5::BloomFilter filter(hashes(20, 20), 8);
+
+    eckit::Buffer buffer(filter.encodedSize());
+    eckit::ResizableMemoryStream s(buffer);
+    filter.encode(s);
+    EXPECT(size_t(s.position()) <= filter.encodedSize());
+
+    eckit::MemoryStream in(buffer.data(), s.position());
+    fdb5::BloomFilter decoded(in);
+
+    EXPECT_EQUAL(decoded.bits(), filter.bits());
+    EXPECT_EQUAL(decoded.hashes(), filter.hashes());
+
+    for (int step = 0; step < 40; ++step) {
+        for (int param = 0; param < 40; ++param) {
+            uint64_t h = fdb5::BloomFilter::hash(datumKey(step, param));
+            EXPECT_EQUAL(decoded.mayContain(h), filter.mayContain(h));
+        }
+    }
+}
+
+CASE("Hashes and encoded filters do not depend on the byte order of the host") {
+
+    fdb5::Key key{{{"a", "bc"}}};
+    EXPECT_EQUAL(fdb5::BloomFilter::hash(key), uint64_t(0x158569f7eda7c612ULL));
+
+    // One hash over 64 bits: the hash 8 sets bit 8, i.e. the lowest bit of the second byte
+    fdb5::BloomFilter filter({8}, 1);
+    EXPECT_EQUAL(filter.bits(), 64);
+    EXPECT_EQUAL(filter.hashes(), 1);
+
+    eckit::Buffer buffer(filter.encodedSize());
+    eckit::ResizableMemoryStream s(buffer);
+    filter.encode(s);
+
+    eckit::MemoryStream in(buffer.data(), s.position());
+    unsigned int nhashes;
+    std::string data;
+    in >> nhashes;
+    in >> data;
+    EXPECT_EQUAL(nhashes, 1);
+    EXPECT(data == std::string("\0\1\0\0\0\0\0\0", 8));
+
+    // And a filter decoded from those bytes has the same bit set
+    eckit::Buffer encoded(64);
+    eckit::ResizableMemoryStream out(encoded);
+    out << nhashes;
+    out << std::string("\0\0\1\0\0\0\0\0", 8);
+    eckit::MemoryStream decode(encoded.data(), out.position());
+    fdb5::BloomFilter decoded(decode);
+    EXPECT(decoded.mayContain(uint64_t(16)));
+    EXPECT(!decoded.mayContain(uint64_t(8)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    return ::eckit::testing::run_tests(argc, argv);
+}
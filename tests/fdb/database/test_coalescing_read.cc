@@ -0,0 +1,290 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/ListElement.h"
+#include "fdb5/api/helpers/ListIterator.h"
+#include "fdb5/io/CoalescingReadHandle.h"
+#include "fdb5/io/HandleGatherer.h"
+#include "fdb5/toc/TocFieldLocation.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test also runs with small FDB_READ_COALESCE_GAP, FDB_READ_WINDOW_SIZE and FDB_READ_THREADS, so that the
+// reads are split over several windows and threads, and with FDB_COALESCED_READ set, so that retrieve uses them
+
+using Locations = std::vector<std::shared_ptr<const fdb5::FieldLocation>>;
+
+/// A field of a local file, that presents itself as stored elsewhere, and counts the handles it gives out
+class OtherSchemeLocation : public fdb5::TocFieldLocation {
+public:
+
+    OtherSchemeLocation(const eckit::PathName& path, eckit::Offset offset, eckit::Length length) :
+        TocFieldLocation(eckit::URI("other", path), offset, length, fdb5::Key()) {}
+
+    eckit::DataHandle* dataHandle() const override {
+        ++handles;
+        return TocFieldLocation::dataHandle();
+    }
+
+    static std::atomic<size_t> handles;
+};
+
+std::atomic<size_t> OtherSchemeLocation::handles{0};
+
+/// Writes a file of @p size bytes, none of which repeats within 251 bytes
+eckit::PathName makeFile(const TestRoot& root, const std::string& name, size_t size) {
+    eckit::PathName path = root.root() / name;
+    std::ofstream out(path.localPath(), std::ios::binary);
+    for (size_t i = 0; i < size; ++i) {
+        out.put(static_cast<char>((i * 7 + name.size()) % 251));
+    }
+    return path;
+}
+
+void addField(Locations& locations, const eckit::PathName& path, size_t offset, size_t length) {
+    locations.emplace_back(std::make_shared<fdb5::TocFieldLocation>(path, offset, length, fdb5::Key()));
+}
+
+/// What retrieve returns without coalescing
+std::string gathered(const Locations& locations, bool sorted) {
+    fdb5::HandleGatherer gatherer(sorted);
+    for (const auto& location : locations) {
+        gatherer.add(location->dataHandle());
+    }
+    return readAll(gatherer.dataHandle());
+}
+
+std::unique_ptr<fdb5::CoalescingReadHandle> coalescing(const Locations& locations, bool sorted) {
+    auto handle = std::make_unique<fdb5::CoalescingReadHandle>(sorted);
+    for (const auto& location : locations) {
+        handle->add(*location);
+    }
+    return handle;
+}
+
+/// Reads a handle @p chunk bytes at a time, so that the reads straddle the fields and windows
+std::string readChunks(eckit::DataHandle& handle, size_t chunk) {
+    std::string out;
+    std::vector<char> buffer(chunk);
+    handle.openForRead();
+    eckit::AutoClose closer(handle);
+    long len = 0;
+    while ((len = handle.read(buffer.data(), chunk)) > 0) {
+        out.append(buffer.data(), len);
+    }
+    return out;
+}
+
+/// Checks that the fields read back as they do through their own handles, in every way the handle reads them
+void checkReads(const Locations& locations) {
+
+    const std::string expected = gathered(locations, false);
+
+    EXPECT_EQUAL(readAll(coalescing(locations, false).release()), expected);
+
+    for (size_t chunk : {1, 7, 100}) {
+        auto handle = coalescing(locations, false);
+        EXPECT_EQUAL(readChunks(*handle, chunk), expected);
+        // The handle can be read again
+        EXPECT_EQUAL(readChunks(*handle, chunk), expected);
+    }
+
+    // Each field is read straight into its own memory
+    std::vector<std::string> fields;
+    std::vector<char*> destinations;
+    fields.reserve(locations.size());
+    for (const auto& location : locations) {
+        fields.emplace_back(location->length(), '\0');
+        destinations.push_back(&fields.back()[0]);
+    }
+    auto handle = coalescing(locations, false);
+    handle->readInto(destinations.data());
+    handle->close();
+
+    for (size_t i = 0; i < locations.size(); ++i) {
+        EXPECT_EQUAL(fields[i], readAll(locations[i]->dataHandle()));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Adjacent, gapped and distant fields of a file read back as through their own handles") {
+
+    TestRoot root;
+    const eckit::PathName path = makeFile(root, "data", 300 * 1024);
+
+    Locations locations;
+    addField(locations, path, 1000, 10);
+    addField(locations, path, 0, 10);
+    addField(locations, path, 10, 10);                 // adjacent
+    addField(locations, path, 30, 10);                 // small gap
+    addField(locations, path, 40, 0);                  // empty
+    addField(locations, path, 100, 20);                // larger gap
+    addField(locations, path, 5, 10);                  // overlapping
+    addField(locations, path, 10, 10);                 // repeated
+    addField(locations, path, 200 * 1024, 5000);       // beyond the default gap
+    addField(locations, path, 150 * 1024, 40 * 1024);  // larger than the small window
+
+    SECTION("In the order they are added") {
+        checkReads(locations);
+    }
+
+    SECTION("In the order they are stored") {
+        Locations distinct;
+        addField(distinct, path, 1000, 10);
+        addField(distinct, path, 0, 10);
+        addField(distinct, path, 10, 10);
+        addField(distinct, path, 30, 10);
+        addField(distinct, path, 100, 20);
+        addField(distinct, path, 200 * 1024, 5000);
+        addField(distinct, path, 150 * 1024, 7000);
+        EXPECT_EQUAL(readAll(coalescing(distinct, true).release()), gathered(distinct, true));
+    }
+}
+
+CASE("Fields of several files read back as through their own handles") {
+
+    TestRoot root;
+    std::vector<eckit::PathName> paths;
+    for (const std::string name : {"a", "bb", "ccc"}) {
+        paths.push_back(makeFile(root, name, 64 * 1024));
+    }
+
+    // Fields of varying lengths and gaps, interleaved over the files, in no particular order
+    Locations locations;
+    size_t offsets[3] = {0, 0, 0};
+    for (size_t i = 0; i < 200; ++i) {
+        const size_t file = (i * 5) % 3;
+        const size_t length = 1 + (i * 37) % 61;
+        const size_t gap = (i % 4 == 0) ? (i * 13) % 97 : 0;
+        addField(locations, paths[file], offsets[file] + gap, length);
+        offsets[file] += gap + length;
+    }
+    for (size_t i = 0; i < locations.size(); i += 3) {
+        std::swap(locations[i], locations[locations.size() - 1 - i]);
+    }
+
+    checkReads(locations);
+
+    // Sorted reads return each file in offset order, in the order the files are first seen
+    EXPECT_EQUAL(readAll(coalescing(locations, true).release()), gathered(locations, true));
+}
+
+CASE("Fields stored elsewhere are read through their own handles") {
+
+    TestRoot root;
+    const eckit::PathName path = makeFile(root, "data", 4096);
+
+    Locations locations;
+    addField(locations, path, 0, 100);
+    locations.emplace_back(std::make_shared<OtherSchemeLocation>(path, 100, 50));
+    addField(locations, path, 150, 100);
+    locations.emplace_back(std::make_shared<OtherSchemeLocation>(path, 2000, 10));
+    locations.emplace_back(std::make_shared<OtherSchemeLocation>(path, 0, 0));
+
+    OtherSchemeLocation::handles = 0;
+    auto handle = coalescing(locations, false);
+    EXPECT_EQUAL(OtherSchemeLocation::handles.load(), size_t(3));
+
+    EXPECT_EQUAL(readAll(handle.release()), gathered(locations, false));
+
+    checkReads(locations);
+}
+
+/// What retrieve returns for @p request without coalescing
+std::string gathered(fdb5::FDB& fdb, const metkit::mars::MarsRequest& request, bool sorted) {
+    fdb5::HandleGatherer gatherer(sorted);
+    auto it = fdb.inspect(request);
+    fdb5::ListElement elem;
+    while (it.next(elem)) {
+        gatherer.add(elem.location().dataHandle());
+    }
+    return readAll(gatherer.dataHandle());
+}
+
+/// The fields read by retrieveInto, one after the other
+std::string retrievedInto(fdb5::FDB& fdb, const metkit::mars::MarsRequest& request, size_t count) {
+    std::vector<std::string> fields;
+    fields.reserve(count);
+    const size_t n = fdb.retrieveInto(request, [&fields](const fdb5::ListElement&, size_t length) -> void* {
+        fields.emplace_back(length, '\0');
+        return &fields.back()[0];
+    });
+    EXPECT_EQUAL(n, count);
+
+    std::string out;
+    for (const auto& field : fields) {
+        out += field;
+    }
+    return out;
+}
+
+CASE("Retrieve returns the fields that retrieveInto reads, as without coalescing") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    std::vector<std::string> e;
+    {
+        fdb5::FDB fdb(config);
+        for (size_t i = 0; i < 20; ++i) {
+            e.push_back(std::to_string(i));
+            archive(fdb, fieldKey(e.back()), std::string(1 + i * 11, static_cast<char>('a' + i)));
+            // Fields of another index separate those of this one in the data file
+            archive(fdb, fieldKey(e.back(), "1", "5"), "other index");
+        }
+        fdb.flush();
+    }
+
+    fdb5::FDB fdb(config);
+
+    // Requested in the reverse of the order they are stored
+    const std::vector<std::string> reversed(e.rbegin(), e.rend());
+    metkit::mars::MarsRequest request = fieldRequest(reversed);
+
+    SECTION("In the order they are requested") {
+        const std::string expected = gathered(fdb, request, false);
+        EXPECT_EQUAL(readAll(fdb.retrieve(request)), expected);
+        EXPECT_EQUAL(retrievedInto(fdb, request, e.size()), expected);
+    }
+
+    SECTION("In the order they are stored") {
+        request.values("optimise", {"on"});
+        const std::string expected = gathered(fdb, request, true);
+        EXPECT(expected != gathered(fdb, request, false));
+        EXPECT_EQUAL(readAll(fdb.retrieve(request)), expected);
+        EXPECT_EQUAL(retrievedInto(fdb, request, e.size()), expected);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,150 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   test_common.h
+/// @date   Oct 2026
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/YAMLConfiguration.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/testing/Filesystem.h"
+
+#include "metkit/mars/MarsRequest.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/config/Config.h"
+#include "fdb5/database/Key.h"
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// The databases of these tests are made of fields a=1,b=2,c,d=4,e,f, with one database per a,b and one index per c,d
+
+const std::string testSchema = "[ a, b [ c, d [ e, f ]]]\n";
+
+inline fdb5::Key dbKey() {
+    return fdb5::Key{{"a", "1"}, {"b", "2"}};
+}
+
+inline fdb5::Key indexKey(const std::string& c = "3") {
+    return fdb5::Key{{"c", c}, {"d", "4"}};
+}
+
+inline fdb5::Key datumKey(const std::string& e, const std::string& f = "1") {
+    return fdb5::Key{{"e", e}, {"f", f}};
+}
+
+inline fdb5::Key fieldKey(const std::string& e, const std::string& f = "1", const std::string& c = "3") {
+    return fdb5::Key{{"a", "1"}, {"b", "2"}, {"c", c}, {"d", "4"}, {"e", e}, {"f", f}};
+}
+
+inline metkit::mars::MarsRequest fieldRequest(const std::vector<std::string>& e, const std::string& c = "3") {
+    metkit::mars::MarsRequest request("retrieve");
+    request.values("a", {"1"});
+    request.values("b", {"2"});
+    request.values("c", {c});
+    request.values("d", {"4"});
+    request.values("e", e);
+    request.values("f", {"1"});
+    return request;
+}
+
+/// Reads the whole of a data handle, which it takes ownership of
+inline std::string readAll(eckit::DataHandle* handle) {
+    std::unique_ptr<eckit::DataHandle> dh(handle);
+    std::string out;
+    char buffer[4096];
+    dh->openForRead();
+    eckit::AutoClose closer(*dh);
+    long len = 0;
+    while ((len = dh->read(buffer, sizeof(buffer))) > 0) {
+        out.append(buffer, len);
+    }
+    return out;
+}
+
+/// A local FDB, with a TOC catalogue and store, in a new directory that is removed with it
+class TestRoot {
+public:
+
+    /// @param extra  YAML appended to the configuration
+    explicit TestRoot(const std::string& extra = "") :
+        dir_(eckit::PathName::unique(eckit::PathName(eckit::LocalPathName::cwd()) / "fdb_test")) {
+
+        dir_.mkdir();
+        root().mkdir();
+
+        {
+            std::ofstream out(schemaPath().localPath());
+            out << testSchema;
+        }
+
+        std::ostringstream yaml;
+        yaml << "---\n"
+             << "type: local\n"
+             << "engine: toc\n"
+             << "schema: " << schemaPath() << "\n"
+             << "spaces:\n"
+             << "- handler: Default\n"
+             << "  roots:\n"
+             << "  - path: " << root() << "\n"
+             << extra;
+        yaml_ = yaml.str();
+    }
+
+    TestRoot(const TestRoot&) = delete;
+    TestRoot& operator=(const TestRoot&) = delete;
+
+    ~TestRoot() {
+        if (dir_.exists()) {
+            eckit::testing::deldir(dir_);
+        }
+    }
+
+    fdb5::Config config() const { return fdb5::Config{eckit::YAMLConfiguration(yaml_)}; }
+
+    eckit::PathName root() const { return dir_ / "root"; }
+
+    /// The directory of the only database in the root
+    eckit::PathName database() const {
+        std::vector<eckit::PathName> files;
+        std::vector<eckit::PathName> dirs;
+        root().children(files, dirs);
+        ASSERT(dirs.size() == 1);
+        return dirs.front();
+    }
+
+private:
+
+    eckit::PathName schemaPath() const { return dir_ / "schema"; }
+
+    eckit::PathName dir_;
+    std::string yaml_;
+};
+
+/// Archives @p data under @p key
+inline void archive(fdb5::FDB& fdb, const fdb5::Key& key, const std::string& data) {
+    fdb.archive(key, data.data(), data.size());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
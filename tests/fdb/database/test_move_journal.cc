@@ -0,0 +1,391 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/URI.h"
+#include "eckit/testing/Filesystem.h"
+#include "eckit/testing/Test.h"
+
+#include "metkit/mars/MarsRequest.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/FDBToolRequest.h"
+#include "fdb5/api/helpers/MoveIterator.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Another root of the FDB, that the database is moved to
+class DestinationRoot {
+public:
+
+    DestinationRoot() :
+        dir_(eckit::PathName::unique(eckit::PathName(eckit::LocalPathName::cwd()) / "fdb_test_move")) {
+        dir_.mkdir();
+    }
+
+    DestinationRoot(const DestinationRoot&) = delete;
+    DestinationRoot& operator=(const DestinationRoot&) = delete;
+
+    ~DestinationRoot() {
+        if (dir_.exists()) {
+            eckit::testing::deldir(dir_);
+        }
+    }
+
+    const eckit::PathName& path() const { return dir_; }
+
+    /// The directory the database is moved to
+    eckit::PathName database() const { return dir_ / dbKey().valuesToString(); }
+
+    /// The configuration of this root, to be given to the TestRoot of the database
+    std::string yaml() const { return "  - path: " + dir_.asString() + "\n"; }
+
+private:
+
+    eckit::PathName dir_;
+};
+
+const std::string journalName = ".fdb-move.journal";
+
+std::string contents(const eckit::PathName& path) {
+    std::ifstream in(path.localPath(), std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+void overwrite(const eckit::PathName& path, const std::string& data) {
+    std::ofstream out(path.localPath(), std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+/// The files of a directory, with their contents
+std::map<std::string, std::string> files(const eckit::PathName& dir) {
+    std::map<std::string, std::string> out;
+    std::vector<eckit::PathName> children;
+    std::vector<eckit::PathName> dirs;
+    dir.children(children, dirs);
+    for (const auto& child : children) {
+        out[child.baseName().asString()] = contents(child);
+    }
+    return out;
+}
+
+/// The files recorded in the journal of @p directory, in order, leaving out any partial entry
+std::vector<std::string> recorded(const eckit::PathName& directory) {
+    std::vector<std::string> names;
+    std::istringstream in(contents(directory / journalName));
+    std::string line;
+    while (std::getline(in, line)) {
+        if (std::count(line.begin(), line.end(), '\t') == 2) {
+            names.push_back(line.substr(0, line.find('\t')));
+        }
+    }
+    return names;
+}
+
+/// Whether copies are checked against the checksums of their sources (see FDB_MOVE_VERIFY)
+bool verified() {
+    return eckit::Resource<bool>("fdbMoveVerify;$FDB_MOVE_VERIFY", true);
+}
+
+/// A database of several indexes and data files
+void archiveFields(const fdb5::Config& config) {
+    fdb5::FDB fdb(config);
+    for (const std::string c : {"3", "5", "7"}) {
+        for (size_t e = 0; e < 10; ++e) {
+            archive(fdb, fieldKey(std::to_string(e), "1", c), std::string(100 + e, c[0]));
+        }
+        fdb.flush();
+    }
+}
+
+/// The copies of a move, as fdb-move executes them: the toc last, and none of those queued after it
+std::vector<fdb5::FileCopy> moveCopies(const fdb5::Config& config, const DestinationRoot& dest) {
+
+    metkit::mars::MarsRequest request("retrieve");
+    request.values("a", {"1"});
+    request.values("b", {"2"});
+
+    fdb5::FDB fdb(config);
+    auto it = fdb.move(fdb5::FDBToolRequest(request), eckit::URI(dest.path().asString()));
+
+    std::vector<fdb5::FileCopy> copies;
+    bool synced = false;
+    fdb5::FileCopy elem;
+    while (it.next(elem)) {
+        if (!synced) {
+            copies.push_back(elem);
+            synced = elem.sync();
+        }
+    }
+    EXPECT(synced);
+    return copies;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("A move that is interrupted is resumed without copying the files again") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    const eckit::PathName source = root.root() / dbKey().valuesToString();
+
+    // Interrupted after the first copies
+    std::vector<fdb5::FileCopy> copies = moveCopies(config, dest);
+    EXPECT(copies.size() > 4);
+    for (size_t i = 0; i < 3; ++i) {
+        copies[i].execute();
+    }
+    EXPECT(fdb5::MoveJournal::exists(dest.database()));
+    EXPECT(!(dest.database() / "toc").exists());
+
+    const std::vector<std::string> first = recorded(dest.database());
+    EXPECT_EQUAL(first.size(), size_t(3));
+
+    // A target that holds a journal is accepted, and the move resumed
+    copies = moveCopies(config, dest);
+    for (auto& copy : copies) {
+        if (!copy.sync()) {
+            copy.execute();
+        }
+    }
+
+    // Only the files that were not copied yet are copied, and recorded, by the resumed move
+    const std::vector<std::string> entries = recorded(dest.database());
+    EXPECT_EQUAL(entries.size(), copies.size() - 1);
+    EXPECT(std::equal(first.begin(), first.end(), entries.begin()));
+    std::set<std::string> names(entries.begin(), entries.end());
+    EXPECT_EQUAL(names.size(), entries.size());
+
+    // The journal is removed once the toc is in place
+    copies.back().execute();
+    EXPECT(!fdb5::MoveJournal::exists(dest.database()));
+    EXPECT((dest.database() / "toc").exists());
+
+    const std::map<std::string, std::string> original = files(source);
+    const std::map<std::string, std::string> moved = files(dest.database());
+    for (const auto& [name, data] : moved) {
+        EXPECT(data == original.at(name));
+    }
+    EXPECT_EQUAL(moved.size(), copies.size());
+}
+
+CASE("A copy altered since it was recorded is copied again, unless copies are not verified") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    const eckit::PathName source = root.root() / dbKey().valuesToString();
+
+    std::vector<fdb5::FileCopy> copies = moveCopies(config, dest);
+    copies.front().execute();
+
+    const std::vector<std::string> first = recorded(dest.database());
+    EXPECT_EQUAL(first.size(), size_t(1));
+    const std::string name = first.front();
+
+    // Corrupted, keeping its size
+    const std::string altered(contents(source / name).size(), '#');
+    overwrite(dest.database() / name, altered);
+
+    copies = moveCopies(config, dest);
+    for (auto& copy : copies) {
+        copy.execute();
+    }
+
+    if (verified()) {
+        EXPECT(contents(dest.database() / name) == contents(source / name));
+    }
+    else {
+        EXPECT(contents(dest.database() / name) == altered);
+    }
+}
+
+CASE("A file whose size has changed since it was copied is copied again") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    const eckit::PathName source = root.root() / dbKey().valuesToString();
+
+    std::vector<fdb5::FileCopy> copies = moveCopies(config, dest);
+    copies.front().execute();
+
+    std::map<std::string, std::string> copied = files(dest.database());
+    copied.erase(journalName);
+    EXPECT_EQUAL(copied.size(), size_t(1));
+    const std::string name = copied.begin()->first;
+
+    // The source is longer than the copy recorded in the journal
+    overwrite(source / name, copied.begin()->second + "more");
+
+    copies = moveCopies(config, dest);
+    for (auto& copy : copies) {
+        copy.execute();
+    }
+    EXPECT(contents(dest.database() / name) == copied.begin()->second + "more");
+}
+
+CASE("The partial last entry of a journal is ignored") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    const eckit::PathName source = root.root() / dbKey().valuesToString();
+
+    std::vector<fdb5::FileCopy> copies = moveCopies(config, dest);
+    copies[0].execute();
+    copies[1].execute();
+
+    std::map<std::string, std::string> copied = files(dest.database());
+    copied.erase(journalName);
+    EXPECT_EQUAL(copied.size(), size_t(2));
+
+    // The second entry was being recorded when the move was interrupted: only its name and size made it
+    const eckit::PathName journal = dest.database() / journalName;
+    std::vector<std::string> lines;
+    {
+        std::istringstream in(contents(journal));
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+    }
+    EXPECT_EQUAL(lines.size(), size_t(2));
+    const std::string partial = lines[1].substr(0, lines[1].rfind('\t'));
+    const std::string name = partial.substr(0, partial.find('\t'));
+    overwrite(journal, lines[0] + "\n" + partial);
+
+    copies = moveCopies(config, dest);
+
+    // The partial entry is terminated, so that it is not merged with the entries of the resumed move
+    const std::string resumed = contents(journal);
+    EXPECT(resumed == lines[0] + "\n" + partial + "\n");
+
+    for (auto& copy : copies) {
+        if (!copy.sync()) {
+            copy.execute();
+        }
+    }
+
+    // The file of the partial entry is copied again, and recorded after it, but not the file of the complete entry
+    const std::vector<std::string> entries = recorded(dest.database());
+    EXPECT_EQUAL(entries.size(), copies.size() - 1);
+    EXPECT_EQUAL(entries[0], lines[0].substr(0, lines[0].find('\t')));
+    EXPECT_EQUAL(entries[1], name);
+    EXPECT_EQUAL(std::count(entries.begin(), entries.end(), entries[0]), 1);
+
+    for (const auto& [file, data] : copied) {
+        EXPECT(contents(dest.database() / file) == contents(source / file));
+    }
+}
+
+CASE("A move is refused if the target exists without a journal") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+
+    dest.database().mkdir();
+    EXPECT(!fdb5::MoveJournal::exists(dest.database()));
+
+    EXPECT_THROWS_AS(moveCopies(config, dest), eckit::UserError);
+
+    // Nor once a move has completed, and its journal been removed
+    eckit::testing::deldir(dest.database());
+    for (auto& copy : moveCopies(config, dest)) {
+        copy.execute();
+    }
+    EXPECT(!fdb5::MoveJournal::exists(dest.database()));
+
+    EXPECT_THROWS_AS(moveCopies(config, dest), eckit::UserError);
+}
+
+/// Whether another open file could take the lock of @p path now
+bool lockable(const eckit::PathName& path) {
+    int fd = ::open(path.localPath(), O_RDWR);
+    ASSERT(fd >= 0);
+    bool locked = ::flock(fd, LOCK_EX | LOCK_NB) == 0;
+    ::close(fd);
+    return locked;
+}
+
+CASE("The index files stay locked from the start of the move until its source is cleaned up") {
+
+    DestinationRoot dest;
+    TestRoot root(dest.yaml());
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    const eckit::PathName source = root.root() / dbKey().valuesToString();
+
+    std::vector<eckit::PathName> indexes;
+    for (const auto& [name, data] : files(source)) {
+        if (name.find(".index") != std::string::npos) {
+            indexes.push_back(source / name);
+            EXPECT(lockable(source / name));
+        }
+    }
+    EXPECT(!indexes.empty());
+
+    for (auto& copy : moveCopies(config, dest)) {
+        copy.execute();
+    }
+    for (const auto& index : indexes) {
+        EXPECT(!lockable(index));
+    }
+
+    // As the source directory is removed, last
+    fdb5::MoveLocks::release(source);
+    for (const auto& index : indexes) {
+        EXPECT(lockable(index));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
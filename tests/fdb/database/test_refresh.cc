@@ -0,0 +1,166 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/ListElement.h"
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Field.h"
+#include "fdb5/database/Index.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test runs with FDB_REFRESH_OPEN_DATABASES set
+
+/// Archives the fields e=first..last-1 of the index c, in one flush
+void archiveFlush(fdb5::FDB& fdb, const std::string& data, size_t first, size_t last, const std::string& c = "3") {
+    for (size_t i = first; i < last; ++i) {
+        archive(fdb, fieldKey(std::to_string(i), "1", c), data);
+    }
+    fdb.flush();
+}
+
+/// The data of field e of the selected index, or an empty string if it is not found
+std::string retrieve(const fdb5::CatalogueReader& reader, size_t e) {
+    fdb5::Field field;
+    if (!reader.retrieve(datumKey(std::to_string(e)), field)) {
+        return "";
+    }
+    return readAll(field.dataHandle());
+}
+
+std::set<const fdb5::IndexBase*> contents(const fdb5::CatalogueReader& reader) {
+    std::set<const fdb5::IndexBase*> out;
+    for (const auto& index : reader.indexes()) {
+        out.insert(index.content());
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("A refreshed reader finds the fields flushed since it was opened, and keeps the indexes it had") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    fdb5::FDB writer(config);
+    archiveFlush(writer, "flush 0", 0, 5);
+    archiveFlush(writer, "other", 0, 2, "5");
+
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), config);
+    EXPECT(reader->open());
+    EXPECT(reader->selectIndex(indexKey()));
+    EXPECT_EQUAL(retrieve(*reader, 0), "flush 0");
+    EXPECT_EQUAL(retrieve(*reader, 7), "");
+
+    const std::set<const fdb5::IndexBase*> before = contents(*reader);
+    EXPECT_EQUAL(before.size(), size_t(2));
+
+    // Nothing has been added yet
+    EXPECT(!reader->refresh());
+
+    archiveFlush(writer, "flush 1", 3, 10);
+
+    // The reader only sees the indexes it has loaded until it is refreshed
+    EXPECT_EQUAL(retrieve(*reader, 7), "");
+
+    EXPECT(reader->refresh());
+
+    // The index selected before is selected again, with the new index of the same key taking precedence
+    EXPECT_EQUAL(retrieve(*reader, 0), "flush 0");
+    EXPECT_EQUAL(retrieve(*reader, 3), "flush 1");
+    EXPECT_EQUAL(retrieve(*reader, 7), "flush 1");
+
+    const std::set<const fdb5::IndexBase*> after = contents(*reader);
+    EXPECT_EQUAL(after.size(), size_t(3));
+    for (const auto* content : before) {
+        EXPECT(after.find(content) != after.end());
+    }
+
+    EXPECT(!reader->refresh());
+}
+
+CASE("A refreshed reader drops its indexes when the TOC has gone") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    fdb5::FDB writer(config);
+    archiveFlush(writer, "flush 0", 0, 5);
+
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), config);
+    EXPECT(reader->open());
+    EXPECT_EQUAL(reader->indexes().size(), size_t(1));
+
+    (eckit::PathName(reader->uri().path()) / "toc").unlink();
+
+    EXPECT(reader->refresh());
+    EXPECT(reader->indexes().empty());
+    EXPECT(!reader->selectIndex(indexKey()));
+
+    // Nothing more has gone
+    EXPECT(!reader->refresh());
+}
+
+CASE("A database kept open between inspects sees the fields flushed since") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    fdb5::FDB writer(config);
+    archiveFlush(writer, "flush 0", 0, 5);
+
+    std::vector<std::string> e;
+    for (size_t i = 0; i < 10; ++i) {
+        e.push_back(std::to_string(i));
+    }
+
+    fdb5::FDB fdb(config);
+    auto inspect = [&] {
+        std::map<std::string, std::string> result;
+        auto it = fdb.inspect(fieldRequest(e));
+        fdb5::ListElement elem;
+        while (it.next(elem)) {
+            result[elem.keys()[2].get("e")] = readAll(elem.location().dataHandle());
+        }
+        return result;
+    };
+
+    EXPECT_EQUAL(inspect().size(), size_t(5));
+
+    archiveFlush(writer, "flush 1", 3, 10);
+
+    const auto fields = inspect();
+    EXPECT_EQUAL(fields.size(), size_t(10));
+    EXPECT_EQUAL(fields.at("2"), "flush 0");
+    EXPECT_EQUAL(fields.at("3"), "flush 1");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
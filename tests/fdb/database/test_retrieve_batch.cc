@@ -0,0 +1,202 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/ListElement.h"
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Field.h"
+#include "fdb5/database/Inspector.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test runs with FDB_RETRIEVE_INDEX_THREADS set, so that the lookups of an index key probe its indexes in
+// parallel
+
+/// The data of each field e of the index c=3, as last archived
+using Latest = std::map<std::string, std::string>;
+
+/// Archives fields e=0..9 in several flushes, each of which adds an index to the database, and overwrites some of the
+/// fields in each
+Latest archiveOverwritten(fdb5::FDB& fdb) {
+    Latest latest;
+    for (size_t flush = 0; flush < 5; ++flush) {
+        for (size_t e = 0; e < 10; ++e) {
+            if (e % (flush + 1) == 0) {
+                const std::string data = "flush " + std::to_string(flush) + ", field " + std::to_string(e);
+                archive(fdb, fieldKey(std::to_string(e)), data);
+                latest[std::to_string(e)] = data;
+            }
+        }
+        // In another index, which the lookups do not select
+        archive(fdb, fieldKey("0", "1", "5"), "other index");
+        fdb.flush();
+    }
+    return latest;
+}
+
+Latest inspect(fdb5::FDB& fdb, const std::vector<std::string>& e) {
+    Latest result;
+    auto it = fdb.inspect(fieldRequest(e));
+    fdb5::ListElement elem;
+    while (it.next(elem)) {
+        result[elem.keys()[2].get("e")] = readAll(elem.location().dataHandle());
+    }
+    return result;
+}
+
+std::vector<std::string> values(size_t count) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(std::to_string(i));
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Batched lookups find the fields that retrieve finds, in the most recent index") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    Latest latest;
+    {
+        fdb5::FDB fdb(config);
+        latest = archiveOverwritten(fdb);
+    }
+
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), config);
+    EXPECT(reader->open());
+    EXPECT(reader->selectIndex(indexKey()));
+
+    // Several indexes of the database have the selected index key
+    EXPECT(reader->batchRetrieval());
+
+    std::vector<fdb5::Key> keys;
+    for (const auto& e : values(12)) {
+        keys.push_back(datumKey(e));
+    }
+
+    std::vector<fdb5::Field> fields;
+    const std::vector<bool> found = reader->retrieveBatch(keys, fields);
+    EXPECT_EQUAL(found.size(), keys.size());
+    EXPECT_EQUAL(fields.size(), keys.size());
+
+    for (size_t i = 0; i < keys.size() && i < found.size(); ++i) {
+        fdb5::Field field;
+        const bool expected = reader->retrieve(keys[i], field);
+        EXPECT_EQUAL(expected, i < 10);
+        EXPECT_EQUAL(static_cast<bool>(found[i]), expected);
+        if (found[i] && expected) {
+            EXPECT_EQUAL(fields[i].location().uri().asString(), field.location().uri().asString());
+            EXPECT_EQUAL(fields[i].location().offset(), field.location().offset());
+            EXPECT_EQUAL(readAll(fields[i].dataHandle()), latest.at(keys[i].get("e")));
+        }
+    }
+}
+
+CASE("Concurrent inspects find the fields that a single inspect finds") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    Latest latest;
+    {
+        fdb5::FDB fdb(config);
+        latest = archiveOverwritten(fdb);
+    }
+
+    fdb5::FDB fdb(config);
+    const auto e = values(12);
+
+    EXPECT(inspect(fdb, e) == latest);
+
+    std::vector<std::future<Latest>> results;
+    for (size_t i = 0; i < 8; ++i) {
+        results.emplace_back(std::async(std::launch::async, [&fdb, &e] { return inspect(fdb, e); }));
+    }
+    for (auto& result : results) {
+        EXPECT(result.get() == latest);
+    }
+}
+
+CASE("Concurrent callers share one cached catalogue per database") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    const fdb5::Key otherDbKey{{"a", "1"}, {"b", "3"}};
+    {
+        fdb5::FDB fdb(config);
+        archive(fdb, fieldKey("0"), "first database");
+        archive(fdb, fdb5::Key{{"a", "1"}, {"b", "3"}, {"c", "3"}, {"d", "4"}, {"e", "0"}, {"f", "1"}},
+                "second database");
+        fdb.flush();
+    }
+
+    fdb5::InspectorCatalogueCache cache(1);
+
+    std::vector<std::future<std::shared_ptr<fdb5::InspectorCatalogue>>> results;
+    for (size_t i = 0; i < 8; ++i) {
+        results.emplace_back(std::async(std::launch::async, [&cache, &config] {
+            if (auto cached = cache.find(dbKey())) {
+                return cached;
+            }
+            return cache.insert(dbKey(), fdb5::CatalogueReaderFactory::instance().build(dbKey(), config));
+        }));
+    }
+
+    std::shared_ptr<fdb5::InspectorCatalogue> first;
+    for (auto& result : results) {
+        auto cached = result.get();
+        EXPECT(cached);
+        if (!first) {
+            first = cached;
+        }
+        EXPECT(cached == first);
+    }
+    EXPECT(cache.find(dbKey()) == first);
+
+    // The cache holds one catalogue, so caching another evicts the first, which stays usable by its holder
+    auto other = cache.insert(otherDbKey, fdb5::CatalogueReaderFactory::instance().build(otherDbKey, config));
+    EXPECT(other != first);
+    EXPECT(!cache.find(dbKey()));
+    EXPECT(cache.find(otherDbKey) == other);
+
+    std::lock_guard<std::mutex> lock(first->mutex_);
+    EXPECT(first->catalogue_->open());
+    EXPECT(first->catalogue_->selectIndex(indexKey()));
+    fdb5::Field field;
+    EXPECT(first->catalogue_->retrieve(datumKey("0"), field));
+    EXPECT_EQUAL(readAll(field.dataHandle()), "first database");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,105 @@
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "fdb5/database/Key.h"
+#include "fdb5/toc/RootCatalogue.h"
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/Stat.h"
+#include "eckit/testing/Test.h"
+
+namespace {
+
+fdb5::Key dbKey(const std::string& date) {
+    return fdb5::Key{{{"class", "od"}, {"expver", "0001"}, {"date", date}}};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("The catalogue lists the databases added to the root") {
+
+    EXPECT(fdb5::RootCatalogue::enabled());
+
+    eckit::PathName root = eckit::PathName::unique(eckit::PathName("root_catalogue"));
+    root.mkdir();
+
+    eckit::Stat::Struct info;
+    EXPECT(eckit::Stat::stat(root.localPath(), &info) == 0);
+    if (info.st_nlink < 2) {
+        eckit::Log::info() << "The file system does not count subdirectories, skipping" << std::endl;
+        root.rmdir();
+        return;
+    }
+
+    // No catalogue yet
+    EXPECT(!fdb5::RootCatalogue(root).usable());
+
+    (root / "db1").mkdir();
+    fdb5::RootCatalogue::add(root / "db1", dbKey("20260101"));
+    (root / "db2").mkdir();
+    fdb5::RootCatalogue::add(root / "db2", dbKey("20260102"));
+
+    {
+        fdb5::RootCatalogue catalogue(root);
+        EXPECT(catalogue.usable());
+        EXPECT_EQUAL(catalogue.databases().size(), 2);
+        EXPECT(catalogue.databases().at("db1").match(dbKey("20260101")));
+        EXPECT(catalogue.databases().at("db2").match(dbKey("20260102")));
+
+        EXPECT(catalogue.find("DB1") != nullptr);
+        EXPECT_EQUAL(catalogue.find("DB1")->first, "db1");
+        EXPECT(catalogue.find("db4") == nullptr);
+
+        // Parsed once while the file is unchanged
+        EXPECT(&fdb5::RootCatalogue(root).databases() == &catalogue.databases());
+    }
+
+    // Created with the permissions of the root, within the umask
+    EXPECT(eckit::Stat::stat((root / ".fdb-catalogue").localPath(), &info) == 0);
+    const mode_t mask = ::umask(0);
+    ::umask(mask);
+    EXPECT_EQUAL(info.st_mode & 0777, 0666 & ~mask);
+
+    // A database created without the catalogue makes it stale
+    (root / "db3").mkdir();
+    EXPECT(!fdb5::RootCatalogue(root).usable());
+    (root / "db3").rmdir();
+
+    // So does creating one and removing another without it, even though the number of databases is the same. n.b.
+    // file system timestamps may be coarser than the time between the updates.
+    ::usleep(20000);
+    (root / "db3").mkdir();
+    (root / "db2").rmdir();
+    EXPECT(!fdb5::RootCatalogue(root).usable());
+    (root / "db2").mkdir();
+    (root / "db3").rmdir();
+    EXPECT(!fdb5::RootCatalogue(root).usable());
+    fdb5::RootCatalogue::add(root / "db2", dbKey("20260102"));
+    EXPECT(fdb5::RootCatalogue(root).usable());
+
+    // Wiped databases are removed
+    (root / "db1").rmdir();
+    fdb5::RootCatalogue::remove(root / "db1");
+    {
+        fdb5::RootCatalogue catalogue(root);
+        EXPECT(catalogue.usable());
+        EXPECT_EQUAL(catalogue.databases().size(), 1);
+        EXPECT(catalogue.databases().find("db2") != catalogue.databases().end());
+    }
+
+    (root / "db2").rmdir();
+    fdb5::RootCatalogue::remove(root / "db2");
+    (root / ".fdb-catalogue").unlink();
+    root.rmdir();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    return ::eckit::testing::run_tests(argc, argv);
+}
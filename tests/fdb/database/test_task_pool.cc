@@ -0,0 +1,143 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/database/TaskPool.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The largest number of tasks seen running at once
+class Concurrency {
+public:
+
+    void enter() {
+        size_t now = ++running_;
+        size_t seen = max_.load();
+        while (now > seen && !max_.compare_exchange_weak(seen, now)) {
+        }
+    }
+
+    void leave() { --running_; }
+
+    size_t max() const { return max_.load(); }
+
+private:
+
+    std::atomic<size_t> running_{0};
+    std::atomic<size_t> max_{0};
+};
+
+CASE("The tasks of all the callers run on the threads of the pool, and on the callers waiting for them") {
+
+    fdb5::TaskPool pool("test", 3);
+
+    const size_t callers = 4;
+    const size_t tasks = 50;
+
+    Concurrency concurrency;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<size_t> done{0};
+
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < callers; ++c) {
+        clients.emplace_back([&] {
+            fdb5::TaskPool::Group group(pool);
+            for (size_t t = 0; t < tasks; ++t) {
+                group.run([&] {
+                    concurrency.enter();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        threads.insert(std::this_thread::get_id());
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    ++done;
+                    concurrency.leave();
+                });
+            }
+            group.wait();
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    EXPECT_EQUAL(done.load(), callers * tasks);
+    EXPECT(concurrency.max() <= pool.size() + callers);
+    EXPECT(threads.size() <= pool.size() + callers);
+}
+
+CASE("Tasks may add tasks to their group, and wait for groups of their own") {
+
+    fdb5::TaskPool pool("test", 2);
+
+    std::atomic<size_t> done{0};
+
+    fdb5::TaskPool::Group group(pool);
+    for (size_t t = 0; t < 8; ++t) {
+        group.run([&] {
+            // More nested work than there are threads in the pool
+            fdb5::TaskPool::Group nested(pool);
+            for (size_t n = 0; n < 4; ++n) {
+                nested.run([&] { ++done; });
+            }
+            nested.wait();
+            group.run([&] { ++done; });
+        });
+    }
+    group.wait();
+
+    EXPECT_EQUAL(done.load(), 8 * 4 + 8);
+}
+
+CASE("The first error is rethrown once all the tasks of the group are done") {
+
+    fdb5::TaskPool pool("test", 2);
+
+    std::atomic<size_t> done{0};
+
+    fdb5::TaskPool::Group group(pool);
+    for (size_t t = 0; t < 20; ++t) {
+        group.run([&, t] {
+            if (t == 3) {
+                throw eckit::SeriousBug("failing task");
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ++done;
+        });
+    }
+    EXPECT_THROWS_AS(group.wait(), eckit::SeriousBug);
+    EXPECT_EQUAL(done.load(), 19);
+
+    // The error is only reported once
+    group.wait();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
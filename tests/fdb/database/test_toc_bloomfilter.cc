@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Field.h"
+#include "fdb5/database/Index.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test runs with FDB_INDEX_BLOOM_BITS set, so that each index is written with its filter
+
+const size_t stored = 100;
+
+/// Checks that the indexes written to @p config have been read back with their filters
+void checkFilters(const fdb5::Config& config) {
+
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), config);
+    EXPECT(reader->open());
+
+    const std::vector<fdb5::Index> indexes = reader->indexes();
+    EXPECT_EQUAL(indexes.size(), size_t(1));
+
+    for (const auto& index : indexes) {
+        for (size_t e = 0; e < stored; ++e) {
+            EXPECT(index.mayContain(datumKey(std::to_string(e))));
+        }
+
+        // With 10 bits per key, about 1% of the keys that are not stored may get through
+        size_t rejected = 0;
+        for (size_t e = stored; e < 10 * stored; ++e) {
+            if (!index.mayContain(datumKey(std::to_string(e)))) {
+                ++rejected;
+            }
+        }
+        EXPECT(rejected >= 8 * stored);
+    }
+
+    EXPECT(reader->selectIndex(indexKey()));
+    fdb5::Field field;
+    EXPECT(reader->retrieve(datumKey("42"), field));
+    EXPECT_EQUAL(readAll(field.dataHandle()), "field 42");
+    EXPECT(!reader->retrieve(datumKey(std::to_string(stored)), field));
+}
+
+void archiveFields(const fdb5::Config& config) {
+    fdb5::FDB fdb(config);
+    for (size_t e = 0; e < stored; ++e) {
+        archive(fdb, fieldKey(std::to_string(e)), "field " + std::to_string(e));
+    }
+    fdb.flush();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Indexes are read back with the filters they are written with") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+
+    archiveFields(config);
+    checkFilters(config);
+}
+
+CASE("Indexes of sub-TOCs are read back with the filters they are written with") {
+
+    TestRoot root;
+    eckit::LocalConfiguration userConfig;
+    userConfig.set("useSubToc", true);
+    const fdb5::Config config(root.config(), userConfig);
+
+    archiveFields(config);
+    checkFilters(config);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
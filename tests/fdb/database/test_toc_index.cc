@@ -0,0 +1,388 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/TmpDir.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/serialisation/ResizableMemoryStream.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/database/EntryVisitMechanism.h"
+#include "fdb5/database/Field.h"
+#include "fdb5/database/Index.h"
+#include "fdb5/database/Key.h"
+#include "fdb5/rules/Rule.h"
+#include "fdb5/rules/Schema.h"
+#include "fdb5/toc/BTreeIndex.h"
+#include "fdb5/toc/FieldRef.h"
+#include "fdb5/toc/TocFieldLocation.h"
+#include "fdb5/toc/TocIndex.h"
+#include "fdb5/toc/TocSerialisationVersion.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The offset of the field stored for each fingerprint, in key order
+using Entries = std::map<std::string, long long>;
+
+/// Records the entries of an index in the order they are visited
+class RecordingVisitor : public fdb5::EntryVisitor {
+public:
+
+    bool visitIndex(const fdb5::Index& /* index */) override { return true; }
+
+    void visitDatum(const fdb5::Field& field, const std::string& keyFingerprint) override {
+        visited_.emplace_back(keyFingerprint, static_cast<long long>(field.location().offset()));
+    }
+
+    const std::vector<std::pair<std::string, long long>>& visited() const { return visited_; }
+
+private:
+
+    void visitDatum(const fdb5::Field& /* field */, const fdb5::Key& /* datumKey */) override { NOTIMP; }
+
+    std::vector<std::pair<std::string, long long>> visited_;
+};
+
+fdb5::Key datumKey(size_t step, const std::string& param) {
+    return fdb5::Key{{"step", std::to_string(step)}, {"param", param}};
+}
+
+/// The key of the entry of @p key in the index, as its type encodes it
+std::string fingerprint(const fdb5::Index& index, const fdb5::Key& key) {
+    std::string out;
+    if (index.type().rfind("BTreeIndexBinary", 0) == 0) {
+        key.valuesToFingerprint(out);
+    }
+    else {
+        out = key.valuesToString();
+    }
+    return out;
+}
+
+/// Adds the field at @p offset of the data file to the index, and to the entries it is expected to hold
+void put(fdb5::Index& index, Entries& expected, const eckit::PathName& data, const fdb5::Key& key, long long offset) {
+    index.put(key, fdb5::Field(fdb5::TocFieldLocation(data, offset, 10, fdb5::Key()), 0));
+    expected[fingerprint(index, key)] = offset;
+}
+
+/// The index finds each of the @p keys at its expected offset, or not at all, and visits exactly the expected
+/// entries, in key order
+void check(const fdb5::Index& index, const Entries& expected, const std::vector<fdb5::Key>& keys) {
+
+    for (const auto& key : keys) {
+        fdb5::Field field;
+        const bool found = index.get(key, fdb5::Key(), field);
+        const auto it = expected.find(fingerprint(index, key));
+        EXPECT_EQUAL(found, it != expected.end());
+        if (found && it != expected.end()) {
+            EXPECT_EQUAL(static_cast<long long>(field.location().offset()), it->second);
+        }
+    }
+
+    RecordingVisitor visitor;
+    index.entries(visitor);
+    EXPECT(visitor.visited() == std::vector<std::pair<std::string, long long>>(expected.begin(), expected.end()));
+}
+
+/// The index as a reader decodes it from its TOC record
+fdb5::Index readBack(const fdb5::Index& index, const eckit::PathName& directory) {
+    eckit::Buffer buffer;
+    {
+        eckit::ResizableMemoryStream s(buffer);
+        index.encode(s, fdb5::TocSerialisationVersion::latest());
+    }
+
+    const auto* content = dynamic_cast<const fdb5::TocIndex*>(index.content());
+    ASSERT(content);
+
+    eckit::MemoryStream s(buffer);
+    fdb5::Index reader(new fdb5::TocIndex(s, fdb5::TocSerialisationVersion::latest(), directory, content->path(),
+                                          content->offset()));
+    reader.open();
+    return reader;
+}
+
+off_t indexOffset(const fdb5::Index& index) {
+    const auto* content = dynamic_cast<const fdb5::TocIndex*>(index.content());
+    ASSERT(content);
+    return content->offset();
+}
+
+class CountingVisitor : public fdb5::BTreeIndexVisitor {
+public:
+
+    void visit(const std::string& /* key */, const fdb5::FieldRef& /* ref */) override { ++count_; }
+
+    size_t count() const { return count_; }
+
+private:
+
+    size_t count_{0};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test is run both with and without FDB_SORTED_INDEX_WRITE, and checks against the same expectations
+
+CASE("An index reads back what was added to it, before and after it is flushed") {
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName path = tmpdir / "test.index";
+    const eckit::PathName data = tmpdir / "test.data";
+
+    const fdb5::Key indexKey{{"levtype", "sfc"}};
+    fdb5::Index index(new fdb5::TocIndex(indexKey, path, 0, fdb5::TocIndex::WRITE, fdb5::TocIndex::defaultType(2)));
+    index.open();
+
+    Entries expected;
+    std::vector<fdb5::Key> keys;
+    long long offset = 0;
+
+    // Added in an order that is not the key order
+    for (size_t step = 20; step-- > 0;) {
+        for (const char* param : {"167", "130"}) {
+            keys.push_back(datumKey(step, param));
+            put(index, expected, data, keys.back(), offset);
+            offset += 10;
+        }
+    }
+
+    // Written twice before the index is flushed, the last one wins
+    put(index, expected, data, datumKey(5, "130"), offset);
+    offset += 10;
+
+    keys.push_back(datumKey(20, "130"));
+    EXPECT(expected.find(keys.back().valuesToString()) == expected.end());
+
+    check(index, expected, keys);
+
+    index.flush();
+    check(index, expected, keys);
+
+    // Replacing a key that is already in the btree, and adding a new one
+    put(index, expected, data, datumKey(3, "167"), offset);
+    offset += 10;
+    put(index, expected, data, datumKey(20, "130"), offset);
+    offset += 10;
+
+    check(index, expected, keys);
+
+    index.flush();
+    check(index, expected, keys);
+
+    index.close();
+    check(readBack(index, tmpdir), expected, keys);
+}
+
+CASE("Sorted indexes appended to one file read back independently") {
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName path = tmpdir / "test.index";
+    const eckit::PathName data = tmpdir / "test.data";
+
+    // So that the first index does not start at an offset aligned for its entries
+    {
+        std::ofstream out(path.localPath());
+        out << "xyz";
+    }
+
+    const fdb5::Key indexKey{{"levtype", "sfc"}};
+    fdb5::Index index(new fdb5::TocIndex(indexKey, path, 3, fdb5::TocIndex::WRITE, "SortedIndex"));
+    index.open();
+
+    Entries first;
+    std::vector<fdb5::Key> keys;
+    for (size_t step : {12, 0, 6, 18}) {
+        keys.push_back(datumKey(step, "130"));
+        put(index, first, data, keys.back(), 100 * step);
+    }
+    put(index, first, data, datumKey(6, "130"), 1);
+    index.flush();
+    check(index, first, keys);
+
+    const fdb5::Index firstReader = readBack(index, tmpdir);
+
+    // A new index at the end of the file
+    const off_t end = path.size();
+    index.reopen();
+    EXPECT_EQUAL(indexOffset(index), end);
+
+    Entries second;
+    for (size_t step : {3, 9}) {
+        keys.push_back(datumKey(step, "167"));
+        put(index, second, data, keys.back(), 1000 + step);
+    }
+    index.flush();
+    check(index, second, keys);
+
+    index.close();
+
+    check(firstReader, first, keys);
+    check(readBack(index, tmpdir), second, keys);
+}
+
+CASE("A sorted index written in several runs reads back the newest entry of each key") {
+
+    // n.b. the fdb_test_database_toc_index_sorted_runs variant spills a run every few entries
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName path = tmpdir / "test.index";
+    const eckit::PathName data = tmpdir / "test.data";
+
+    const fdb5::Key indexKey{{"levtype", "sfc"}};
+    fdb5::Index index(new fdb5::TocIndex(indexKey, path, 0, fdb5::TocIndex::WRITE, "SortedIndex"));
+    index.open();
+
+    Entries expected;
+    std::vector<fdb5::Key> keys;
+    for (size_t step = 0; step < 40; ++step) {
+        keys.push_back(datumKey((step * 7) % 40, "130"));
+        put(index, expected, data, keys.back(), 10 * step);
+    }
+    // Keys rewritten after their first entries have been spilled, some several times
+    for (size_t step = 0; step < 40; step += 3) {
+        put(index, expected, data, datumKey(step, "130"), 1000 + step);
+    }
+    put(index, expected, data, datumKey(6, "130"), 2000);
+    keys.push_back(datumKey(41, "130"));
+
+    check(index, expected, keys);
+    index.flush();
+    check(index, expected, keys);
+
+    index.close();
+    check(readBack(index, tmpdir), expected, keys);
+
+    // Only the index remains in the directory
+    std::vector<eckit::PathName> files;
+    std::vector<eckit::PathName> directories;
+    tmpdir.children(files, directories);
+    EXPECT_EQUAL(files.size(), 1);
+}
+
+CASE("An empty sorted index reads back empty") {
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName path = tmpdir / "test.index";
+
+    {
+        std::unique_ptr<fdb5::BTreeIndex> writer(fdb5::BTreeIndexFactory::build("SortedIndex", path, false, 0));
+        writer->flush();
+    }
+
+    std::unique_ptr<fdb5::BTreeIndex> reader(fdb5::BTreeIndexFactory::build("SortedIndex", path, true, 0));
+
+    fdb5::FieldRef ref;
+    EXPECT(!reader->get(datumKey(0, "130").valuesToString(), ref));
+
+    CountingVisitor visitor;
+    reader->visit(visitor);
+    EXPECT_EQUAL(visitor.count(), 0);
+}
+
+CASE("A binary index reads back what was added to it, and its fingerprints decode to the keys") {
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName path = tmpdir / "test.index";
+    const eckit::PathName data = tmpdir / "test.data";
+
+    std::istringstream rules("[ class, stream [ levtype [ step, param ]]]\n");
+    fdb5::Schema schema(rules);
+    const fdb5::Key dbKey{{"class", "od"}, {"stream", "oper"}};
+    const fdb5::Key indexKey{{"levtype", "sfc"}};
+    const fdb5::Rule& rule = schema.matchingRule(dbKey, indexKey);
+
+    fdb5::Index index(new fdb5::TocIndex(indexKey, path, 0, fdb5::TocIndex::WRITE, "BTreeIndexBinary"));
+    index.open();
+
+    Entries expected;
+    std::vector<fdb5::Key> keys;
+    long long offset = 0;
+    for (size_t step = 0; step < 12; ++step) {
+        for (const char* param : {"130", "129.128", ""}) {
+            keys.push_back(datumKey(step, param));
+            put(index, expected, data, keys.back(), offset);
+            offset += 10;
+        }
+    }
+    put(index, expected, data, datumKey(6, "130"), offset);
+
+    index.flush();
+    check(index, expected, keys);
+
+    index.close();
+    const fdb5::Index reader = readBack(index, tmpdir);
+    check(reader, expected, keys);
+
+    RecordingVisitor visitor;
+    reader.entries(visitor);
+    EXPECT_EQUAL(visitor.visited().size(), keys.size());
+    for (const auto& [keyFingerprint, location] : visitor.visited()) {
+        const fdb5::Key key = rule.makeKey(keyFingerprint);
+        EXPECT_EQUAL(fingerprint(reader, key), keyFingerprint);
+    }
+
+    std::ostringstream dump;
+    reader.dump(dump, "", false, true);
+    EXPECT(dump.str().find("Fingerprint: 6:129.128,") != std::string::npos);
+}
+
+CASE("A key whose binary fingerprint does not fit the index type is rejected") {
+
+    eckit::TmpDir tmpdir(eckit::LocalPathName::cwd().c_str());
+    const eckit::PathName data = tmpdir / "test.data";
+
+    // 32 bytes with a colon between the values, but 34 as a binary fingerprint
+    const fdb5::Key key{{"step", "0123456789"}, {"param", std::string(21, 'p')}};
+    EXPECT_EQUAL(key.valuesToString().size(), 32);
+
+    const fdb5::Key indexKey{{"levtype", "sfc"}};
+    Entries expected;
+
+    fdb5::Index colon(new fdb5::TocIndex(indexKey, tmpdir / "colon.index", 0, fdb5::TocIndex::WRITE, "BTreeIndex"));
+    colon.open();
+    put(colon, expected, data, key, 0);
+
+    fdb5::Index binary(
+        new fdb5::TocIndex(indexKey, tmpdir / "binary.index", 0, fdb5::TocIndex::WRITE, "BTreeIndexBinary"));
+    binary.open();
+    EXPECT_THROWS_AS(put(binary, expected, data, key, 0), eckit::UserError);
+
+    expected.clear();
+    fdb5::Index wide(
+        new fdb5::TocIndex(indexKey, tmpdir / "wide.index", 0, fdb5::TocIndex::WRITE, "BTreeIndexBinary64"));
+    wide.open();
+    put(wide, expected, data, key, 0);
+    wide.flush();
+    check(wide, expected, {key});
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
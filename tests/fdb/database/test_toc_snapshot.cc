@@ -0,0 +1,425 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/LocalPathName.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/api/FDB.h"
+#include "fdb5/api/helpers/FDBToolRequest.h"
+#include "fdb5/api/helpers/ListElement.h"
+#include "fdb5/api/helpers/WipeIterator.h"
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Index.h"
+#include "fdb5/toc/TocHandler.h"
+#include "fdb5/toc/TocSnapshot.h"
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// n.b. this test runs both with and without FDB_TOC_SNAPSHOT. Without it, the indexes are always read from the TOC,
+// as they were before snapshots, and the results the test expects are those.
+
+bool snapshots() {
+    static bool fdbTocSnapshot = eckit::Resource<bool>("fdbTocSnapshot;$FDB_TOC_SNAPSHOT", false);
+    return fdbTocSnapshot;
+}
+
+eckit::PathName databasePath(const TestRoot& root, const fdb5::Key& key = dbKey()) {
+    return root.root() / key.valuesToString();
+}
+
+eckit::LocalPathName snapshotPath(const eckit::PathName& db, const fdb5::Config& config) {
+    return fdb5::TocHandler(db, config).snapshotPath();
+}
+
+/// Everything loadIndexes returns, one index per line, in the order it returns them
+std::string loadIndexes(const eckit::PathName& db, const fdb5::Config& config) {
+
+    fdb5::TocHandler handler(db, config);
+
+    std::set<std::string> subTocs;
+    std::vector<bool> inSubToc;
+    std::vector<fdb5::Key> remapKeys;
+    const std::vector<fdb5::Index> indexes = handler.loadIndexes(false, &subTocs, &inSubToc, &remapKeys);
+
+    EXPECT_EQUAL(inSubToc.size(), indexes.size());
+    EXPECT_EQUAL(remapKeys.size(), indexes.size());
+
+    std::ostringstream out;
+    for (size_t i = 0; i < indexes.size() && i < inSubToc.size() && i < remapKeys.size(); ++i) {
+        out << indexes[i].key() << " " << indexes[i].location() << (inSubToc[i] ? " sub-TOC " : " ") << remapKeys[i]
+            << std::endl;
+    }
+    for (const auto& subToc : subTocs) {
+        out << "sub-TOC " << subToc << std::endl;
+    }
+
+    // The saved snapshot is only ever of a TOC that has been read, and only when they are enabled
+    EXPECT_EQUAL(snapshotPath(db, config).exists(), snapshots());
+
+    return out.str();
+}
+
+/// What loadIndexes returns when it has to read the TOC and sub-TOCs
+std::string replayToc(const eckit::PathName& db, const fdb5::Config& config) {
+    const eckit::LocalPathName path = snapshotPath(db, config);
+    if (path.exists()) {
+        path.unlink();
+    }
+    return loadIndexes(db, config);
+}
+
+/// The number of indexes, and sub-TOCs, loadIndexes returns
+size_t count(const std::string& loaded) {
+    return std::count(loaded.begin(), loaded.end(), '\n');
+}
+
+/// The data of the fields e=0..9 of the index c, as retrieved
+std::map<std::string, std::string> retrieve(const fdb5::Config& config, const std::string& c = "3",
+                                            const std::string& b = "2") {
+    std::vector<std::string> e;
+    for (size_t i = 0; i < 10; ++i) {
+        e.push_back(std::to_string(i));
+    }
+    metkit::mars::MarsRequest request = fieldRequest(e, c);
+    request.values("b", {b});
+
+    fdb5::FDB fdb(config);
+    std::map<std::string, std::string> result;
+    auto it = fdb.inspect(request);
+    fdb5::ListElement elem;
+    while (it.next(elem)) {
+        result[elem.keys()[2].get("e")] = readAll(elem.location().dataHandle());
+    }
+    return result;
+}
+
+/// Archives the fields e=0..count-1 of the index c, in one flush
+void archiveFlush(fdb5::FDB& fdb, const std::string& data, size_t count = 10, const std::string& c = "3") {
+    for (size_t i = 0; i < count; ++i) {
+        archive(fdb, fieldKey(std::to_string(i), "1", c), data);
+    }
+    fdb.flush();
+}
+
+/// Rewrites the saved snapshot without its last index, after applying @p edit, so that whether loadIndexes uses it
+/// can be told from the indexes it returns
+void tamperSnapshot(const eckit::PathName& db, const fdb5::Config& config,
+                    const std::function<void(fdb5::TocSnapshot&)>& edit) {
+    const eckit::LocalPathName path = snapshotPath(db, config);
+    std::unique_ptr<fdb5::TocSnapshot> snapshot = fdb5::TocSnapshot::load(path);
+    EXPECT(snapshot);
+    EXPECT(!snapshot->entries_.empty());
+    snapshot->entries_.pop_back();
+    edit(*snapshot);
+    snapshot->save(path);
+}
+
+struct stat tocStat(const eckit::PathName& db) {
+    struct stat st;
+    EXPECT(::stat((db / "toc").localPath(), &st) == 0);
+    return st;
+}
+
+std::string readFile(const eckit::PathName& path) {
+    std::ifstream in(path.localPath(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const eckit::PathName& path, const std::string& content) {
+    std::ofstream out(path.localPath(), std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Indexes load the same with and without a snapshot") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    {
+        fdb5::FDB fdb(config);
+        for (size_t flush = 0; flush < 3; ++flush) {
+            archiveFlush(fdb, "flush " + std::to_string(flush));
+            archiveFlush(fdb, "other " + std::to_string(flush), 2, "5");
+        }
+    }
+    const eckit::PathName db = databasePath(root);
+
+    const std::string first = loadIndexes(db, config);
+    EXPECT_EQUAL(count(first), size_t(6));
+
+    // Loaded from the snapshot saved by the first load, if any
+    EXPECT_EQUAL(loadIndexes(db, config), first);
+    EXPECT_EQUAL(replayToc(db, config), first);
+
+    EXPECT_EQUAL(retrieve(config).at("0"), "flush 2");
+}
+
+CASE("A snapshot is brought up to date with the indexes appended since") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    const eckit::PathName db = databasePath(root);
+
+    fdb5::FDB fdb(config);
+    archiveFlush(fdb, "flush 0");
+    EXPECT_EQUAL(count(loadIndexes(db, config)), size_t(1));
+
+    archiveFlush(fdb, "flush 1", 5);
+    archiveFlush(fdb, "other", 2, "5");
+
+    const std::string updated = loadIndexes(db, config);
+    EXPECT_EQUAL(count(updated), size_t(3));
+    EXPECT_EQUAL(updated, replayToc(db, config));
+
+    const auto fields = retrieve(config);
+    EXPECT_EQUAL(fields.at("4"), "flush 1");
+    EXPECT_EQUAL(fields.at("5"), "flush 0");
+}
+
+CASE("Cleared indexes are masked, in the snapshot and in the records that follow") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    const eckit::PathName db = databasePath(root);
+
+    fdb5::FDB fdb(config);
+    archiveFlush(fdb, "flush 0");
+    archiveFlush(fdb, "flush 1", 5);
+    EXPECT_EQUAL(count(loadIndexes(db, config)), size_t(2));
+
+    SECTION("One index") {
+        {
+            fdb5::TocHandler handler(db, config);
+            const std::vector<fdb5::Index> indexes = handler.loadIndexes();
+            handler.writeClearRecord(indexes.front());  // the most recent
+        }
+
+        const std::string cleared = loadIndexes(db, config);
+        EXPECT_EQUAL(count(cleared), size_t(1));
+        EXPECT_EQUAL(cleared, replayToc(db, config));
+        EXPECT_EQUAL(retrieve(config).at("4"), "flush 0");
+    }
+
+    SECTION("All the indexes") {
+        fdb5::TocHandler(db, config).writeClearAllRecord();
+        EXPECT_EQUAL(count(loadIndexes(db, config)), size_t(0));
+
+        archiveFlush(fdb, "flush 2", 3);
+
+        const std::string cleared = loadIndexes(db, config);
+        EXPECT_EQUAL(count(cleared), size_t(1));
+        EXPECT_EQUAL(cleared, replayToc(db, config));
+
+        const auto fields = retrieve(config);
+        EXPECT_EQUAL(fields.size(), size_t(3));
+        EXPECT_EQUAL(fields.at("2"), "flush 2");
+    }
+}
+
+CASE("Indexes of sub-TOCs load with the sub-TOC they are in") {
+
+    TestRoot root;
+    eckit::LocalConfiguration userConfig;
+    userConfig.set("useSubToc", true);
+    const fdb5::Config config(root.config(), userConfig);
+    const eckit::PathName db = databasePath(root);
+
+    {
+        fdb5::FDB fdb(config);
+        archiveFlush(fdb, "writer 0, flush 0");
+        EXPECT_EQUAL(count(loadIndexes(db, config)), size_t(1 + 1));  // and the sub-TOC
+
+        // Appended to the sub-TOC already in the snapshot
+        archiveFlush(fdb, "writer 0, flush 1", 5);
+        const std::string appended = loadIndexes(db, config);
+        EXPECT_EQUAL(count(appended), size_t(2 + 1));  // and the sub-TOC
+        EXPECT_NOT_EQUAL(appended.find(" sub-TOC "), std::string::npos);
+        EXPECT_EQUAL(appended, replayToc(db, config));
+    }
+
+    // Closing the writer, and another writer with a sub-TOC of its own
+    EXPECT_EQUAL(loadIndexes(db, config), replayToc(db, config));
+    {
+        fdb5::FDB fdb(config);
+        archiveFlush(fdb, "writer 1", 2);
+        EXPECT_EQUAL(loadIndexes(db, config), replayToc(db, config));
+    }
+    EXPECT_EQUAL(loadIndexes(db, config), replayToc(db, config));
+
+    const auto fields = retrieve(config);
+    EXPECT_EQUAL(fields.at("1"), "writer 1");
+    EXPECT_EQUAL(fields.at("2"), "writer 0, flush 1");
+    EXPECT_EQUAL(fields.at("9"), "writer 0, flush 0");
+}
+
+CASE("The indexes of an overlaid database load with their remapping key") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    const fdb5::Key otherDbKey{{"a", "1"}, {"b", "3"}};
+    const eckit::PathName db = databasePath(root);
+
+    {
+        fdb5::FDB fdb(config);
+        archive(fdb, fieldKey("0"), "this database");
+        for (size_t i = 0; i < 3; ++i) {
+            fdb5::Key key = fieldKey(std::to_string(i), "1", "5");
+            key.set("b", "3");
+            archive(fdb, key, "other database");
+        }
+        fdb.flush();
+    }
+    const std::string before = loadIndexes(db, config);
+    EXPECT_EQUAL(count(before), size_t(1));
+
+    auto mount = [&](bool unmount) {
+        auto source = fdb5::CatalogueReaderFactory::instance().build(otherDbKey, config);
+        auto target = fdb5::CatalogueWriterFactory::instance().build(dbKey(), config);
+        target->overlayDB(*source, {"b"}, unmount);
+    };
+
+    mount(false);
+
+    const std::string mounted = loadIndexes(db, config);
+    EXPECT_EQUAL(count(mounted), size_t(1 + 1 + 1));  // and the sub-TOC
+    EXPECT_EQUAL(mounted, replayToc(db, config));
+
+    std::ostringstream remapKey;
+    remapKey << " sub-TOC " << fdb5::Key{{"b", "2"}};
+    EXPECT_NOT_EQUAL(mounted.find(remapKey.str()), std::string::npos);
+
+    const auto fields = retrieve(config, "5");
+    EXPECT_EQUAL(fields.size(), size_t(3));
+    EXPECT_EQUAL(fields.at("2"), "other database");
+
+    // Unmounting finds the sub-TOC in the indexes loaded, and masks it
+    mount(true);
+    EXPECT_EQUAL(loadIndexes(db, config), before);
+    EXPECT_EQUAL(replayToc(db, config), before);
+    EXPECT(retrieve(config, "5").empty());
+}
+
+CASE("A snapshot of another state of the TOC is not used") {
+
+    if (!snapshots()) {
+        return;
+    }
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    const eckit::PathName db = databasePath(root);
+
+    fdb5::FDB fdb(config);
+    archiveFlush(fdb, "flush 0");
+    const std::string one = loadIndexes(db, config);
+    const std::string oneToc = readFile(db / "toc");
+
+    archiveFlush(fdb, "flush 1");
+    const std::string two = loadIndexes(db, config);
+    EXPECT_EQUAL(count(two), size_t(2));
+
+    SECTION("A snapshot of this state is used") {
+        tamperSnapshot(db, config, [](fdb5::TocSnapshot&) {});
+        EXPECT_EQUAL(count(loadIndexes(db, config)), size_t(1));
+        EXPECT_EQUAL(replayToc(db, config), two);
+    }
+
+    SECTION("Another TOC file") {
+        const eckit::PathName copy = db / "copy";
+        writeFile(copy, readFile(db / "toc"));
+        eckit::PathName::rename(copy, db / "toc");
+
+        const struct stat st = tocStat(db);
+        tamperSnapshot(db, config, [&](fdb5::TocSnapshot& snapshot) { snapshot.tocMTime_ = st.st_mtime; });
+        EXPECT_EQUAL(loadIndexes(db, config), two);
+    }
+
+    SECTION("A truncated TOC") {
+        writeFile(db / "toc", oneToc);
+        EXPECT_EQUAL(loadIndexes(db, config), one);
+    }
+
+    SECTION("A TOC of the same size, modified") {
+        const struct stat st = tocStat(db);
+        tamperSnapshot(db, config, [&](fdb5::TocSnapshot& snapshot) { snapshot.tocMTime_ = st.st_mtime - 1; });
+        EXPECT_EQUAL(loadIndexes(db, config), two);
+    }
+
+    SECTION("A corrupt snapshot") {
+        writeFile(snapshotPath(db, config), "not a snapshot");
+        EXPECT(!fdb5::TocSnapshot::load(snapshotPath(db, config)));
+        EXPECT_EQUAL(loadIndexes(db, config), two);
+    }
+}
+
+CASE("Wiping a database removes its snapshot") {
+
+    TestRoot root;
+    const fdb5::Config config = root.config();
+    const eckit::PathName db = databasePath(root);
+
+    {
+        fdb5::FDB fdb(config);
+        archiveFlush(fdb, "flush 0");
+    }
+    loadIndexes(db, config);
+
+    fdb5::FDB fdb(config);
+    fdb5::FDBToolRequest request{dbKey().request("retrieve"), false, std::vector<std::string>{"a", "b"}};
+
+    const eckit::URI snapshot("file", snapshotPath(db, config).path());
+    size_t unknown = 0;
+    bool wiped = false;
+    auto it = fdb.wipe(request, true);
+    fdb5::WipeElement elem;
+    while (it.next(elem)) {
+        if (elem.type() == fdb5::WipeElementType::UNKNOWN) {
+            unknown += elem.uris().size();
+        }
+        if (elem.type() == fdb5::WipeElementType::CATALOGUE) {
+            wiped = wiped || elem.uris().count(snapshot) > 0;
+        }
+    }
+
+    EXPECT_EQUAL(unknown, size_t(0));
+    EXPECT_EQUAL(wiped, snapshots());
+    EXPECT(!db.exists());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,158 @@
+/*
+ * (C) Copyright 2026- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "fdb5/database/Catalogue.h"
+#include "fdb5/database/Field.h"
+#include "fdb5/database/Index.h"
+#include "fdb5/remote/server/CatalogueHandler.h"
+#include "fdb5/toc/TocFieldLocation.h"
+
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/testing/Test.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "test_common.h"
+
+using namespace eckit::testing;
+using fdb5::remote::ArchiveBlob;
+using fdb5::remote::CatalogueHandler;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// An entry sent by a RemoteCatalogue, for a field of the data file of the database
+struct Entry {
+    std::string c;
+    std::string e;
+    size_t offset;
+    size_t length;
+};
+
+/// Entries of three indexes, interleaved, of which some archive a key of their index again
+std::vector<Entry> interleaved() {
+    std::vector<Entry> entries;
+    size_t offset = 0;
+    for (size_t i = 0; i < 30; ++i) {
+        const size_t length = 1 + (i * 7) % 13;
+        entries.push_back(Entry{std::to_string(3 + 2 * (i % 3)), std::to_string((i / 3) % 7), offset, length});
+        offset += length;
+    }
+    return entries;
+}
+
+/// The Blob frame of an entry, as a RemoteCatalogue sends it
+eckit::Buffer encode(const TestRoot& root, const Entry& entry) {
+    const fdb5::TocFieldLocation location(root.root() / "fields.data", entry.offset, entry.length, fdb5::Key());
+
+    eckit::Buffer buffer(4096);
+    eckit::MemoryStream s(buffer);
+    s << indexKey(entry.c);
+    s << datumKey(entry.e);
+    s << location;
+
+    eckit::Buffer out(s.position());
+    out.copy(buffer.data(), s.position());
+    return out;
+}
+
+void writeData(const TestRoot& root) {
+    std::ofstream out((root.root() / "fields.data").localPath(), std::ios::binary);
+    for (size_t i = 0; i < 4096; ++i) {
+        out.put(static_cast<char>(i % 251));
+    }
+}
+
+/// What each index of the database holds, in the order of the indexes
+std::vector<std::string> contents(const TestRoot& root, const std::vector<Entry>& entries) {
+
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), root.config());
+    EXPECT(reader->open());
+
+    std::vector<std::string> out;
+    for (const auto& index : reader->indexes()) {
+        std::string described = index.key().valuesToString() + ":";
+        EXPECT(reader->selectIndex(index.key()));
+        for (const auto& entry : entries) {
+            if (entry.c != index.key().get("c")) {
+                continue;
+            }
+            fdb5::Field field;
+            EXPECT(reader->retrieve(datumKey(entry.e), field));
+            described += " " + entry.e + "@" + std::to_string(field.location().offset()) + "+" +
+                         std::to_string(field.location().length()) + "=" + readAll(field.dataHandle());
+        }
+        out.push_back(described);
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Batched entries of interleaved indexes are archived as they are one at a time") {
+
+    const std::vector<Entry> entries = interleaved();
+
+    TestRoot unbatched;
+    writeData(unbatched);
+    {
+        auto catalogue = fdb5::CatalogueWriterFactory::instance().build(dbKey(), unbatched.config());
+        for (const auto& entry : entries) {
+            const eckit::Buffer blob = encode(unbatched, entry);
+            CatalogueHandler::archiveEntry(*catalogue, blob.data(), blob.size());
+        }
+        catalogue->flush(entries.size());
+    }
+
+    TestRoot batched;
+    writeData(batched);
+    {
+        std::vector<eckit::Buffer> blobs;
+        for (const auto& entry : entries) {
+            blobs.push_back(encode(batched, entry));
+        }
+
+        // In two batches, the second of which starts with an index of the first
+        std::vector<ArchiveBlob> first;
+        std::vector<ArchiveBlob> second;
+        for (size_t i = 0; i < blobs.size(); ++i) {
+            (i < 13 ? first : second).push_back(ArchiveBlob{uint32_t(i), blobs[i].data(), blobs[i].size()});
+        }
+
+        auto catalogue = fdb5::CatalogueWriterFactory::instance().build(dbKey(), batched.config());
+        CatalogueHandler::archiveEntries(*catalogue, first);
+        CatalogueHandler::archiveEntries(*catalogue, second);
+        catalogue->flush(entries.size());
+    }
+
+    const std::vector<std::string> expected = contents(unbatched, entries);
+    EXPECT_EQUAL(expected.size(), size_t(3));
+    EXPECT(contents(batched, entries) == expected);
+
+    // A key archived again is found at its last location
+    auto reader = fdb5::CatalogueReaderFactory::instance().build(dbKey(), batched.config());
+    EXPECT(reader->open());
+    EXPECT(reader->selectIndex(indexKey("3")));
+    fdb5::Field field;
+    EXPECT(reader->retrieve(datumKey("0"), field));
+    EXPECT_EQUAL(size_t(field.location().offset()), entries[21].offset);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,229 @@
+/*
+ * (C) Copyright 2026- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "fdb5/remote/Connection.h"
+#include "fdb5/remote/Messages.h"
+
+#include "eckit/io/Buffer.h"
+#include "eckit/log/Log.h"
+#include "eckit/net/TCPClient.h"
+#include "eckit/net/TCPServer.h"
+#include "eckit/net/TCPSocket.h"
+#include "eckit/testing/Test.h"
+#include "eckit/utils/Compressor.h"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace eckit::testing;
+using fdb5::remote::Connection;
+using fdb5::remote::Message;
+using fdb5::remote::MessageHeader;
+using fdb5::remote::TCPException;
+
+namespace fdb5::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// One end of a connection, over a single socket
+class TestConnection : public Connection {
+public:
+
+    explicit TestConnection(eckit::net::TCPSocket& socket) : socket_(socket) { single_ = true; }
+
+    using Connection::useCompression;
+
+private:
+
+    const eckit::net::TCPSocket& controlSocket() const override { return socket_; }
+    const eckit::net::TCPSocket& dataSocket() const override { return socket_; }
+
+    eckit::net::TCPSocket& socket_;
+};
+
+/// The two ends of a connection, over a loopback socket
+class ConnectionPair {
+public:
+
+    ConnectionPair() {
+        eckit::net::TCPSocket& connected = client_.connect("localhost", server_.localPort());
+        eckit::net::TCPSocket& accepted = server_.accept();
+        sender_ = std::make_unique<TestConnection>(connected);
+        receiver_ = std::make_unique<TestConnection>(accepted);
+    }
+
+    TestConnection& sender() { return *sender_; }
+    TestConnection& receiver() { return *receiver_; }
+
+    /// Sends the payloads from one end, and returns the frame as read at the other
+    std::string transfer(Message msg, const std::vector<std::string>& payloads, MessageHeader& hdr) {
+        Connection::PayloadList list;
+        for (const auto& payload : payloads) {
+            list.emplace_back(payload.size(), payload.data());
+        }
+        // n.b. written from another thread, so that frames larger than the socket buffers do not block
+        auto written = std::async(std::launch::async, [&] { sender_->write(msg, false, 1, 2, list); });
+        eckit::Buffer payload = receiver_->readData(hdr);
+        written.get();
+        return std::string(static_cast<const char*>(payload.data()), hdr.payloadSize);
+    }
+
+private:
+
+    eckit::net::EphemeralTCPServer server_;
+    eckit::net::TCPClient client_;
+
+    std::unique_ptr<TestConnection> sender_;
+    std::unique_ptr<TestConnection> receiver_;
+};
+
+/// A compressor of this build of eckit that makes repetitive data smaller, if any
+std::string compressor() {
+    for (const std::string name : {"lz4", "snappy", "bzip2", "aec"}) {
+        if (eckit::CompressorFactory::instance().has(name)) {
+            return name;
+        }
+    }
+    return "";
+}
+
+std::string repetitive(size_t size) {
+    std::string out;
+    while (out.size() < size) {
+        out += "the same bytes, over and over. ";
+    }
+    out.resize(size);
+    return out;
+}
+
+std::string noise(size_t size) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::string out(size, '\0');
+    for (auto& c : out) {
+        c = static_cast<char>(dist(gen));
+    }
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Blob and MultiBlob frames round-trip through the agreed compressor") {
+
+    const std::string name = compressor();
+    if (name.empty()) {
+        eckit::Log::info() << "No compressor available, skipping" << std::endl;
+        return;
+    }
+
+    ConnectionPair pair;
+    pair.sender().useCompression(name);
+    pair.receiver().useCompression(name);
+
+    SECTION("Blob") {
+        const std::string data = repetitive(64 * 1024);
+
+        MessageHeader hdr;
+        EXPECT(pair.transfer(Message::Blob, {data}, hdr) == data);
+        EXPECT(hdr.message == Message::Blob);
+        EXPECT_EQUAL(hdr.clientID(), 1);
+        EXPECT_EQUAL(hdr.requestID, 2);
+        EXPECT_EQUAL(hdr.payloadSize, data.size());
+
+        EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 1);
+        EXPECT_EQUAL(pair.receiver().compressionReceived().frames.load(), 1);
+        EXPECT_EQUAL(pair.sender().compressionSent().rawBytes.load(), data.size());
+        EXPECT(pair.sender().compressionSent().wireBytes.load() < data.size());
+        EXPECT_EQUAL(pair.receiver().compressionReceived().wireBytes.load(),
+                     pair.sender().compressionSent().wireBytes.load());
+    }
+
+    SECTION("MultiBlob") {
+        const std::vector<std::string> parts{repetitive(3000), repetitive(5000), repetitive(7000)};
+
+        MessageHeader hdr;
+        EXPECT(pair.transfer(Message::MultiBlob, parts, hdr) == parts[0] + parts[1] + parts[2]);
+        EXPECT(hdr.message == Message::MultiBlob);
+        EXPECT_EQUAL(hdr.payloadSize, 15000);
+
+        EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 1);
+        EXPECT_EQUAL(pair.receiver().compressionReceived().frames.load(), 1);
+    }
+}
+
+CASE("Small, incompressible and other frames are sent raw") {
+
+    const std::string name = compressor();
+    if (name.empty()) {
+        eckit::Log::info() << "No compressor available, skipping" << std::endl;
+        return;
+    }
+
+    ConnectionPair pair;
+    pair.sender().useCompression(name);
+    pair.receiver().useCompression(name);
+
+    MessageHeader hdr;
+
+    SECTION("Under 1 KiB") {
+        const std::string data = repetitive(1023);
+        EXPECT(pair.transfer(Message::Blob, {data}, hdr) == data);
+        EXPECT(hdr.message == Message::Blob);
+        EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 0);
+        EXPECT_EQUAL(pair.sender().compressionSent().skipped.load(), 0);
+        EXPECT_EQUAL(pair.receiver().compressionReceived().frames.load(), 0);
+    }
+
+    SECTION("Incompressible") {
+        const std::string data = noise(64 * 1024);
+        EXPECT(pair.transfer(Message::Blob, {data}, hdr) == data);
+        EXPECT(hdr.message == Message::Blob);
+        EXPECT_EQUAL(hdr.payloadSize, data.size());
+        EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 0);
+        EXPECT_EQUAL(pair.sender().compressionSent().skipped.load(), 1);
+        EXPECT_EQUAL(pair.receiver().compressionReceived().frames.load(), 0);
+    }
+
+    SECTION("Not a data frame") {
+        const std::string data = repetitive(64 * 1024);
+        EXPECT(pair.transfer(Message::Error, {data}, hdr) == data);
+        EXPECT(hdr.message == Message::Error);
+        EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 0);
+        EXPECT_EQUAL(pair.sender().compressionSent().skipped.load(), 0);
+    }
+}
+
+CASE("A compressed frame is refused if no compression was agreed") {
+
+    const std::string name = compressor();
+    if (name.empty()) {
+        eckit::Log::info() << "No compressor available, skipping" << std::endl;
+        return;
+    }
+
+    ConnectionPair pair;
+    pair.sender().useCompression(name);
+
+    MessageHeader hdr;
+    EXPECT_THROWS_AS(pair.transfer(Message::Blob, {repetitive(64 * 1024)}, hdr), TCPException);
+    EXPECT_EQUAL(pair.sender().compressionSent().frames.load(), 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -12,18 +12,25 @@
 #include "fdb5/api/helpers/FDBToolRequest.h"
 #include "fdb5/api/helpers/ListElement.h"
 #include "fdb5/api/helpers/WipeIterator.h"
+#include "fdb5/remote/Messages.h"
+#include "fdb5/remote/client/Client.h"
+#include "fdb5/remote/client/ClientConnection.h"
 
 #include "metkit/mars/MarsRequest.h"
 
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/config/Resource.h"
 #include "eckit/filesystem/PathName.h"
 #include "eckit/filesystem/URI.h"
 #include "eckit/io/Buffer.h"
 #include "eckit/io/DataHandle.h"
 #include "eckit/io/FileHandle.h"
 #include "eckit/log/Log.h"
+#include "eckit/net/Endpoint.h"
 #include "eckit/testing/Test.h"
 #include "eckit/types/Date.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <exception>
@@ -33,6 +40,7 @@
 #include <set>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 using namespace eckit::testing;
@@ -135,6 +143,19 @@ metkit::mars::MarsRequest make_request(const std::vector<Key>& keys) {
     return req;
 }
 
+std::string read_all(eckit::DataHandle* handle) {
+    std::unique_ptr<eckit::DataHandle> dh(handle);
+    std::string out;
+    eckit::Buffer buffer(65536);
+    dh->openForRead();
+    eckit::AutoClose closer(*dh);
+    long len = 0;
+    while ((len = dh->read(buffer, buffer.size())) > 0) {
+        out.append(static_cast<const char*>(buffer.data()), len);
+    }
+    return out;
+}
+
 // Note: The catalogue server is configured to use subtocs. This means there will be cleared indexes and subtocs.
 // This means we also must be sure to disconnect between calls inorder to see the consolidated .index file.
 
@@ -546,6 +567,232 @@ CASE("Remote protocol: concurrent blocking control RPCs are not serialised") {
     }
 }
 
+// Reads are sent to the store server without waiting for each to be acknowledged, and the server serves them
+// concurrently, so they may complete in any order. Each field must still be delivered as the data of its own request,
+// in the order requested, also when several clients share the connection.
+CASE("Remote protocol: pipelined reads return each field in the order requested") {
+
+    std::vector<Key> keys;
+    std::string expected;
+    {
+        FDB fdb{};  // Expects the config to be set in the environment
+        Key k = keycommon();
+        for (const std::string date : {"20000101", "20000102"}) {
+            k.set("date", date);
+            for (const std::string type : {"fc", "pf"}) {
+                k.set("type", type);
+                for (const std::string step : {"1", "2", "3", "4", "5", "6", "7", "8"}) {
+                    k.set("step", step);
+
+                    // Fields of very different sizes, so that the server takes longer over some of the reads
+                    const size_t n = keys.size();
+                    std::string data = date + "/" + type + "/" + step + ":";
+                    data.append((n % 3 == 0) ? (1 << 20) + n : 100 + 37 * n, static_cast<char>('a' + n % 26));
+
+                    fdb.archive(k, data.data(), data.size());
+                    keys.push_back(k);
+                    expected += data;
+                }
+            }
+        }
+        fdb.flush();
+    }
+    EXPECT_EQUAL(keys.size(), 32);
+    std::this_thread::sleep_for(std::chrono::seconds(2));  // Ensure server has flushed consolidated indexes.
+
+    const auto retrieve = [&keys]() {
+        return read_all(FDB{}.retrieve(make_request(keys)));
+    };
+
+    eckit::Log::info() << "[CLIENT]" << "Retrieving all fields." << std::endl;
+    EXPECT(retrieve() == expected);
+
+    eckit::Log::info() << "[CLIENT]" << "Retrieving all fields from several threads." << std::endl;
+    {
+        const size_t nthreads = 4;
+
+        // Note: all assertions run on the main thread after join()
+        std::vector<int> results(nthreads, -1);
+        std::vector<std::thread> threads;
+        threads.reserve(nthreads);
+
+        for (size_t t = 0; t < nthreads; ++t) {
+            threads.emplace_back([t, &retrieve, &expected, &results]() {
+                try {
+                    int result = 0;
+                    for (size_t i = 0; i < 3 && result == 0; ++i) {
+                        if (retrieve() != expected) {
+                            eckit::Log::error() << "[CLIENT][thread " << t << "] retrieved data does not match"
+                                                << std::endl;
+                            result = 1;
+                        }
+                    }
+                    results[t] = result;
+                }
+                catch (const std::exception& e) {
+                    eckit::Log::error() << "[CLIENT][thread " << t << "] " << e.what() << std::endl;
+                    results[t] = 1;
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (auto result : results) {
+            EXPECT_EQUAL(result, 0);
+        }
+    }
+
+    // Clean up the data archived by this test so the FDB is left in a clean state.
+    eckit::Log::info() << "[CLIENT]" << "Wiping pipelined-read test data. --doit" << std::endl;
+    auto wipeit = FDB{}.wipe(FDBToolRequest::requestsFromString("class=od")[0], true);
+    WipeElement wipe_elem;
+    while (wipeit.next(wipe_elem)) {
+        eckit::Log::info() << "[CLIENT]" << wipe_elem;
+    }
+}
+
+// Small archived fields are batched into MultiBlob frames, if the store server allows it, and larger ones are sent as
+// plain Blobs. Either way, each field must be stored in its own place, and be read back as it was archived.
+CASE("Remote protocol: batched archives store each field in its own place") {
+
+    // Archived without waiting, so that many of them are queued together, and one larger than FDB_ARCHIVE_BATCH_SIZE
+    const size_t nsmall = 200;
+    const size_t large = (1 << 20) + 12345;
+
+    std::map<std::string, std::string> data;
+    std::vector<Key> keys;
+    {
+        FDB fdb{};  // Expects the config to be set in the environment
+        Key k = keycommon();
+        k.set("date", "20000101");
+        k.set("type", "fc");
+        for (size_t n = 0; n <= nsmall; ++n) {
+            const std::string step = std::to_string(n + 1);
+            k.set("step", step);
+
+            std::string field = "step " + step + ":";
+            field.append(n == nsmall / 2 ? large : 10 + n, static_cast<char>('a' + n % 26));
+
+            fdb.archive(k, field.data(), field.size());
+            keys.push_back(k);
+            data[step] = field;
+        }
+        fdb.flush();
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(2));  // Ensure server has flushed consolidated indexes.
+
+    eckit::Log::info() << "[CLIENT]" << "Listing the archived fields." << std::endl;
+    {
+        std::set<std::string> steps;
+        std::set<std::pair<std::string, long long>> locations;
+        auto it = FDB{}.list(FDBToolRequest{make_request(keys)}, true);
+        ListElement elem;
+        while (it.next(elem)) {
+            const std::string step = elem.combinedKey().get("step");
+            steps.insert(step);
+            locations.emplace(elem.location().uri().path().asString(), elem.location().offset());
+            EXPECT_EQUAL(size_t(elem.location().length()), data.at(step).size());
+        }
+        EXPECT_EQUAL(steps.size(), data.size());
+        EXPECT_EQUAL(locations.size(), data.size());
+    }
+
+    eckit::Log::info() << "[CLIENT]" << "Retrieving each archived field." << std::endl;
+    for (const auto& k : keys) {
+        EXPECT(read_all(FDB{}.retrieve(make_request({k}))) == data.at(k.get("step")));
+    }
+
+    // Clean up the data archived by this test so the FDB is left in a clean state.
+    eckit::Log::info() << "[CLIENT]" << "Wiping batched-archive test data. --doit" << std::endl;
+    auto wipeit = FDB{}.wipe(FDBToolRequest::requestsFromString("class=od")[0], true);
+    WipeElement wipe_elem;
+    while (wipeit.next(wipe_elem)) {
+        eckit::Log::info() << "[CLIENT]" << wipe_elem;
+    }
+}
+
+/// A client that does nothing but hold the connection the router hands out to it
+class PooledClient : public remote::Client {
+public:
+
+    PooledClient(const eckit::Configuration& config, const eckit::net::Endpoint& endpoint) :
+        Client(config, endpoint, endpoint.hostname() + ":" + std::to_string(endpoint.port())), config_(config) {}
+
+    ~PooledClient() override { deregister(); }
+
+    const std::shared_ptr<remote::ClientConnection>& connection() const { return connection_; }
+
+    const eckit::Configuration& clientConfig() const override { return config_; }
+
+    bool handle(remote::Message /*message*/, uint32_t /*requestID*/) override { return false; }
+    bool handle(remote::Message /*message*/, uint32_t /*requestID*/, eckit::Buffer&& /*payload*/) override {
+        return false;
+    }
+
+private:
+
+    eckit::LocalConfiguration config_;
+};
+
+// The router keeps up to FDB_REMOTE_CONNECTIONS_PER_ENDPOINT connections to each endpoint (by default 1, in which case
+// all the clients share one connection, as they did before connections were pooled)
+CASE("Remote protocol: clients are spread over a pool of connections per endpoint") {
+
+    const size_t poolSize = std::max<size_t>(
+        1, eckit::Resource<size_t>("fdbRemoteConnectionsPerEndpoint;$FDB_REMOTE_CONNECTIONS_PER_ENDPOINT", 1));
+    eckit::Log::info() << "[CLIENT]" << "Pool of " << poolSize << " connections." << std::endl;
+
+    const eckit::LocalConfiguration config;
+    const eckit::net::Endpoint endpoint{"localhost", 10000};
+
+    // Until the pool is full, each client opens a connection of its own
+    std::vector<std::unique_ptr<PooledClient>> clients;
+    std::set<remote::ClientConnection*> pool;
+    for (size_t i = 0; i < poolSize; ++i) {
+        clients.push_back(std::make_unique<PooledClient>(config, endpoint));
+        pool.insert(clients.back()->connection().get());
+        EXPECT(clients.back()->connection()->valid());
+    }
+    EXPECT_EQUAL(pool.size(), poolSize);
+
+    // Then each client uses the connection of the pool with the fewest clients
+    for (size_t i = 0; i < 2 * poolSize; ++i) {
+        clients.push_back(std::make_unique<PooledClient>(config, endpoint));
+        EXPECT(pool.find(clients.back()->connection().get()) != pool.end());
+    }
+    for (const auto* conn : pool) {
+        EXPECT_EQUAL(conn->numClients(), 3);
+    }
+
+    // A connection is torn down with its last client, and leaves the pool. Its place is taken by a new connection.
+    const std::shared_ptr<remote::ClientConnection> released = clients.front()->connection();
+    clients.erase(std::remove_if(clients.begin(), clients.end(),
+                                 [&released](const auto& client) { return client->connection() == released; }),
+                  clients.end());
+    EXPECT_EQUAL(clients.size(), 2 * poolSize);
+    EXPECT_EQUAL(released->numClients(), 0);
+
+    auto replacement = std::make_unique<PooledClient>(config, endpoint);
+    EXPECT(replacement->connection() != released);
+    EXPECT(pool.find(replacement->connection().get()) == pool.end());
+    EXPECT(replacement->connection()->valid());
+    EXPECT_EQUAL(replacement->connection()->numClients(), 1);
+
+    // Once all the clients are gone, so is the pool
+    const std::shared_ptr<remote::ClientConnection> last = replacement->connection();
+    clients.clear();
+    replacement.reset();
+    EXPECT_EQUAL(last->numClients(), 0);
+
+    PooledClient client(config, endpoint);
+    EXPECT(client.connection() != last);
+    EXPECT(client.connection() != released);
+    EXPECT_EQUAL(client.connection()->numClients(), 1);
+}
+
 }  // namespace fdb5::test
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+/*
+ * (C) Copyright 2026- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "fdb5/remote/RemoteConfiguration.h"
+
+#include "eckit/config/LocalConfiguration.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/serialisation/MemoryStream.h"
+#include "eckit/testing/Test.h"
+#include "eckit/value/Value.h"
+
+#include <string>
+#include <vector>
+
+using namespace eckit::testing;
+using fdb5::remote::RemoteConfiguration;
+
+namespace fdb5::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+RemoteConfiguration configured(bool pipelinedReads) {
+    eckit::LocalConfiguration config;
+    config.set("pipelinedReads", pipelinedReads);
+    return RemoteConfiguration{config};
+}
+
+/// The configuration as the peer receives it
+RemoteConfiguration sent(const RemoteConfiguration& conf) {
+    eckit::Buffer buffer(4096);
+    eckit::MemoryStream out(buffer);
+    out << conf;
+
+    eckit::MemoryStream in(buffer.data(), out.position());
+    return RemoteConfiguration{in};
+}
+
+/// The configuration sent by a peer that predates the negotiated capabilities
+RemoteConfiguration sentByOlderPeer() {
+    eckit::Value val = eckit::Value::makeOrderedMap();
+    val["RemoteFieldLocation"] = eckit::toValue(std::vector<int>{1});
+    val["NumberOfConnections"] = eckit::toValue(std::vector<int>{1, 2});
+
+    eckit::Buffer buffer(4096);
+    eckit::MemoryStream out(buffer);
+    out << val;
+
+    eckit::MemoryStream in(buffer.data(), out.position());
+    return RemoteConfiguration{in};
+}
+
+/// The capabilities the client takes from the server's reply to its startup message
+eckit::LocalConfiguration reply(const RemoteConfiguration& agreed) {
+    eckit::Buffer buffer(4096);
+    eckit::MemoryStream out(buffer);
+    out << agreed;
+
+    eckit::MemoryStream in(buffer.data(), out.position());
+    return eckit::LocalConfiguration{in};
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Reads are pipelined by default") {
+
+    RemoteConfiguration client = configured(true);
+    RemoteConfiguration server = sent(RemoteConfiguration{eckit::LocalConfiguration{}});
+    EXPECT(client.pipelinedReads());
+    EXPECT(server.pipelinedReads());
+
+    const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+    EXPECT(agreed.pipelinedReads());
+
+    const eckit::LocalConfiguration functionality = reply(agreed);
+    EXPECT(functionality.has("PipelinedReads"));
+    EXPECT(functionality.getBool("PipelinedReads"));
+}
+
+CASE("Reads are pipelined only if both peers allow it") {
+
+    for (bool clientAllows : {true, false}) {
+        for (bool serverAllows : {true, false}) {
+            RemoteConfiguration client = sent(configured(clientAllows));
+            RemoteConfiguration server = configured(serverAllows);
+            EXPECT_EQUAL(client.pipelinedReads(), clientAllows);
+
+            const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+            EXPECT_EQUAL(agreed.pipelinedReads(), clientAllows && serverAllows);
+            EXPECT_EQUAL(reply(agreed).getBool("PipelinedReads"), clientAllows && serverAllows);
+        }
+    }
+}
+
+CASE("Reads are not pipelined with a peer that does not have the capability") {
+
+    SECTION("Older client") {
+        RemoteConfiguration client = sentByOlderPeer();
+        RemoteConfiguration server = configured(true);
+        EXPECT(!client.pipelinedReads());
+
+        const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+        EXPECT(!agreed.pipelinedReads());
+        EXPECT(!reply(agreed).getBool("PipelinedReads"));
+    }
+
+    SECTION("Older server") {
+        // An older server replies with the intersection of the capabilities it knows of, without PipelinedReads
+        eckit::Value val = eckit::Value::makeOrderedMap();
+        val["RemoteFieldLocation"] = eckit::toValue(std::vector<int>{1});
+        val["NumberOfConnections"] = eckit::toValue(std::vector<int>{2});
+
+        eckit::Buffer buffer(4096);
+        eckit::MemoryStream out(buffer);
+        out << val;
+
+        eckit::MemoryStream in(buffer.data(), out.position());
+        const eckit::LocalConfiguration functionality{in};
+
+        // As the client decides in ClientConnection::verifyServerStartupResponse
+        const bool pipelinedReads = functionality.has("PipelinedReads") && functionality.getBool("PipelinedReads");
+        EXPECT(!pipelinedReads);
+    }
+}
+
+/// The configuration of a client that asks for its data frames to be compressed with @p compressor
+RemoteConfiguration compressing(const std::string& compressor) {
+    RemoteConfiguration conf{eckit::LocalConfiguration{}};
+    conf.compression(compressor);
+    return sent(conf);
+}
+
+CASE("The compressor asked for by the client is used if the server allows it and has it") {
+
+    SECTION("Agreed") {
+        RemoteConfiguration client = compressing("none");
+        RemoteConfiguration server{eckit::LocalConfiguration{}};
+        EXPECT_EQUAL(client.compression(), "none");
+
+        const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+        EXPECT_EQUAL(agreed.compression(), "none");
+        EXPECT_EQUAL(reply(agreed).getString("Compression"), "none");
+    }
+
+    SECTION("Not asked for") {
+        RemoteConfiguration client = sent(RemoteConfiguration{eckit::LocalConfiguration{}});
+        RemoteConfiguration server{eckit::LocalConfiguration{}};
+
+        const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+        EXPECT(agreed.compression().empty());
+        EXPECT(!reply(agreed).has("Compression"));
+    }
+
+    SECTION("Not allowed by the server") {
+        eckit::LocalConfiguration config;
+        config.set("compression", false);
+
+        RemoteConfiguration client = compressing("none");
+        RemoteConfiguration server{config};
+
+        const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+        EXPECT(agreed.compression().empty());
+        EXPECT(!reply(agreed).has("Compression"));
+    }
+
+    SECTION("Not known to the server") {
+        RemoteConfiguration client = compressing("no-such-compressor");
+        RemoteConfiguration server{eckit::LocalConfiguration{}};
+
+        const RemoteConfiguration agreed = RemoteConfiguration::common(client, server);
+        EXPECT(agreed.compression().empty());
+        EXPECT(!reply(agreed).has("Compression"));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
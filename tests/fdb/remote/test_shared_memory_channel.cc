@@ -0,0 +1,194 @@
+/*
+ * (C) Copyright 2026- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "fdb5/remote/SharedMemoryChannel.h"
+
+#include "eckit/log/Log.h"
+#include "eckit/testing/Test.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eckit::testing;
+using fdb5::remote::SharedMemoryChannel;
+
+namespace fdb5::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::vector<unsigned char> pattern(size_t n) {
+    std::vector<unsigned char> v(n);
+    uint32_t x = 12345;
+    for (auto& c : v) {
+        x = x * 1103515245 + 12345;
+        c = static_cast<unsigned char>(x >> 16);
+    }
+    return v;
+}
+
+CASE("Data crosses the rings in both directions, in order") {
+
+    auto client = SharedMemoryChannel::create(4096);
+    if (!client) {
+        eckit::Log::info() << "Shared memory is not available, skipping" << std::endl;
+        return;
+    }
+
+    auto server = SharedMemoryChannel::open(client->name());
+    EXPECT(server);
+    client->unlink();
+
+    // Much more than the ring, in chunks that do not divide it
+    const auto sent = pattern(1000003);
+
+    std::thread writer([&] {
+        size_t pos = 0;
+        size_t chunk = 1;
+        while (pos < sent.size()) {
+            size_t n = std::min(chunk, sent.size() - pos);
+            EXPECT(client->write(sent.data() + pos, n));
+            pos += n;
+            chunk = (chunk * 7) % 10007 + 1;
+        }
+    });
+
+    std::vector<unsigned char> received(sent.size());
+    size_t pos = 0;
+    size_t chunk = 3;
+    while (pos < received.size()) {
+        size_t n = std::min(chunk, received.size() - pos);
+        EXPECT(server->read(received.data() + pos, n));
+        pos += n;
+        chunk = (chunk * 5) % 5003 + 1;
+    }
+    writer.join();
+
+    EXPECT(received == sent);
+
+    // And back
+    const char reply[] = "reply";
+    char buffer[sizeof(reply)];
+    EXPECT(server->write(reply, sizeof(reply)));
+    EXPECT(client->read(buffer, sizeof(buffer)));
+    EXPECT(std::equal(reply, reply + sizeof(reply), buffer));
+}
+
+CASE("Closing lets the peer read what was written first") {
+
+    auto client = SharedMemoryChannel::create(4096);
+    if (!client) {
+        return;
+    }
+    auto server = SharedMemoryChannel::open(client->name());
+    EXPECT(server);
+
+    uint64_t value = 42;
+    EXPECT(client->write(&value, sizeof(value)));
+    client->close();
+
+    uint64_t read = 0;
+    EXPECT(server->read(&read, sizeof(read)));
+    EXPECT_EQUAL(read, value);
+    EXPECT(!server->read(&read, sizeof(read)));
+    EXPECT(!client->write(&value, sizeof(value)));
+}
+
+CASE("A waiting reader notices that the peer is gone") {
+
+    auto client = SharedMemoryChannel::create(4096);
+    if (!client) {
+        return;
+    }
+    auto server = SharedMemoryChannel::open(client->name());
+    EXPECT(server);
+
+    int fds[2];
+    EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    server->watch(fds[0]);
+
+    std::thread peer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        ::close(fds[1]);
+    });
+
+    char c;
+    EXPECT(!server->read(&c, 1));
+    peer.join();
+    ::close(fds[0]);
+}
+
+CASE("Counters the peer left out of range break the channel instead of being followed") {
+
+    auto client = SharedMemoryChannel::create(4096);
+    if (!client) {
+        return;
+    }
+    auto server = SharedMemoryChannel::open(client->name());
+    EXPECT(server);
+
+    // A third mapping, standing for a misbehaving peer. The counters of the ring to the server are at the start of
+    // the segment, after the magic and the ring size, each on its own cache line: head, then tail.
+    int fd = ::shm_open(client->name().c_str(), O_RDWR, 0);
+    EXPECT(fd >= 0);
+    void* address = ::mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    EXPECT(address != MAP_FAILED);
+    client->unlink();
+    auto* head = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(address) + 64);
+    auto* tail = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(address) + 128);
+
+    const char data[] = "data";
+    EXPECT(client->write(data, sizeof(data)));
+    EXPECT_EQUAL(head->load(), sizeof(data));
+
+    // More data read than written
+    tail->store(1000);
+    EXPECT(!client->write(data, sizeof(data)));
+    EXPECT(client->broken());
+
+    // More data than the ring holds. n.b. checked before the channel is seen closed.
+    head->store(100 * 4096);
+    char buffer[sizeof(data)];
+    EXPECT(!server->read(buffer, sizeof(buffer)));
+    EXPECT(server->broken());
+
+    ::munmap(address, 4096);
+}
+
+CASE("A segment cannot be opened once its name is removed") {
+
+    auto client = SharedMemoryChannel::create(4096);
+    if (!client) {
+        return;
+    }
+    std::string name = client->name();
+    client->unlink();
+    EXPECT(!SharedMemoryChannel::open(name));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,201 @@
+/*
+ * (C) Copyright 2026- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include "fdb5/config/Config.h"
+#include "fdb5/remote/FdbServer.h"
+#include "fdb5/remote/server/WorkScheduler.h"
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/testing/Test.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace eckit::testing;
+using fdb5::remote::FdbServerBase;
+using fdb5::remote::WorkScheduler;
+
+namespace fdb5::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Without slots, work is never held back") {
+
+    WorkScheduler scheduler(0);
+    WorkScheduler::Flow flow(1.0);
+
+    auto a = scheduler.acquire(flow, 100);
+    auto b = scheduler.acquire(flow, 100);
+    auto c = scheduler.acquire(flow, 100);
+}
+
+CASE("No more work runs at once than there are slots") {
+
+    WorkScheduler scheduler(2);
+
+    std::atomic<int> running{0};
+    std::atomic<int> highest{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] {
+            WorkScheduler::Flow flow(1.0);
+            for (int j = 0; j < 20; ++j) {
+                auto slot = scheduler.acquire(flow, 1000);
+                int n = ++running;
+                int h = highest.load();
+                while (n > h && !highest.compare_exchange_weak(h, n)) {}
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                --running;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT(highest.load() <= 2);
+    EXPECT(highest.load() >= 1);
+}
+
+CASE("A light flow does not wait behind the backlog of a heavy one") {
+
+    WorkScheduler scheduler(1);
+    WorkScheduler::Flow heavy(1.0);
+    WorkScheduler::Flow light(4.0);
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+
+    auto run = [&](WorkScheduler::Flow& flow, const std::string& name) {
+        auto slot = scheduler.acquire(flow, 1000);
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(name);
+    };
+
+    std::vector<std::thread> threads;
+    {
+        WorkScheduler::Flow other(1.0);
+        auto held = scheduler.acquire(other, 1);
+
+        // Queue up the heavy work first
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back(run, std::ref(heavy), "heavy");
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        threads.emplace_back(run, std::ref(light), "light");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQUAL(order.size(), 5);
+    EXPECT_EQUAL(order.front(), "light");
+}
+
+// n.b. this test runs with FDB_SERVER_WORKERS=2
+
+/// A client of the server, with the archive flow of its connection, as ServerConnection has it
+struct Client {
+    WorkScheduler::Flow archives{1.0};
+};
+
+CASE("The connections of the server share its slots") {
+
+    WorkScheduler& scheduler = WorkScheduler::instance();
+    EXPECT_EQUAL(scheduler.slots(), 2);
+
+    Client first;
+    Client second;
+
+    std::atomic<int> running{0};
+    std::atomic<int> highest{0};
+
+    std::mutex mutex;
+    std::vector<const Client*> order;
+
+    // Each connection archives from several threads, as its archive queue is drained
+    auto archive = [&](Client& client) {
+        for (int j = 0; j < 30; ++j) {
+            auto slot = scheduler.acquire(client.archives, 1000);
+            int n = ++running;
+            int h = highest.load();
+            while (n > h && !highest.compare_exchange_weak(h, n)) {}
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                order.push_back(&client);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            --running;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    {
+        // Hold back the work until both clients are waiting
+        WorkScheduler::Flow other(1.0);
+        auto held1 = scheduler.acquire(other, 1);
+        auto held2 = scheduler.acquire(other, 1);
+        for (int i = 0; i < 3; ++i) {
+            threads.emplace_back(archive, std::ref(first));
+            threads.emplace_back(archive, std::ref(second));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // The slots cap the work of both connections together
+    EXPECT(highest.load() <= 2);
+    EXPECT_EQUAL(order.size(), 180);
+
+    // Neither connection gets ahead of the other while both are waiting
+
+    std::map<const Client*, int> granted;
+    for (const Client* client : order) {
+        ++granted[client];
+        if (granted[&first] == 90 || granted[&second] == 90) {
+            break;
+        }
+        EXPECT(std::abs(granted[&first] - granted[&second]) <= 6);
+    }
+}
+
+CASE("A server with slots serves its connections in threads") {
+
+    fdb5::Config config;
+    EXPECT(FdbServerBase::threaded(config));
+
+    config.set("serverThreaded", true);
+    EXPECT(FdbServerBase::threaded(config));
+
+    config.set("serverThreaded", false);
+    EXPECT_THROWS_AS(FdbServerBase::threaded(config), eckit::UserError);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb5::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
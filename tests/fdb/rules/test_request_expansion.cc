@@ -0,0 +1,142 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <ostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/testing/Test.h"
+
+#include "metkit/mars/MarsRequest.h"
+
+#include "fdb5/database/Key.h"
+#include "fdb5/database/ReadVisitor.h"
+#include "fdb5/rules/Schema.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Selects every database and index, and records the datum keys, without a catalogue to restrict the values
+class RecordingVisitor : public fdb5::ReadVisitor {
+public:
+
+    explicit RecordingVisitor(const fdb5::Schema& schema) : schema_(schema) {}
+
+    bool selectDatabase(const fdb5::Key& /* dbKey */, const fdb5::Key& /* fullKey */) override { return true; }
+    bool selectIndex(const fdb5::Key& /* idxKey */) override { return true; }
+    bool selectDatum(const fdb5::Key& datumKey, const fdb5::Key& /* fullKey */) override {
+        keys_.push_back(datumKey);
+        return true;
+    }
+
+    void deselectDatabase() override {}
+
+    const fdb5::Schema& databaseSchema() const override { return schema_; }
+
+    const std::vector<fdb5::Key>& keys() const { return keys_; }
+
+private:
+
+    void print(std::ostream& out) const override { out << "RecordingVisitor[]"; }
+
+    const fdb5::Schema& schema_;
+    std::vector<fdb5::Key> keys_;
+};
+
+const std::string rules =
+    "step: Step;\n"
+    "[ class, expver, stream [ type, levtype [ step, levelist?, param ]]]\n";
+
+metkit::mars::MarsRequest baseRequest() {
+    metkit::mars::MarsRequest request("retrieve");
+    request.values("class", {"od"});
+    request.values("expver", {"0001"});
+    request.values("stream", {"oper"});
+    request.values("type", {"fc"});
+    request.values("levtype", {"pl"});
+    return request;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Values that are the same once canonical give a key once, in the order of the request") {
+
+    std::istringstream in(rules);
+    fdb5::Schema schema(in);
+
+    auto request = baseRequest();
+    request.values("step", {"6", "06", "12", "6"});
+    request.values("levelist", {"500"});
+    request.values("param", {"t", "T", "u"});
+
+    RecordingVisitor visitor(schema);
+    schema.expand(request, visitor);
+
+    const std::vector<fdb5::Key> expected{
+        fdb5::Key{{"step", "6"}, {"levelist", "500"}, {"param", "t"}},
+        fdb5::Key{{"step", "6"}, {"levelist", "500"}, {"param", "u"}},
+        fdb5::Key{{"step", "12"}, {"levelist", "500"}, {"param", "t"}},
+        fdb5::Key{{"step", "12"}, {"levelist", "500"}, {"param", "u"}},
+    };
+
+    EXPECT_EQUAL(visitor.keys().size(), expected.size());
+    for (size_t i = 0; i < expected.size() && i < visitor.keys().size(); ++i) {
+        EXPECT_EQUAL(visitor.keys()[i], expected[i]);
+    }
+}
+
+CASE("Every combination of a large request is visited once") {
+
+    std::istringstream in(rules);
+    fdb5::Schema schema(in);
+
+    std::vector<std::string> steps;
+    std::vector<std::string> levels;
+    std::vector<std::string> params;
+    for (size_t i = 0; i < 50; ++i) {
+        steps.push_back(std::to_string(i * 6));
+    }
+    for (size_t i = 0; i < 137; ++i) {
+        levels.push_back(std::to_string(i + 1));
+    }
+    for (size_t i = 0; i < 20; ++i) {
+        params.push_back(std::to_string(i + 128));
+    }
+
+    auto request = baseRequest();
+    request.values("step", steps);
+    request.values("levelist", levels);
+    request.values("param", params);
+
+    RecordingVisitor visitor(schema);
+    schema.expand(request, visitor);
+
+    EXPECT_EQUAL(visitor.keys().size(), steps.size() * levels.size() * params.size());
+
+    const std::set<fdb5::Key> distinct(visitor.keys().begin(), visitor.keys().end());
+    EXPECT_EQUAL(distinct.size(), visitor.keys().size());
+
+    // The innermost keyword of the rule varies fastest
+    EXPECT_EQUAL(visitor.keys()[0], (fdb5::Key{{"step", "0"}, {"levelist", "1"}, {"param", "128"}}));
+    EXPECT_EQUAL(visitor.keys()[1], (fdb5::Key{{"step", "0"}, {"levelist", "1"}, {"param", "129"}}));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
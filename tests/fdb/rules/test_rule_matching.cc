@@ -0,0 +1,214 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/config/Config.h"
+#include "fdb5/database/Key.h"
+#include "fdb5/rules/Rule.h"
+#include "fdb5/rules/Schema.h"
+#include "fdb5/rules/SchemaParser.h"
+#include "fdb5/types/TypesRegistry.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using Values = std::map<std::string, std::set<std::string>>;
+
+template <typename T>
+std::string describe(const T& rule) {
+    std::ostringstream oss;
+    oss << rule;
+    return oss.str();
+}
+
+/// The database rule that a walk through all the rules finds first, as Schema::matchingRule did
+std::string firstDatabaseRule(const fdb5::RuleList& rules, const fdb5::Key& key) {
+    for (const auto& rule : rules) {
+        if (rule->match(key)) {
+            return describe(*rule);
+        }
+    }
+    return "none";
+}
+
+/// The datum rule that a walk through all the rules finds first
+std::string firstDatumRule(const fdb5::RuleList& rules, const fdb5::Key& dbKey, const fdb5::Key& idxKey) {
+    for (const auto& dbRule : rules) {
+        if (!dbRule->match(dbKey)) {
+            continue;
+        }
+        for (const auto& idxRule : dbRule->rules()) {
+            if (idxRule->match(idxKey)) {
+                return describe(idxRule->rule());
+            }
+        }
+    }
+    return "none";
+}
+
+std::string matchingDatabaseRule(const fdb5::Schema& schema, const fdb5::Key& key) {
+    try {
+        return describe(schema.matchingRule(key));
+    }
+    catch (const eckit::SeriousBug&) {
+        return "none";
+    }
+}
+
+std::string matchingDatumRule(const fdb5::Schema& schema, const fdb5::Key& dbKey, const fdb5::Key& idxKey) {
+    try {
+        return describe(schema.matchingRule(dbKey, idxKey));
+    }
+    catch (const eckit::SeriousBug&) {
+        return "none";
+    }
+}
+
+/// The values that the rules list for each keyword
+void collect(const fdb5::Rule& rule, Values& values) {
+    for (const auto& [keyword, listed] : rule.constraints()) {
+        values[keyword].insert(listed.begin(), listed.end());
+    }
+}
+
+template <typename C>
+const std::string& pick(std::mt19937& random, const C& values) {
+    return *std::next(values.begin(), random() % values.size());
+}
+
+/// Keys made of values listed in the schema, values that it does not list, and missing keywords, so that every
+/// branch of the decision trees is taken. Most keys start from the values that some rule lists, and so match it, or
+/// one of the rules before it.
+std::vector<fdb5::Key> randomKeys(const fdb5::RuleList& rules, const Values& values, size_t count) {
+
+    std::mt19937 random(42);
+    std::vector<fdb5::Key> keys;
+
+    for (size_t i = 0; i < count; ++i) {
+
+        std::map<std::string, std::string> fields;
+        for (const auto& [keyword, listed] : values) {
+            const auto choice = random() % (listed.size() + 2);
+            if (choice < listed.size()) {
+                fields[keyword] = pick(random, listed);
+            }
+            else if (choice == listed.size()) {
+                fields[keyword] = "unlisted";
+            }
+        }
+
+        if (random() % 4 != 0) {
+            const auto& dbRule = *rules[random() % rules.size()];
+            Values rule = dbRule.constraints();
+            if (!dbRule.rules().empty()) {
+                collect(*dbRule.rules()[random() % dbRule.rules().size()], rule);
+            }
+            for (const auto& [keyword, listed] : rule) {
+                if (!listed.empty() && random() % 10 != 0) {
+                    fields[keyword] = pick(random, listed);
+                }
+            }
+        }
+
+        fdb5::Key key;
+        for (const auto& [keyword, value] : fields) {
+            key.push(keyword, value);
+        }
+        keys.push_back(key);
+    }
+
+    return keys;
+}
+
+void checkAgainstWalk(const fdb5::Schema& schema, const fdb5::RuleList& reference, size_t count) {
+
+    Values values;
+    for (const auto& dbRule : reference) {
+        collect(*dbRule, values);
+        for (const auto& idxRule : dbRule->rules()) {
+            collect(*idxRule, values);
+        }
+    }
+
+    size_t matched = 0;
+    for (const auto& key : randomKeys(reference, values, count)) {
+        const auto expected = firstDatabaseRule(reference, key);
+        EXPECT_EQUAL(matchingDatabaseRule(schema, key), expected);
+        EXPECT_EQUAL(matchingDatumRule(schema, key, key), firstDatumRule(reference, key, key));
+        if (expected != "none") {
+            ++matched;
+        }
+    }
+
+    eckit::Log::info() << matched << " of " << count << " keys match a database rule" << std::endl;
+    EXPECT(matched > 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Rules restricting, excluding or ignoring keywords are picked as by a walk through the schema") {
+
+    const std::string rules =
+        "[ class=od, stream=oper/dcda [ type=fc [ param ]] [ type [ step, param ]]]\n"
+        "[ class=od/rd, stream=!oper/dcda, expver=0001 [ type=an/fc, levtype? [ param ]] [ type [ param ]]]\n"
+        "[ class, stream=enfo [ type=pf, number [ param ]] [ type [ param ]]]\n"
+        "[ class=rd, expver [ type=cf/pf, type=pf [ param ]] [ type=cf [ param ]]]\n"
+        "[ class=ea, stream, date-0 [ type [ param ]]]\n"
+        "[ class [ type [ param ]]]\n";
+
+    std::istringstream in(rules);
+    fdb5::Schema schema(in);
+
+    std::istringstream ref(rules);
+    fdb5::RuleList reference;
+    fdb5::TypesRegistry registry;
+    fdb5::SchemaParser(ref).parse(reference, registry);
+
+    checkAgainstWalk(schema, reference, 20000);
+}
+
+CASE("Rules of the test schema are picked as by a walk through the schema") {
+
+    fdb5::Config config;
+    const fdb5::Schema& schema = config.schema();
+
+    std::ifstream in(schema.path());
+    EXPECT(in.good());
+    fdb5::RuleList reference;
+    fdb5::TypesRegistry registry;
+    fdb5::SchemaParser(in).parse(reference, registry);
+
+    EXPECT(reference.size() > 10);
+
+    checkAgainstWalk(schema, reference, 20000);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,196 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "eckit/log/Log.h"
+#include "eckit/testing/Test.h"
+
+#include "fdb5/config/Config.h"
+#include "fdb5/database/Key.h"
+#include "fdb5/rules/Schema.h"
+#include "fdb5/types/Type.h"
+#include "fdb5/types/TypesRegistry.h"
+
+using namespace eckit::testing;
+
+namespace fdb::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+fdb5::Config config;
+
+const std::vector<std::pair<std::string, std::string>> archiveKey{
+    {"class", "od"},  {"expver", "1"},   {"stream", "oper"}, {"date", "20260101"}, {"time", "1200"}, {"domain", "g"},
+    {"type", "fc"},   {"levtype", "pl"}, {"step", "6"},      {"levelist", "500"},  {"param", "130"},
+};
+
+/// The lookup of a registry before it was made lock-free, which took a mutex and searched the ordered cache of the
+/// registry on every call
+class BaselineLookup {
+public:
+
+    explicit BaselineLookup(const fdb5::TypesRegistry& registry) : registry_(registry) {}
+
+    const fdb5::Type& lookupType(const std::string& keyword) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto iter = cache_.find(keyword); iter != cache_.end()) {
+            return *iter->second;
+        }
+        const fdb5::Type& type = registry_.lookupType(keyword);
+        cache_.emplace(keyword, &type);
+        return type;
+    }
+
+private:
+
+    const fdb5::TypesRegistry& registry_;
+    mutable std::mutex mutex_;
+    mutable std::map<std::string, const fdb5::Type*> cache_;
+};
+
+/// Runs @p work on @p threads threads, and returns the wall time in seconds
+template <typename F>
+double timeThreads(size_t threads, F work) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < threads; ++i) {
+        pool.emplace_back(work);
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+CASE("Lookups return the same type, and fall back to the parent registry") {
+
+    fdb5::TypesRegistry parent;
+    parent.addType("step", "Step");
+
+    fdb5::TypesRegistry child;
+    child.addType("time", "Time");
+    child.updateParent(parent);
+
+    const fdb5::Type& step = child.lookupType("step");
+    EXPECT(&step == &parent.lookupType("step"));
+    EXPECT(&step == &child.lookupType("step"));
+    EXPECT_EQUAL(step.toKey("00"), "0");
+
+    EXPECT(&child.lookupType("time") == &child.lookupType("time"));
+    EXPECT_EQUAL(child.lookupType("time").toKey("123"), "0123");
+
+    // Keywords unknown to all the registries have the default type
+    const fdb5::Type& unknown = child.lookupType("unknown");
+    EXPECT(&unknown == &child.lookupType("unknown"));
+    EXPECT_EQUAL(unknown.toKey("abc"), "abc");
+}
+
+CASE("Concurrent lookups agree") {
+
+    fdb5::TypesRegistry parent;
+    parent.addType("step", "Step");
+    fdb5::TypesRegistry registry;
+    registry.addType("time", "Time");
+    registry.updateParent(parent);
+
+    // More keywords than the lock-free table holds
+    std::vector<std::vector<const fdb5::Type*>> seen(8);
+    std::vector<std::thread> threads;
+    for (auto& types : seen) {
+        threads.emplace_back([&registry, &types] {
+            for (int i = 0; i < 2000; ++i) {
+                types.push_back(&registry.lookupType("keyword" + std::to_string(i % 200)));
+                types.push_back(&registry.lookupType(i % 2 ? "step" : "time"));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (const auto& types : seen) {
+        for (size_t i = 0; i < types.size(); ++i) {
+            EXPECT(types[i] == seen[0][i]);
+        }
+    }
+    EXPECT(&registry.lookupType("step") == &parent.lookupType("step"));
+    EXPECT(&registry.lookupType("keyword199") == seen[0][2 * 199]);
+}
+
+CASE("Adding a type replaces the types looked up so far") {
+
+    fdb5::TypesRegistry parent;
+    fdb5::TypesRegistry registry;
+    registry.updateParent(parent);
+
+    EXPECT_EQUAL(registry.lookupType("time").toKey("123"), "123");
+    registry.addType("time", "Time");
+    EXPECT_EQUAL(registry.lookupType("time").toKey("123"), "0123");
+}
+
+CASE("Microbenchmark: archive-side key canonicalisation") {
+
+    const fdb5::TypesRegistry& registry = config.schema().registry();
+
+    const size_t iterations = 20000;
+
+    for (size_t threads : {1, 16}) {
+
+        BaselineLookup baseline(registry);
+        double locked = timeThreads(threads, [&] {
+            for (size_t i = 0; i < iterations; ++i) {
+                for (const auto& [keyword, value] : archiveKey) {
+                    baseline.lookupType(keyword);
+                }
+            }
+        });
+
+        double lookups = timeThreads(threads, [&] {
+            for (size_t i = 0; i < iterations; ++i) {
+                for (const auto& [keyword, value] : archiveKey) {
+                    registry.lookupType(keyword);
+                }
+            }
+        });
+
+        std::atomic<size_t> canonicalised{0};
+        double canonical = timeThreads(threads, [&] {
+            for (size_t i = 0; i < iterations; ++i) {
+                fdb5::TypedKey key(registry);
+                for (const auto& [keyword, value] : archiveKey) {
+                    key.push(keyword, value);
+                }
+                if (key.canonical().size() == archiveKey.size()) {
+                    canonicalised++;
+                }
+            }
+        });
+        EXPECT_EQUAL(canonicalised.load(), threads * iterations);
+
+        eckit::Log::info() << threads << " threads x " << iterations << " keys: lookups as before " << locked
+                           << "s, lock-free " << lookups << "s; canonicalisation " << canonical << "s" << std::endl;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace fdb::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
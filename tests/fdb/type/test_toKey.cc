@@ -9,7 +9,9 @@
  */
 
 #include <cstdlib>
+#include <functional>
 #include <sstream>
+#include <string>
 
 #include "eckit/testing/Test.h"
 
@@ -248,6 +250,50 @@ CASE("Levelist") {
     EXPECT(key.matchValues("levelist", values));
 }
 
+CASE("Binary fingerprint") {
+
+    fdb5::Key key;
+    key.push("step", "12");
+    key.push("levelist", "");
+    key.push("param", "129.128");
+
+    std::string fingerprint;
+    key.valuesToFingerprint(fingerprint);
+    EXPECT(fingerprint.size() == 1 + 3 + 1 + 8);
+    EXPECT_EQUAL(fingerprint.find('\0'), std::string::npos);
+
+    eckit::StringList values;
+    EXPECT(fdb5::Key::fingerprintToValues(fingerprint, values));
+    EXPECT(values.size() == 3);
+    EXPECT_EQUAL(values[0], "12");
+    EXPECT_EQUAL(values[1], "");
+    EXPECT_EQUAL(values[2], "129.128");
+
+    // a buffer reused for keys no longer than the first is not reallocated
+    fdb5::Key shorter;
+    shorter.push("step", "6");
+    shorter.push("levelist", "1");
+    shorter.push("param", "130.128");
+    const char* data = fingerprint.data();
+    shorter.valuesToFingerprint(fingerprint);
+    EXPECT(fingerprint.data() == data);
+    EXPECT(fingerprint.size() == 1 + 2 + 2 + 8);
+
+    // colon-separated fingerprints are not mistaken for binary ones
+    values.clear();
+    EXPECT(!fdb5::Key::fingerprintToValues(key.valuesToString(), values));
+    EXPECT(!fdb5::Key::fingerprintToValues("", values));
+    EXPECT(values.empty());
+
+    // the hash does not depend on the insertion order
+    fdb5::Key other;
+    other.push("param", "129.128");
+    other.push("step", "12");
+    other.push("levelist", "");
+    EXPECT(key == other);
+    EXPECT_EQUAL(std::hash<fdb5::Key>()(key), std::hash<fdb5::Key>()(other));
+}
+
 CASE("Expver, Time & ClimateDaily - string ctor - expansion") {
 
     fdb5::Key key;
@@ -61,3 +61,36 @@ def test_retrieve_context_manager(read_only_fdb_setup):
     with fdb.retrieve(selection) as data_handle:
         assert data_handle
         assert data_handle.read(4) == b"GRIB"
+
+
+def test_retrieve_into(read_only_fdb_setup):
+    fdb = FDB(read_only_fdb_setup)
+
+    selection = {
+        "type": "an",
+        "class": "ea",
+        "domain": "g",
+        "expver": "0001",
+        "stream": "oper",
+        "date": "20200101",
+        "levtype": "sfc",
+        "step": "0",
+        "param": ["167", "165", "166"],
+        "time": "1800",
+    }
+
+    with fdb.retrieve(selection) as data_handle:
+        expected = data_handle.read()
+
+    fields = fdb.retrieve_into(selection)
+    assert len(fields) == 3
+    assert all(field[:4] == b"GRIB" for field in fields)
+    assert b"".join(fields) == expected
+
+    buffers = [bytearray(len(field)) for field in fields]
+    lengths = fdb.retrieve_into(selection, buffers)
+    assert lengths == [len(field) for field in fields]
+    assert b"".join(buffers) == expected
+
+    with pytest.raises(ValueError):
+        fdb.retrieve_into(selection, buffers[:2])